@@ -3,9 +3,13 @@
 #include <QStringList>
 #include <csignal>
 
+#include "Daemon.hpp"
+#include "DaemonClient.hpp"
 #include "Launcher.hpp"
+#include "ParallelLauncher.hpp"
 #include "InitDialog.hpp"
 #include "MainGui.hpp"
+#include "Common.hpp"
 
 namespace QtAda {
 int guiInitializer(int argc, char *argv[])
@@ -46,6 +50,31 @@ int cliInitializer(int argc, char *argv[])
         return *argsErrors;
     }
 
+    switch (options.daemonCommand) {
+    case DaemonCommand::Start: {
+        QCoreApplication app(argc, argv);
+        Daemon daemon;
+        if (!daemon.start()) {
+            printQtAdaErrorMessage(DaemonClient::isDaemonRunning()
+                                       ? QStringLiteral("QtAda daemon is already running.")
+                                       : QStringLiteral("Failed to start QtAda daemon."));
+            return 1;
+        }
+        QObject::connect(&daemon, &Daemon::daemonFinished, &app, &QCoreApplication::quit);
+        return app.exec();
+    }
+    case DaemonCommand::Stop: {
+        QCoreApplication app(argc, argv);
+        if (!DaemonClient::isDaemonRunning() || !DaemonClient::stopDaemon()) {
+            printQtAdaErrorMessage(QStringLiteral("QtAda daemon is not running."));
+            return 1;
+        }
+        return 0;
+    }
+    default:
+        break;
+    }
+
     switch (options.type) {
     case LaunchType::Record: {
         QApplication app(argc, argv);
@@ -59,6 +88,27 @@ int cliInitializer(int argc, char *argv[])
     }
     case LaunchType::Run: {
         QCoreApplication app(argc, argv);
+        if (DaemonClient::canRunInDaemon(options) && DaemonClient::isDaemonRunning()) {
+            DaemonClient client(options);
+            QObject::connect(&client, &DaemonClient::jobFinished, &app,
+                             &QCoreApplication::quit);
+            if (client.submit()) {
+                auto exec = app.exec();
+                return exec == 0 ? client.exitCode() : exec;
+            }
+            printQtAdaWarningMessage(
+                QStringLiteral("Failed to connect to QtAda daemon, running locally."));
+        }
+        if (options.jobs > 1) {
+            ParallelLauncher launcher(options);
+            QObject::connect(&launcher, &ParallelLauncher::launcherFinished, &app,
+                             &QCoreApplication::quit);
+            if (!launcher.launch()) {
+                return launcher.exitCode();
+            }
+            auto exec = app.exec();
+            return exec == 0 ? launcher.exitCode() : exec;
+        }
         Launcher launcher(options);
         QObject::connect(&launcher, &Launcher::launcherFinished, &app, &QCoreApplication::quit);
         if (!launcher.launch()) {
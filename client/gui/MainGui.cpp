@@ -1523,7 +1523,8 @@ void MainGui::startupScriptWriterLauncher(bool isUpdateMode) noexcept
     assert(!scriptPath.isEmpty());
     prepareLogTextEditsForRecording(appPath, scriptPath, true);
 
-    launcher_ = new Launcher(getUserOptionsForRecord(appPath, scriptPath, isUpdateMode), true);
+    launcher_ = new Launcher(getUserOptionsForRecord(appPath, scriptPath, isUpdateMode),
+                             LauncherMode::Gui);
     connect(launcher_, &Launcher::launcherErrMessage, this, &MainGui::writeQtAdaErrMessage);
     connect(launcher_, &Launcher::launcherOutMessage, this, &MainGui::writeQtAdaOutMessage);
     connect(launcher_, &Launcher::stdMessage, this, &MainGui::writeAppOutMessage);
@@ -1645,7 +1646,7 @@ void MainGui::startupScriptRunnerLauncher(const QStringList &scripts) noexcept
     const auto appPath = project_->value(paths::PROJECT_APP_PATH, "").toString();
     assert(!appPath.isEmpty());
 
-    launcher_ = new Launcher(getUserOptionsForRun(appPath, scripts), true);
+    launcher_ = new Launcher(getUserOptionsForRun(appPath, scripts), LauncherMode::Gui);
     connect(launcher_, &Launcher::launcherErrMessage, this, &MainGui::writeQtAdaErrMessage);
     connect(launcher_, &Launcher::launcherOutMessage, this, &MainGui::writeQtAdaOutMessage);
     connect(launcher_, &Launcher::scriptRunError, this, &MainGui::writeQtAdaErrMessage);
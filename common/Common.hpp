@@ -12,6 +12,10 @@ inline void setMsgHighlight(bool isHighlight) noexcept
 }
 
 static constexpr int DEFAULT_WAITING_TIMER_VALUE = 60;
+static constexpr int HEARTBEAT_INTERVAL_MSEC = 500;
+// Число пропущенных подряд сигналов из GUI-потока, после которого приложение считается
+// зависшим (0 - проверка отключена)
+static constexpr int DEFAULT_MISSED_HEARTBEATS_LIMIT = 0;
 static constexpr int DEFAULT_INDENT_WIDTH = 4;
 static constexpr int MINIMUM_CYCLE_COUNT = 3;
 static constexpr int MINIMUM_RETRIEVAL_ATTEMPTS = 1;
@@ -22,10 +26,21 @@ static constexpr int MINIMUM_VERIFY_ATTEMPTS = 1;
 static constexpr int DEFAULT_VERIFY_ATTEMPTS = 5;
 static constexpr int MINIMUM_VERIFY_INTERVAL = 10;
 static constexpr int DEFAULT_VERIFY_INTERVAL = 100;
+static constexpr int MINIMUM_EVENT_SETTLE_TIME = 0;
+static constexpr int DEFAULT_EVENT_SETTLE_TIME = 0;
 
 static constexpr char ENV_UNSET_PRELOAD[] = "QTADA_NEED_TO_UNSET_PRELOAD";
 static constexpr char ENV_LAUNCH_TYPE[] = "QTADA_LAUNCH_TYPE";
 static constexpr char ENV_LAUNCH_SETTINGS[] = "QTADA_LAUNCH_SETTINGS";
+static constexpr char ENV_REMOTE_OBJECT_URL[] = "QTADA_REMOTE_OBJECT_URL";
+
+// Тип сообщения в пакете, который зонд передает лаунчеру (InprocessController::sendMessageBatch)
+enum class InprocessMessageType {
+    ScriptRunError = 0,
+    ScriptRunWarning = 1,
+    ScriptRunLog = 2,
+    NewScriptLine = 3,
+};
 
 static constexpr char RESET_COLOR[] = "\033[0m";
 static constexpr char QTADA_ERR_COLOR[] = "\033[37;41m";
@@ -55,8 +70,17 @@ Options:
  -h, --help                                     print program help and exit
  -w, --workspace                                set working directory for executable (default: current path)
  -t, --timeout                                  application launch timeout in seconds (default: %2 seconds)
+ --hang-heartbeats <integer value>              kill the application under test if its GUI thread misses the specified number of
+                                                heartbeats in a row (one every %15 milliseconds) during test script execution,
+                                                0 disables the check (default: %14)
  -s, --show-log                                 show application logs during test script execution
+ -j, --jobs <integer value>                     run test scripts in the specified number of application instances at once (default: 1)
+ --warm-pool <integer value>                    keep the specified number of applications launched in advance, each waiting for its
+                                                test script while the current one runs (default: 0)
  --no-highlight                                 disable highlighting of QtAda messages in the console
+ --daemon                                       start QtAda daemon, which keeps launched applications between runs
+ --daemon-stop                                  stop running QtAda daemon
+ --no-daemon                                    run test scripts locally even if QtAda daemon is running
 
 (Record options):
  --new-script                                   new script will be (over)written to the specified path (default)
@@ -70,6 +94,9 @@ Options:
  --generate-cycles                              enables automatic generation of a `for` loop for repetitive actions (default: disabled)
  --cycle-min-count                              sets the minimum number of repetitive lines to generate `for` loop (minimum: %4)
 
+ --bind-objects <integer value>                 sets the minimum number of uses of an object path to bind the object to a variable
+                                                with `QtAda.find` (default: disabled)
+
  --only-index                                   for actions on model delegates, only its index will be specified (default)
  --only-text                                    for actions on model delegates, only its text (if possible) will be specified
  --text-index                                   for actions on model delegates, its index and text (if possible) will be specified
@@ -79,7 +106,15 @@ Options:
  --retrieval-interval <integer value>           sets the interval (in milliseconds) before next attempt (minimum: %7, default: %8)
  --verify-attempts <integer value>              sets the attempts number to verify the expected value (minimum: %9, default: %10)
  --verify-interval <integer value>              sets the interval (in milliseconds) before next verify attempt (minimum: %11, default: %12)
- --show-elapsed                                 displays elapsed time (in milliseconds) for retrieval and verification (default: disabled)
+ --show-elapsed                                 displays elapsed time (in milliseconds) for retrieval and verification and the object
+                                                registry size after each script (default: disabled)
+ --event-settle-time <integer value>            sets the additional time (in milliseconds) to wait after posted events are delivered (default: %13)
+ --on-demand-paths                              look up objects by path only when the script uses them instead of tracking all objects (default: disabled).
+                                                Only paths starting at the application object, a window or a top-level widget are found
+ --session                                      run all scripts in one application launch, relaunching it only after a crash or
+                                                on `QtAda.requestRelaunch()` (default: disabled)
+ --session-close-windows                        between session scripts, close the windows opened after the first script started
+ --session-reset <script path>                  between session scripts, run the specified script to reset the application state
 )")
                            .arg(appPath)
                            .arg(DEFAULT_WAITING_TIMER_VALUE)
@@ -92,7 +127,10 @@ Options:
                            .arg(MINIMUM_VERIFY_ATTEMPTS)
                            .arg(DEFAULT_VERIFY_ATTEMPTS)
                            .arg(MINIMUM_VERIFY_INTERVAL)
-                           .arg(DEFAULT_VERIFY_INTERVAL);
+                           .arg(DEFAULT_VERIFY_INTERVAL)
+                           .arg(DEFAULT_EVENT_SETTLE_TIME)
+                           .arg(DEFAULT_MISSED_HEARTBEATS_LIMIT)
+                           .arg(HEARTBEAT_INTERVAL_MSEC);
     std::cout << qPrintable(usage) << std::endl << std::flush;
 }
 
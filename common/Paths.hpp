@@ -8,6 +8,8 @@ static constexpr char SCRIPT_COMMAND_PREFIX[] = "QtAda.";
 
 namespace QtAda::paths {
 static const auto QTADA_CONFIG = QStringLiteral("%1/.config/qtada.conf").arg(QDir::homePath());
+static const auto QTADA_ABI_CACHE
+    = QStringLiteral("%1/.cache/qtada/abi-cache.json").arg(QDir::homePath());
 static constexpr char PROJECT_SUFFIX[] = "qtada";
 static constexpr char PROJECT_TMP_SUFFIX[] = "qtada_tmp";
 
@@ -49,4 +51,7 @@ static constexpr char PROJECT_WORKING_DIR[] = "workingDirectory";
 static constexpr char PROJECT_TIMEOUT[] = "timeout";
 
 static constexpr char REMOTE_OBJECT_PATH[] = "local:QTADA_REMOTE_OBJECT";
+// Демон один на пользователя (имя его сокета см. в Daemon.hpp)
+static const auto QTADA_DAEMON_LOCK
+    = QStringLiteral("%1/.cache/qtada/daemon.lock").arg(QDir::homePath());
 } // namespace QtAda::paths
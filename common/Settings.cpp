@@ -125,6 +125,7 @@ const QByteArray RecordSettings::toJson(bool forGui) const noexcept
     obj["textIndexBehavior"] = static_cast<int>(this->textIndexBehavior);
     obj["needToGenerateCycle"] = this->needToGenerateCycle;
     obj["cycleMinimumCount"] = this->cycleMinimumCount;
+    obj["objectBindingMinimumCount"] = this->objectBindingMinimumCount;
     const auto document = QJsonDocument(obj);
     return document.toJson(QJsonDocument::Indented);
 }
@@ -148,6 +149,7 @@ const RecordSettings RecordSettings::fromJson(const QByteArray &data, bool forGu
     settings.textIndexBehavior = static_cast<TextIndexBehavior>(obj["textIndexBehavior"].toInt());
     settings.needToGenerateCycle = obj["needToGenerateCycle"].toBool();
     settings.cycleMinimumCount = obj["cycleMinimumCount"].toInt();
+    settings.objectBindingMinimumCount = obj["objectBindingMinimumCount"].toInt();
     return settings;
 }
 
@@ -156,7 +158,10 @@ std::optional<std::vector<QString>> RunSettings::findErrors() const noexcept
     std::vector<QString> errors;
 
     if (scriptPath.isEmpty()) {
-        errors.push_back(QStringLiteral("Script path is not specified."));
+        // При отложенном запуске скрипт передается позже, и проверяется он уже лаунчером
+        if (!deferredStart) {
+            errors.push_back(QStringLiteral("Script path is not specified."));
+        }
     }
     else {
         QFileInfo script(scriptPath);
@@ -198,6 +203,24 @@ std::optional<std::vector<QString>> RunSettings::findErrors() const noexcept
                                         "than the required minimum of %1.")
                              .arg(MINIMUM_VERIFY_ATTEMPTS));
     }
+    if (eventSettleTime < MINIMUM_EVENT_SETTLE_TIME) {
+        errors.push_back(QStringLiteral("The settle time after events delivery is less than the "
+                                        "required minimum of %1.")
+                             .arg(MINIMUM_EVENT_SETTLE_TIME));
+    }
+    if (!session && (sessionCloseWindows || !sessionResetScript.isEmpty())) {
+        errors.push_back(QStringLiteral("Session reset options are only for the session mode."));
+    }
+    if (session && deferredStart) {
+        errors.push_back(QStringLiteral("The deferred script start is not for the session mode."));
+    }
+    if (!sessionResetScript.isEmpty()) {
+        QFileInfo resetScript(sessionResetScript);
+        if (!resetScript.isFile() || !resetScript.isReadable()) {
+            errors.push_back(QStringLiteral("The session reset script at '%1' cannot be read.")
+                                 .arg(sessionResetScript));
+        }
+    }
     return errors.empty() ? std::nullopt : std::make_optional(errors);
 }
 
@@ -209,11 +232,18 @@ const QByteArray RunSettings::toJson(bool forGui) const noexcept
     }
     else {
         obj["scriptPath"] = this->scriptPath;
+        obj["session"] = this->session;
+        obj["sessionCloseWindows"] = this->sessionCloseWindows;
+        obj["sessionResetScript"] = this->sessionResetScript;
+        obj["sessionLastScript"] = this->sessionLastScript;
+        obj["deferredStart"] = this->deferredStart;
     }
     obj["retrievalAttempts"] = this->retrievalAttempts;
     obj["retrievalInterval"] = this->retrievalInterval;
     obj["verifyAttempts"] = this->verifyAttempts;
     obj["verifyInterval"] = this->verifyInterval;
+    obj["eventSettleTime"] = this->eventSettleTime;
+    obj["pathResolution"] = static_cast<int>(this->pathResolution);
     obj["showElapsed"] = this->showElapsed;
     const auto document = QJsonDocument(obj);
     return document.toJson(QJsonDocument::Indented);
@@ -229,11 +259,24 @@ const RunSettings RunSettings::fromJson(const QByteArray &data, bool forGui) noe
     }
     else {
         settings.scriptPath = obj["scriptPath"].toString();
+        settings.session = obj["session"].toBool();
+        settings.sessionCloseWindows = obj["sessionCloseWindows"].toBool();
+        settings.sessionResetScript = obj["sessionResetScript"].toString();
+        settings.sessionLastScript = obj["sessionLastScript"].toBool();
+        settings.deferredStart = obj["deferredStart"].toBool();
     }
     settings.retrievalAttempts = obj["retrievalAttempts"].toInt();
     settings.retrievalInterval = obj["retrievalInterval"].toInt();
     settings.verifyAttempts = obj["verifyAttempts"].toInt();
     settings.verifyInterval = obj["verifyInterval"].toInt();
+    settings.eventSettleTime = obj["eventSettleTime"].toInt(DEFAULT_EVENT_SETTLE_TIME);
+    // Неизвестное значение (например, из настроек другой версии) заменяется значением
+    // по умолчанию
+    const auto pathResolution = obj["pathResolution"].toInt();
+    if (pathResolution >= static_cast<int>(PathResolution::Registry)
+        && pathResolution <= static_cast<int>(PathResolution::OnDemand)) {
+        settings.pathResolution = static_cast<PathResolution>(pathResolution);
+    }
     settings.showElapsed = obj["showElapsed"].toBool();
     return settings;
 }
@@ -24,6 +24,13 @@ enum class ScriptWriteMode {
     UpdateScript = 1,
 };
 
+enum class PathResolution {
+    // Пути всех объектов приложения отслеживаются с момента их создания
+    Registry = 0,
+    // Объект ищется по пути только в момент обращения к нему из скрипта
+    OnDemand = 1,
+};
+
 struct RecordSettings final {
     QString scriptPath = QString();
 
@@ -40,6 +47,10 @@ struct RecordSettings final {
     bool needToGenerateCycle = false;
     int cycleMinimumCount = MINIMUM_CYCLE_COUNT;
 
+    // Минимальное число использований пути, после которого объект привязывается к переменной
+    // через QtAda.find (0 - не привязывать)
+    int objectBindingMinimumCount = 0;
+
     std::optional<std::vector<QString>> findErrors() const noexcept;
     bool isValid() const noexcept
     {
@@ -58,8 +69,23 @@ struct RunSettings final {
     int retrievalInterval = DEFAULT_RETRIEVAL_INTERVAL;
     int verifyAttempts = DEFAULT_VERIFY_ATTEMPTS;
     int verifyInterval = DEFAULT_VERIFY_INTERVAL;
+    int eventSettleTime = DEFAULT_EVENT_SETTLE_TIME;
+    PathResolution pathResolution = PathResolution::Registry;
     bool showElapsed = false;
 
+    // Скрипты выполняются друг за другом в одном запуске тестируемого приложения
+    bool session = false;
+    // Между скриптами сессии закрываются окна, открытые после начала первого скрипта
+    bool sessionCloseWindows = false;
+    // Скрипт, возвращающий приложение в исходное состояние между скриптами сессии
+    QString sessionResetScript = QString();
+    // Скрипт, с которым запускается приложение, в сессии последний (задается самим лаунчером,
+    // а о следующих скриптах сообщается вместе с ними)
+    bool sessionLastScript = false;
+    // Приложение запускается заранее, а скрипт начинает выполняться только по команде
+    // лаунчера (задается самим лаунчером для приложений из --warm-pool)
+    bool deferredStart = false;
+
     std::optional<std::vector<QString>> findErrors() const noexcept;
     bool isValid() const noexcept
     {
@@ -0,0 +1,236 @@
+#include "GuiCommand.hpp"
+
+#include <QCoreApplication>
+#include <QMutex>
+#include <QThread>
+#include <QPointer>
+#include <QSemaphore>
+#include <QQmlProperty>
+#include <memory>
+
+#include "utils/FilterUtils.hpp"
+#include "utils/Tools.hpp"
+
+namespace QtAda::core {
+bool GuiCommandContext::checkAvailability(const QObject *object, bool shouldBeVisible) noexcept
+{
+    assert(object != nullptr);
+    if (!utils::getFromVariant<bool>(tools::readProperty(object, "enabled"))) {
+        result_.status = GuiCommandResult::Status::Unavailable;
+        result_.message = QStringLiteral("disabled state");
+        return false;
+    }
+    if (shouldBeVisible && !utils::getFromVariant<bool>(tools::readProperty(object, "visible"))) {
+        result_.status = GuiCommandResult::Status::Unavailable;
+        result_.message = QStringLiteral("invisibility");
+        return false;
+    }
+    return true;
+}
+
+void GuiCommandContext::fail(const QString &message) noexcept
+{
+    result_.status = GuiCommandResult::Status::Failed;
+    result_.message = message;
+}
+
+void GuiCommandContext::warn(const QString &message) noexcept
+{
+    result_.warnings.push_back(message);
+}
+
+void GuiCommandContext::invoke(QObject *object, const char *method, QGenericArgument val0,
+                               QGenericArgument val1, QGenericArgument val2) noexcept
+{
+    assert(object != nullptr);
+    bool ok = QMetaObject::invokeMethod(object, method, Qt::DirectConnection, val0, val1, val2);
+    assert(ok == true);
+}
+
+//! TODO: Для QtWidgets используется статический метод QQmlProperty::write, причем
+//! название класса говорит о том, что по идее он предназначен для QML, тем не менее
+//! он прекрасно работает и избавляет от поиска QMetaProperty вручную.
+void GuiCommandContext::writeProperty(QObject *object, const QString &propertyName,
+                                      const QVariant &value) noexcept
+{
+    assert(object != nullptr);
+    QQmlProperty::write(object, propertyName, value);
+}
+
+void GuiCommandContext::postEvents(QObject *receiver, std::vector<QEvent *> events) noexcept
+{
+    assert(receiver != nullptr);
+    for (auto *event : events) {
+        QCoreApplication::postEvent(receiver, event);
+    }
+    result_.eventsPosted = true;
+}
+
+namespace {
+struct PendingCommand final {
+    GuiObjectGetter getObject;
+    GuiCommand command;
+    GuiCommandContext context;
+    // Заполняются в GUI-потоке, а читаются только после завершения команды
+    QPointer<QObject> object;
+    bool objectDestroyed = false;
+
+    QSemaphore finished;
+    // Защищают переход между состояниями "ожидает" -> "выполняется" и "ожидает" -> "отменена"
+    QMutex stateMutex;
+    bool started = false;
+    bool cancelled = false;
+};
+} // namespace
+
+GuiCommandResult executeInGuiThread(GuiObjectGetter getObject, GuiCommand command,
+                                    int timeoutMsec) noexcept
+{
+    assert(getObject != nullptr);
+    assert(command != nullptr);
+    // Из GUI-потока ожидание команды привело бы к взаимной блокировке
+    assert(QThread::currentThread() != QCoreApplication::instance()->thread());
+
+    auto pending = std::make_shared<PendingCommand>();
+    pending->getObject = std::move(getObject);
+    pending->command = std::move(command);
+
+    // В качестве контекста используем qApp, а не сам объект, так как вызов с контекстом
+    // удаленного объекта был бы отброшен, и ожидание длилось бы до таймаута
+    bool ok = QMetaObject::invokeMethod(
+        QCoreApplication::instance(),
+        [pending] {
+            {
+                QMutexLocker locker(&pending->stateMutex);
+                if (pending->cancelled) {
+                    return;
+                }
+                pending->started = true;
+            }
+            auto *object = pending->getObject();
+            if (object == nullptr) {
+                pending->objectDestroyed = true;
+            }
+            else {
+                pending->object = object;
+                pending->command(object, pending->context);
+            }
+            pending->finished.release();
+        },
+        Qt::QueuedConnection);
+    assert(ok == true);
+
+    if (!pending->finished.tryAcquire(1, timeoutMsec)) {
+        GuiCommandResult result;
+        result.status = GuiCommandResult::Status::TimedOut;
+        {
+            QMutexLocker locker(&pending->stateMutex);
+            if (!pending->started) {
+                // GUI-поток занят чем-то другим: команда так и не начала выполняться,
+                // поэтому отменяем ее, чтобы она не выполнилась уже после следующих команд
+                pending->cancelled = true;
+                result.message = QStringLiteral("cancelled");
+                return result;
+            }
+        }
+        // Команда могла завершиться сразу после истечения времени ожидания
+        if (!pending->finished.tryAcquire(1, 0)) {
+            // Команда выполняется (скорее всего во вложенном цикле событий модального
+            // диалога) - дальше ее не ждем, а контекст останется жить вместе с ней
+            result.message = QStringLiteral("still running");
+            return result;
+        }
+    }
+
+    if (pending->objectDestroyed) {
+        GuiCommandResult result;
+        result.status = GuiCommandResult::Status::Unavailable;
+        result.message = QStringLiteral("destruction");
+        return result;
+    }
+    auto result = pending->context.takeResult();
+    result.object = pending->object;
+    return result;
+}
+
+GuiCommandResult executeInGuiThread(GuiCommand command, int timeoutMsec) noexcept
+{
+    return executeInGuiThread([] { return QCoreApplication::instance(); }, std::move(command),
+                              timeoutMsec);
+}
+
+namespace {
+struct PendingSteps final {
+    std::vector<GuiCommandStep> steps;
+
+    QMutex mutex;
+    std::vector<GuiCommandResult> results;
+    // Индекс команды, которая выполняется (или выполнялась последней)
+    int current = -1;
+    bool aborted = false;
+};
+} // namespace
+
+std::vector<GuiCommandResult> executeStepsInGuiThread(const std::vector<GuiCommandStep> &steps,
+                                                      size_t first, int timeoutMsec) noexcept
+{
+    assert(first < steps.size());
+
+    // Команды копируются, так как после таймаута блок может продолжить выполнение
+    auto pending = std::make_shared<PendingSteps>();
+    pending->steps.assign(steps.begin() + first, steps.end());
+
+    const auto blockResult = executeInGuiThread(
+        [pending](QObject *, GuiCommandContext &) {
+            for (int i = 0; i < static_cast<int>(pending->steps.size()); i++) {
+                {
+                    QMutexLocker locker(&pending->mutex);
+                    if (pending->aborted) {
+                        return;
+                    }
+                    pending->current = i;
+                }
+
+                auto &step = pending->steps[i];
+                auto *object = step.getObject();
+                GuiCommandResult result;
+                if (object == nullptr) {
+                    result.status = GuiCommandResult::Status::Unavailable;
+                    result.message = QStringLiteral("destruction");
+                }
+                else {
+                    GuiCommandContext context;
+                    step.command(object, context);
+                    result = context.takeResult();
+                    result.object = object;
+                }
+
+                const auto isLast
+                    = result.status != GuiCommandResult::Status::Done || result.eventsPosted;
+                QMutexLocker locker(&pending->mutex);
+                pending->results.push_back(std::move(result));
+                if (isLast) {
+                    return;
+                }
+            }
+        },
+        timeoutMsec);
+
+    QMutexLocker locker(&pending->mutex);
+    if (blockResult.status == GuiCommandResult::Status::TimedOut) {
+        // Следующие команды блока уже не начнутся, а их выполнением займется вызывающий
+        pending->aborted = true;
+        const auto isRunning = pending->current != -1
+                               && pending->results.size()
+                                      != static_cast<size_t>(pending->current + 1);
+        if (isRunning) {
+            GuiCommandResult result;
+            result.status = GuiCommandResult::Status::TimedOut;
+            result.message = blockResult.message;
+            pending->results.push_back(std::move(result));
+        }
+    }
+    // Результаты копируются под мьютексом: зависшая команда может дописать свой результат
+    return pending->results;
+}
+} // namespace QtAda::core
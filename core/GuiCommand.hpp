@@ -0,0 +1,110 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QEvent>
+#include <QPointer>
+#include <functional>
+#include <vector>
+
+namespace QtAda::core {
+struct GuiCommandResult final {
+    enum class Status {
+        Done,
+        // Объект недоступен (отключен или невидим), команду можно повторить позже
+        Unavailable,
+        Failed,
+        // Команда не завершилась за отведенное время (например, открыла модальный диалог)
+        TimedOut,
+    };
+
+    Status status = Status::Done;
+    // Для Status::Failed - текст ошибки, для Status::Unavailable - причина недоступности,
+    // для Status::TimedOut - что стало с командой (отменена или еще выполняется)
+    QString message;
+    QStringList warnings;
+    // Значение, которое команда возвращает в поток скрипта
+    QVariant value;
+    // Команда отправила события, которые будут обработаны уже после ее завершения
+    bool eventsPosted = false;
+    // Объект, над которым выполнялась команда. QPointer создается в GUI-потоке, а в других
+    // потоках его можно только копировать, чтобы передать в следующую команду
+    QPointer<QObject> object;
+};
+
+/*
+ * Контекст команды, выполняемой в GUI-потоке. Команда не обращается к движку скрипта и
+ * к сигналам ScriptRunner напрямую: ошибки, предупреждения и результат накапливаются
+ * здесь и обрабатываются в потоке скрипта после завершения команды.
+ */
+class GuiCommandContext final {
+public:
+    bool checkAvailability(const QObject *object, bool shouldBeVisible = true) noexcept;
+
+    void fail(const QString &message) noexcept;
+    void warn(const QString &message) noexcept;
+    void setValue(const QVariant &value) noexcept
+    {
+        result_.value = value;
+    }
+    bool hasFailed() const noexcept
+    {
+        return result_.status == GuiCommandResult::Status::Failed;
+    }
+
+    void invoke(QObject *object, const char *method,
+                QGenericArgument val0 = QGenericArgument(nullptr),
+                QGenericArgument val1 = QGenericArgument(),
+                QGenericArgument val2 = QGenericArgument()) noexcept;
+    void writeProperty(QObject *object, const QString &propertyName,
+                       const QVariant &value) noexcept;
+    void postEvents(QObject *receiver, std::vector<QEvent *> events) noexcept;
+
+    GuiCommandResult takeResult() noexcept
+    {
+        return std::move(result_);
+    }
+
+private:
+    GuiCommandResult result_;
+};
+
+using GuiCommand = std::function<void(QObject *object, GuiCommandContext &context)>;
+/*
+ * Возвращает объект команды или nullptr, если его уже нет. Вызывается в GUI-потоке прямо
+ * перед выполнением команды: объекты удаляются в этом же потоке, поэтому указатель на объект
+ * нельзя получить заранее в другом потоке и разыменовать позже.
+ */
+using GuiObjectGetter = std::function<QObject *()>;
+
+/*
+ * Выполняет команду в GUI-потоке за один переход между потоками и ждет ее завершения не
+ * дольше timeoutMsec. Если объекта команды уже нет, то возвращается Status::Unavailable.
+ * Если команда не завершилась вовремя, ожидание прекращается: еще не начатая команда
+ * отменяется, а уже выполняющаяся завершится сама, но ее результат будет отброшен.
+ * Поэтому команда не должна ссылаться на данные вызывающего потока.
+ */
+GuiCommandResult executeInGuiThread(GuiObjectGetter getObject, GuiCommand command,
+                                    int timeoutMsec) noexcept;
+// Команда, не связанная с конкретным объектом, выполняется над qApp
+GuiCommandResult executeInGuiThread(GuiCommand command, int timeoutMsec) noexcept;
+
+struct GuiCommandStep final {
+    GuiObjectGetter getObject;
+    GuiCommand command;
+};
+
+/*
+ * Выполняет команды steps, начиная с first, подряд за один переход в GUI-поток. Выполнение
+ * останавливается после команды, которая не завершилась успешно или отправила события
+ * (следующим командам нужно дождаться их доставки), а для команды, объекта которой уже
+ * нет, возвращается Status::Unavailable. Возвращаются результаты выполненных команд.
+ * Если блок не уложился в timeoutMsec, то еще не начатые команды уже не начнутся, а если
+ * при этом одна из команд еще выполняется, то последним будет ее результат Status::TimedOut.
+ * Поэтому если блок не успел начать ни одной команды, то результатов не будет вовсе.
+ */
+std::vector<GuiCommandResult> executeStepsInGuiThread(const std::vector<GuiCommandStep> &steps,
+                                                      size_t first, int timeoutMsec) noexcept;
+} // namespace QtAda::core
@@ -0,0 +1,72 @@
+#include "MessageBatcher.hpp"
+
+#include <QThread>
+#include <QTimer>
+#include <utility>
+
+#include <inprocess/rep_InprocessController_replica.h>
+
+namespace QtAda::core {
+static constexpr int MAX_BATCH_SIZE = 256;
+
+MessageBatcher::MessageBatcher(std::shared_ptr<InprocessControllerReplica> inprocessController,
+                               QObject *parent) noexcept
+    : QObject{ parent }
+    , inprocessController_{ std::move(inprocessController) }
+    , flushTimer_{ new QTimer(this) }
+{
+    assert(inprocessController_ != nullptr);
+    // Таймер с нулевым интервалом срабатывает после уже поставленных в очередь событий, поэтому
+    // сообщения, пришедшие из потока скрипта за одну итерацию цикла событий, уходят вместе
+    flushTimer_->setSingleShot(true);
+    flushTimer_->setInterval(0);
+    connect(flushTimer_, &QTimer::timeout, this, &MessageBatcher::flush);
+}
+
+void MessageBatcher::addScriptRunError(const QString &msg) noexcept
+{
+    addMessage(InprocessMessageType::ScriptRunError, msg);
+}
+
+void MessageBatcher::addScriptRunWarning(const QString &msg) noexcept
+{
+    addMessage(InprocessMessageType::ScriptRunWarning, msg);
+}
+
+void MessageBatcher::addScriptRunLog(const QString &msg) noexcept
+{
+    addMessage(InprocessMessageType::ScriptRunLog, msg);
+}
+
+void MessageBatcher::addNewScriptLine(const QString &line) noexcept
+{
+    addMessage(InprocessMessageType::NewScriptLine, line);
+}
+
+void MessageBatcher::addMessage(InprocessMessageType type, const QString &msg) noexcept
+{
+    assert(thread() == QThread::currentThread());
+    types_.push_back(static_cast<int>(type));
+    messages_.push_back(msg);
+
+    if (messages_.size() >= MAX_BATCH_SIZE) {
+        flush();
+    }
+    else if (!flushTimer_->isActive()) {
+        flushTimer_->start();
+    }
+}
+
+void MessageBatcher::flush() noexcept
+{
+    flushTimer_->stop();
+    if (messages_.isEmpty()) {
+        return;
+    }
+
+    const auto firstSequence = nextSequence_;
+    nextSequence_ += messages_.size();
+    inprocessController_->sendMessageBatch(firstSequence, std::exchange(types_, QList<int>()),
+                                           std::exchange(messages_, QStringList()));
+}
+} // namespace QtAda::core
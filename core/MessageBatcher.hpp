@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QObject>
+#include <QStringList>
+#include <memory>
+
+#include "Common.hpp"
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+class InprocessControllerReplica;
+QT_END_NAMESPACE
+
+namespace QtAda::core {
+/*
+ * Копит сообщения скрипта и строки записываемого сценария и передает их лаунчеру одним вызовом
+ * QtRO за итерацию цикла событий (или сразу, если их накопилось MAX_BATCH_SIZE). Сообщения
+ * нумеруются по порядку с начала работы зонда. Перед сообщениями, которые передаются в обход
+ * MessageBatcher, нужно вызывать flush().
+ */
+class MessageBatcher final : public QObject {
+    Q_OBJECT
+public:
+    explicit MessageBatcher(std::shared_ptr<InprocessControllerReplica> inprocessController,
+                            QObject *parent = nullptr) noexcept;
+
+public slots:
+    void addScriptRunError(const QString &msg) noexcept;
+    void addScriptRunWarning(const QString &msg) noexcept;
+    void addScriptRunLog(const QString &msg) noexcept;
+    void addNewScriptLine(const QString &line) noexcept;
+
+    void flush() noexcept;
+
+private:
+    std::shared_ptr<InprocessControllerReplica> inprocessController_;
+    QTimer *flushTimer_ = nullptr;
+
+    qint64 nextSequence_ = 0;
+    QList<int> types_;
+    QStringList messages_;
+
+    void addMessage(InprocessMessageType type, const QString &msg) noexcept;
+};
+} // namespace QtAda::core
@@ -0,0 +1,283 @@
+#include "ObjectPathIndex.hpp"
+
+#include <QCoreApplication>
+#include <QObject>
+#include <QThread>
+#include <algorithm>
+
+#include "utils/FilterUtils.hpp"
+
+namespace QtAda::core {
+ObjectPathIndex::Changes ObjectPathIndex::add(QObject *obj) noexcept
+{
+    assert(obj != nullptr);
+    if (contains(obj)) {
+        return move(obj);
+    }
+
+    Changes changes;
+    insertNode(obj, changes);
+    return changes;
+}
+
+ObjectPathIndex::Changes ObjectPathIndex::move(QObject *obj) noexcept
+{
+    assert(obj != nullptr);
+    auto it = nodes_.find(obj);
+    if (it == nodes_.end()) {
+        return add(obj);
+    }
+
+    Changes changes;
+    auto &node = it->second;
+    detachNode(node, changes);
+
+    auto *parent = obj->parent();
+    if (parent != nullptr && !contains(parent)) {
+        insertNode(parent, changes);
+    }
+    node.parent = parent;
+    node.metaObject = obj->metaObject();
+    node.className = node.metaObject->className();
+    node.objectName = obj->objectName();
+    node.isNameChecked = obj->thread() == QCoreApplication::instance()->thread();
+    attachNode(node, changes);
+    changes.changedObjects.push_back(obj);
+    return changes;
+}
+
+ObjectPathIndex::Changes ObjectPathIndex::remove(const QObject *obj) noexcept
+{
+    Changes changes;
+    auto it = nodes_.find(obj);
+    if (it == nodes_.end()) {
+        return changes;
+    }
+
+    // Объект может быть уже частично удален, поэтому используем только данные из индекса
+    detachNode(it->second, changes);
+    eraseSubtree(obj, changes);
+    return changes;
+}
+
+ObjectPathIndex::Changes ObjectPathIndex::refreshNames() noexcept
+{
+    std::vector<QObject *> renamedObjects;
+    for (const auto &it : nodes_) {
+        const auto &node = it.second;
+        if (node.isNameChecked && node.object->objectName() != node.objectName) {
+            renamedObjects.push_back(node.object);
+        }
+    }
+
+    Changes changes;
+    for (auto *obj : renamedObjects) {
+        auto objChanges = move(obj);
+        changes.removedObjects.insert(changes.removedObjects.end(),
+                                      objChanges.removedObjects.begin(),
+                                      objChanges.removedObjects.end());
+        changes.changedObjects.insert(changes.changedObjects.end(),
+                                      objChanges.changedObjects.begin(),
+                                      objChanges.changedObjects.end());
+    }
+    return changes;
+}
+
+void ObjectPathIndex::stopNameCheck(const QObject *obj) noexcept
+{
+    const auto it = nodes_.find(obj);
+    if (it != nodes_.end()) {
+        it->second.isNameChecked = false;
+    }
+}
+
+void ObjectPathIndex::clear() noexcept
+{
+    nodes_.clear();
+}
+
+QObject *ObjectPathIndex::parent(const QObject *obj) const noexcept
+{
+    const auto it = nodes_.find(obj);
+    return it != nodes_.end() ? it->second.parent : nullptr;
+}
+
+QString ObjectPathIndex::segment(const QObject *obj) const noexcept
+{
+    const auto it = nodes_.find(obj);
+    if (it == nodes_.end()) {
+        return QString();
+    }
+    // Объект может принадлежать другому потоку, поэтому сегмент строится по данным индекса
+    const auto &node = it->second;
+    return utils::objectPathSegment(node.metaObject, node.objectName, node.siblingIndex);
+}
+
+ObjectPathIndex::Node *ObjectPathIndex::insertNode(QObject *obj, Changes &changes) noexcept
+{
+    auto *parent = obj->parent();
+    if (parent != nullptr && !contains(parent)) {
+        insertNode(parent, changes);
+    }
+
+    auto &node = nodes_[obj];
+    node.object = obj;
+    node.parent = parent;
+    node.metaObject = obj->metaObject();
+    node.className = node.metaObject->className();
+    node.objectName = obj->objectName();
+    node.isNameChecked = obj->thread() == QCoreApplication::instance()->thread();
+    attachNode(node, changes);
+
+    changes.changedObjects.push_back(obj);
+    return &node;
+}
+
+void ObjectPathIndex::attachNode(Node &node, Changes &changes) noexcept
+{
+    if (node.parent == nullptr) {
+        node.siblingIndex = 0;
+        return;
+    }
+
+    auto parentIt = nodes_.find(node.parent);
+    assert(parentIt != nodes_.end());
+    auto &parentNode = parentIt->second;
+    parentNode.childCount++;
+
+    // Номер считается среди всех потомков родителя, как в utils::objectPath. По группе
+    // его можно взять, только если все потомки уже есть в индексе
+    const auto &siblings = node.parent->children();
+    const bool isAppended = !siblings.isEmpty() && siblings.last() == node.object
+                            && parentNode.childCount == static_cast<size_t>(siblings.size());
+    placeInGroup(parentNode.classGroups[node.className], node, true, isAppended, changes);
+    if (!node.objectName.isEmpty()) {
+        placeInGroup(parentNode.nameGroups[node.objectName], node, false, isAppended, changes);
+    }
+}
+
+void ObjectPathIndex::detachNode(Node &node, Changes &changes) noexcept
+{
+    if (node.parent == nullptr) {
+        return;
+    }
+    auto parentIt = nodes_.find(node.parent);
+    if (parentIt == nodes_.end()) {
+        return;
+    }
+    auto &parentNode = parentIt->second;
+    assert(parentNode.childCount > 0);
+    parentNode.childCount--;
+
+    const auto eraseFromGroup = [&](auto &groups, const auto &key, bool isClassGroup) {
+        auto groupIt = groups.find(key);
+        if (groupIt == groups.end()) {
+            return;
+        }
+        auto &group = groupIt->second;
+        const auto pos = std::find(group.begin(), group.end(), node.object);
+        if (pos == group.end()) {
+            return;
+        }
+        const auto from = static_cast<size_t>(pos - group.begin());
+        group.erase(pos);
+        if (group.empty()) {
+            groups.erase(groupIt);
+        }
+        else {
+            shiftGroup(group, from, isClassGroup, changes);
+        }
+    };
+    eraseFromGroup(parentNode.classGroups, node.className, true);
+    if (!node.objectName.isEmpty()) {
+        eraseFromGroup(parentNode.nameGroups, node.objectName, false);
+    }
+}
+
+void ObjectPathIndex::eraseSubtree(const QObject *obj, Changes &changes) noexcept
+{
+    auto it = nodes_.find(obj);
+    if (it == nodes_.end()) {
+        return;
+    }
+
+    std::vector<const QObject *> children;
+    for (const auto &group : it->second.classGroups) {
+        children.insert(children.end(), group.second.begin(), group.second.end());
+    }
+    for (const auto *child : children) {
+        eraseSubtree(child, changes);
+    }
+
+    nodes_.erase(obj);
+    changes.removedObjects.push_back(obj);
+}
+
+void ObjectPathIndex::placeInGroup(Group &group, Node &node, bool isClassGroup, bool isAppended,
+                                   Changes &changes) noexcept
+{
+    const bool isOwnGroup = isClassGroup == node.objectName.isEmpty();
+    if (isAppended) {
+        // Типичный случай: объект только что добавлен в конец списка потомков
+        group.push_back(node.object);
+        if (isOwnGroup) {
+            node.siblingIndex = static_cast<uint>(group.size() - 1);
+        }
+        return;
+    }
+
+    // Объект вставлен в середину списка потомков (или у родителя есть потомки, которых нет в
+    // индексе), поэтому восстанавливаем порядок группы и номера по списку потомков родителя.
+    // Номера считаются среди всех потомков, так же как их считает utils::objectPath
+    group.clear();
+    uint ordinal = 0;
+    for (auto *sibling : node.parent->children()) {
+        // При удалении родителя QObject обнуляет элементы списка уже удаленных потомков
+        if (sibling == nullptr) {
+            continue;
+        }
+        const bool isCounted = isClassGroup
+                                   ? sibling->metaObject()->className() == node.className
+                                   : sibling->objectName() == node.objectName;
+        const auto siblingIt = nodes_.find(sibling);
+        if (siblingIt != nodes_.end() && siblingIt->second.parent == node.parent) {
+            auto &siblingNode = siblingIt->second;
+            const bool isInGroup = isClassGroup ? siblingNode.className == node.className
+                                                : siblingNode.objectName == node.objectName;
+            if (isInGroup) {
+                group.push_back(sibling);
+                // Номер объекта с именем определяется группой с тем же именем, а номер объекта
+                // без имени - группой с тем же классом
+                if (isClassGroup == siblingNode.objectName.isEmpty()
+                    && siblingNode.siblingIndex != ordinal) {
+                    siblingNode.siblingIndex = ordinal;
+                    if (sibling != node.object) {
+                        changes.changedObjects.push_back(sibling);
+                    }
+                }
+            }
+        }
+        if (isCounted) {
+            ordinal++;
+        }
+    }
+    if (std::find(group.begin(), group.end(), node.object) == group.end()) {
+        // Объекта нет в списке потомков, если родитель уже удаляется
+        group.push_back(node.object);
+    }
+}
+
+void ObjectPathIndex::shiftGroup(Group &group, size_t from, bool isClassGroup,
+                                 Changes &changes) noexcept
+{
+    // Удаленный объект учитывался в номерах всех следующих за ним соседей из той же группы
+    for (size_t i = from; i < group.size(); ++i) {
+        auto &node = nodes_.at(group[i]);
+        if (isClassGroup != node.objectName.isEmpty() || node.siblingIndex == 0) {
+            continue;
+        }
+        node.siblingIndex--;
+        changes.changedObjects.push_back(node.object);
+    }
+}
+} // namespace QtAda::core
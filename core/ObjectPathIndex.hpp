@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QString>
+#include <unordered_map>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+class QObject;
+QT_END_NAMESPACE
+
+namespace QtAda::core {
+/*
+ * Инкрементальный индекс путей объектов (см. utils::objectPath).
+ *
+ * Для каждого объекта хранится его родитель и номер среди соседей, а для каждого родителя -
+ * упорядоченные (в порядке QObject::children()) группы потомков с одинаковым классом и
+ * с одинаковым именем. Номер, как и в utils::objectPath, считается среди всех потомков
+ * родителя, в том числе отсутствующих в индексе. Номер нового объекта, добавленного в конец
+ * списка потомков, вычисляется за O(1), если все остальные потомки уже есть в индексе.
+ * Иначе, а также при вставке в середину списка, номера группы пересчитываются по списку
+ * потомков. При удалении объекта номера его соседей из той же группы уменьшаются. Полные
+ * пути не хранятся: сегменты объектов регистрируются в ObjectRegistry, где из них строится
+ * дерево путей.
+ *
+ * Изменение имени объекта GUI-потока не отслеживается сразу: refreshNames сравнивает имена
+ * таких объектов с сохраненными и переносит переименованные. Имена объектов других потоков
+ * читать из GUI-потока небезопасно, поэтому такие объекты добавляются и перемещаются в их
+ * собственном потоке (см. Probe::addForeignObject), а remove и segment используют только
+ * данные индекса.
+ *
+ * Индекс не потокобезопасен: вызовы должны быть упорядочены снаружи.
+ */
+class ObjectPathIndex final {
+public:
+    struct Changes final {
+        // Объекты, удаленные из индекса вместе с удаляемым объектом
+        std::vector<const QObject *> removedObjects;
+        // Объекты, у которых изменился родитель или сегмент пути (включая добавленные).
+        // Пути их потомков меняются вместе с ними, поэтому потомки сюда не попадают
+        std::vector<QObject *> changedObjects;
+    };
+
+    Changes add(QObject *obj) noexcept;
+    Changes move(QObject *obj) noexcept;
+    Changes remove(const QObject *obj) noexcept;
+    Changes refreshNames() noexcept;
+    // Вызывается до переноса объекта в другой поток, после чего его имя не проверяется
+    void stopNameCheck(const QObject *obj) noexcept;
+    void clear() noexcept;
+
+    bool contains(const QObject *obj) const noexcept
+    {
+        return nodes_.find(obj) != nodes_.end();
+    }
+    QObject *parent(const QObject *obj) const noexcept;
+    QString segment(const QObject *obj) const noexcept;
+
+private:
+    using Group = std::vector<QObject *>;
+
+    struct Node final {
+        QObject *object = nullptr;
+        QObject *parent = nullptr;
+        // Класс и имя на момент добавления в индекс, по ним объект находится в группах родителя.
+        // Как и в utils::objectPath, соседи группируются по указателю className()
+        const char *className = nullptr;
+        const QMetaObject *metaObject = nullptr;
+        QString objectName;
+        uint siblingIndex = 0;
+        // Объект принадлежит GUI-потоку, и его имя проверяется в refreshNames
+        bool isNameChecked = false;
+
+        // Количество потомков в индексе. Если оно меньше размера QObject::children(), номера
+        // новых потомков считаются по списку потомков, а не по группам
+        size_t childCount = 0;
+        std::unordered_map<const char *, Group> classGroups;
+        std::unordered_map<QString, Group> nameGroups;
+    };
+    std::unordered_map<const QObject *, Node> nodes_;
+
+    Node *insertNode(QObject *obj, Changes &changes) noexcept;
+    void attachNode(Node &node, Changes &changes) noexcept;
+    void detachNode(Node &node, Changes &changes) noexcept;
+    void eraseSubtree(const QObject *obj, Changes &changes) noexcept;
+
+    void placeInGroup(Group &group, Node &node, bool isClassGroup, bool isAppended,
+                      Changes &changes) noexcept;
+    void shiftGroup(Group &group, size_t from, bool isClassGroup, Changes &changes) noexcept;
+};
+} // namespace QtAda::core
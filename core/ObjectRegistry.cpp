@@ -0,0 +1,258 @@
+#include "ObjectRegistry.hpp"
+
+#include <QObject>
+#include <algorithm>
+
+namespace QtAda::core {
+size_t ObjectRegistry::EdgeHash::operator()(const Edge &edge) const noexcept
+{
+    // Указатели выровнены, поэтому перемешиваем биты, чтобы ребра равномерно
+    // распределялись и по корзинам, и по частям таблицы
+    constexpr quint64 multiplier = 0x9E3779B97F4A7C15ULL;
+    auto hash = (reinterpret_cast<quintptr>(edge.parent) * multiplier)
+                ^ reinterpret_cast<quintptr>(edge.segment);
+    hash *= multiplier;
+    return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+const QString *ObjectRegistry::internSegment(const QString &segment, uint segmentHash) noexcept
+{
+    auto &shard = segmentShards_[segmentHash % SHARDS_COUNT];
+    QMutexLocker locker(&shard.mutex);
+    const auto result = shard.segments.insert(segment);
+    const auto *atom = &*result.first;
+    if (result.second) {
+        // QStringView ссылается на данные самого сегмента, которые больше не изменяются
+        shard.segmentsByView.insert(QStringView(*atom), atom);
+    }
+    return atom;
+}
+
+const QString *ObjectRegistry::findSegment(QStringView segment, uint segmentHash) const noexcept
+{
+    const auto &shard = segmentShards_[segmentHash % SHARDS_COUNT];
+    QMutexLocker locker(&shard.mutex);
+    return shard.segmentsByView.value(segment, nullptr);
+}
+
+void ObjectRegistry::insertClaimant(const Edge &edge, QObject *obj) noexcept
+{
+    auto &shard = shardFor(edge);
+    QMutexLocker locker(&shard.mutex);
+    shard.edges[edge].append(obj);
+}
+
+void ObjectRegistry::removeClaimant(const Edge &edge, const QObject *obj) noexcept
+{
+    auto &shard = shardFor(edge);
+    QMutexLocker locker(&shard.mutex);
+    const auto it = shard.edges.find(edge);
+    if (it == shard.edges.end()) {
+        return;
+    }
+    auto &claimants = it->second;
+    const auto pos = std::find(claimants.begin(), claimants.end(), obj);
+    if (pos != claimants.end()) {
+        claimants.erase(pos);
+    }
+    if (claimants.isEmpty()) {
+        shard.edges.erase(it);
+    }
+}
+
+void ObjectRegistry::appendClaimants(const Edge &edge, Claimants &claimants) const noexcept
+{
+    const auto &shard = shardFor(edge);
+    QMutexLocker locker(&shard.mutex);
+    const auto it = shard.edges.find(edge);
+    if (it != shard.edges.end()) {
+        claimants.append(it->second.constData(), it->second.size());
+    }
+}
+
+void ObjectRegistry::notifyWaiters(uint segmentHash) noexcept
+{
+    // Результат поиска по пути изменяется только при изменении одного из его ребер, поэтому
+    // мьютекс ожидания захватывается, только если сегмент ребра может входить в один из
+    // ожидаемых путей (совпадение битов без совпадения сегментов приведет лишь к лишней
+    // проверке)
+    const auto bit = segmentBit(segmentHash);
+    if ((awaitedSegmentsMask_.loadAcquire() & bit) == 0) {
+        return;
+    }
+    QMutexLocker locker(&waitMutex_);
+    for (auto &waiter : waiters_) {
+        if ((waiter.second.segmentsMask & bit) != 0) {
+            waiter.second.pathChanged.wakeAll();
+        }
+    }
+}
+
+void ObjectRegistry::registerObject(QObject *obj, const QObject *parent,
+                                    const QString &segment) noexcept
+{
+    assert(obj != nullptr);
+    assert(!segment.isEmpty());
+
+    const auto segmentHash = qHash(QStringView(segment));
+    const Edge edge{ parent, internSegment(segment, segmentHash) };
+    const auto result = objectEdges_.try_emplace(obj, edge);
+    if (result.second) {
+        objectCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (result.first->second == edge) {
+        return;
+    }
+    else {
+        removeClaimant(result.first->second, obj);
+        result.first->second = edge;
+    }
+    insertClaimant(edge, obj);
+    notifyWaiters(segmentHash);
+}
+
+void ObjectRegistry::unregisterObject(const QObject *obj) noexcept
+{
+    const auto it = objectEdges_.find(obj);
+    if (it == objectEdges_.end()) {
+        return;
+    }
+    // Ребра потомков удаляются из реестра отдельно (ObjectPathIndex возвращает удаляемое
+    // поддерево целиком), до этого момента они недоступны для поиска
+    const auto *segment = it->second.segment;
+    removeClaimant(it->second, obj);
+    objectEdges_.erase(it);
+    objectCount_.fetch_sub(1, std::memory_order_relaxed);
+    // Путь мог снова занять объект, который был зарегистрирован по нему раньше
+    notifyWaiters(qHash(QStringView(*segment)));
+}
+
+void ObjectRegistry::clear() noexcept
+{
+    for (auto &shard : edgeShards_) {
+        QMutexLocker locker(&shard.mutex);
+        shard.edges.clear();
+    }
+    for (auto &shard : segmentShards_) {
+        QMutexLocker locker(&shard.mutex);
+        shard.segmentsByView.clear();
+        shard.segments.clear();
+    }
+    objectEdges_.clear();
+    objectCount_.store(0, std::memory_order_relaxed);
+}
+
+QObject *ObjectRegistry::find(const QString &path) const noexcept
+{
+    const QStringView pathView(path);
+    Claimants candidates;
+    bool isRoot = true;
+    qsizetype from = 0;
+    while (from <= pathView.size()) {
+        auto to = pathView.indexOf(QLatin1Char('/'), from);
+        if (to < 0) {
+            to = pathView.size();
+        }
+
+        const auto segmentView = pathView.mid(from, to - from);
+        const auto *segment = findSegment(segmentView, qHash(segmentView));
+        if (segment == nullptr) {
+            return nullptr;
+        }
+        // Обычно на каждом уровне только один кандидат, но если путь занят несколькими
+        // объектами, то искомый потомок может быть у любого из них
+        Claimants children;
+        if (isRoot) {
+            appendClaimants({ nullptr, segment }, children);
+        }
+        else {
+            for (const auto *candidate : candidates) {
+                appendClaimants({ candidate, segment }, children);
+            }
+        }
+        if (children.isEmpty()) {
+            return nullptr;
+        }
+        candidates = children;
+        isRoot = false;
+        from = to + 1;
+    }
+    return candidates.isEmpty() ? nullptr : candidates.last();
+}
+
+QObject *ObjectRegistry::waitFor(const QString &path, QDeadlineTimer deadline) const noexcept
+{
+    const QStringView pathView(path);
+    quint64 segmentsMask = 0;
+    qsizetype from = 0;
+    while (from <= pathView.size()) {
+        auto to = pathView.indexOf(QLatin1Char('/'), from);
+        if (to < 0) {
+            to = pathView.size();
+        }
+        segmentsMask |= segmentBit(qHash(pathView.mid(from, to - from)));
+        from = to + 1;
+    }
+
+    // Маска выставляется до проверки дерева, а мьютекс ожидания удерживается до засыпания,
+    // поэтому появление ребра между проверкой и ожиданием не теряется
+    QMutexLocker locker(&waitMutex_);
+    auto &waiter = waiters_[path];
+    waiter.segmentsMask = segmentsMask;
+    waiter.count++;
+    awaitedSegmentsMask_.fetchAndOrRelease(segmentsMask);
+
+    QObject *object = nullptr;
+    bool isWaiting = true;
+    while (true) {
+        object = find(path);
+        if (object != nullptr || !isWaiting) {
+            break;
+        }
+        // Ссылка остается действительной: запись удаляет только последний ожидающий поток
+        isWaiting = waiter.pathChanged.wait(&waitMutex_, deadline);
+    }
+
+    if (--waiter.count == 0) {
+        waiters_.erase(path);
+        quint64 awaitedMask = 0;
+        for (const auto &other : waiters_) {
+            awaitedMask |= other.second.segmentsMask;
+        }
+        awaitedSegmentsMask_.storeRelease(awaitedMask);
+    }
+    return object;
+}
+
+size_t ObjectRegistry::memoryUsage() const noexcept
+{
+    // Оценка без учета служебных данных аллокатора: узлы хеш-таблиц считаются как элемент
+    // плюс указатель на следующий узел и сохраненный хеш, корзины - как один указатель
+    size_t usage = 0;
+    for (const auto &shard : edgeShards_) {
+        QMutexLocker locker(&shard.mutex);
+        usage += shard.edges.bucket_count() * sizeof(void *);
+        for (const auto &edge : shard.edges) {
+            usage += sizeof(edge) + sizeof(void *) + sizeof(size_t);
+            if (edge.second.capacity() > CLAIMANTS_PREALLOC) {
+                usage += static_cast<size_t>(edge.second.capacity()) * sizeof(QObject *);
+            }
+        }
+    }
+    for (const auto &shard : segmentShards_) {
+        QMutexLocker locker(&shard.mutex);
+        usage += shard.segments.bucket_count() * sizeof(void *);
+        for (const auto &segment : shard.segments) {
+            usage += sizeof(QString) + sizeof(void *) + sizeof(QArrayData)
+                     + static_cast<size_t>(segment.capacity() + 1) * sizeof(QChar);
+        }
+        usage += static_cast<size_t>(shard.segmentsByView.capacity())
+                 * (sizeof(QStringView) + sizeof(const QString *) + 2 * sizeof(void *));
+    }
+    // Таблица ребер объектов изменяется GUI-потоком без блокировок, поэтому ее размер
+    // оценивается по числу объектов
+    usage += objectCount()
+             * (sizeof(decltype(objectEdges_)::value_type) + 2 * sizeof(void *) + sizeof(size_t));
+    return usage;
+}
+} // namespace QtAda::core
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringView>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QDeadlineTimer>
+#include <QAtomicInteger>
+#include <QVarLengthArray>
+#include <unordered_map>
+#include <unordered_set>
+#include <array>
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+class QObject;
+QT_END_NAMESPACE
+
+namespace QtAda::core {
+/*
+ * Реестр "путь -> объект", который заполняется из Probe (регистрация объектов
+ * через ScriptRunner), а читается из потока скрипта (поиск объектов по пути).
+ *
+ * Пути хранятся в виде префиксного дерева по сегментам (см. utils::objectPathSegment):
+ * ребро дерева - это пара "объект-родитель, сегмент потомка", а сами сегменты хранятся в
+ * единственном экземпляре. Поиск по пути проходит по сегментам с поиском ребер в хеш-таблицах,
+ * а перемещение объекта (смена родителя или сегмента) перевешивает только его ребро, и все
+ * поддерево перемещается вместе с ним.
+ *
+ * Таблицы ребер и сегментов разбиты на части, каждая из которых защищена своим мьютексом,
+ * поэтому запись и чтение блокируют только одну часть и только на время одной операции над
+ * хеш-таблицей. Поток, ожидающий появления объекта, не опрашивает реестр, а засыпает до
+ * появления или удаления ребра с одним из сегментов ожидаемого пути. Ожидать разные пути
+ * могут одновременно несколько потоков.
+ */
+class ObjectRegistry final {
+public:
+    // Вызовы должны быть упорядочены между собой: ScriptRunner выполняет их под своим
+    // мьютексом, так как объекты других потоков регистрируются в их потоках. При совпадении
+    // путей поиск возвращает последний зарегистрированный объект, а остальные (вместе с
+    // поддеревьями) снова становятся доступны, когда он будет удален или перемещен
+    void registerObject(QObject *obj, const QObject *parent, const QString &segment) noexcept;
+    void unregisterObject(const QObject *obj) noexcept;
+    void clear() noexcept;
+
+    // Могут вызываться из любого потока
+    QObject *find(const QString &path) const noexcept;
+    QObject *waitFor(const QString &path, QDeadlineTimer deadline) const noexcept;
+
+    size_t objectCount() const noexcept
+    {
+        return objectCount_.load(std::memory_order_relaxed);
+    }
+    // Приблизительный объем памяти, занимаемый реестром (в байтах)
+    size_t memoryUsage() const noexcept;
+
+private:
+    static constexpr uint SHARDS_COUNT = 16;
+
+    struct Edge final {
+        // nullptr для корневых объектов
+        const QObject *parent = nullptr;
+        const QString *segment = nullptr;
+
+        bool operator==(const Edge &other) const noexcept
+        {
+            return parent == other.parent && segment == other.segment;
+        }
+    };
+    struct EdgeHash final {
+        size_t operator()(const Edge &edge) const noexcept;
+    };
+    // Объекты с одинаковым путем в порядке регистрации
+    static constexpr int CLAIMANTS_PREALLOC = 1;
+    using Claimants = QVarLengthArray<QObject *, CLAIMANTS_PREALLOC>;
+    using Edges = std::unordered_map<Edge, Claimants, EdgeHash>;
+
+    struct EdgeShard final {
+        mutable QMutex mutex;
+        Edges edges;
+    };
+    struct SegmentShard final {
+        mutable QMutex mutex;
+        // Сегменты не удаляются: их количество ограничено числом различных имен и классов
+        // (с учетом номеров среди соседей)
+        std::unordered_set<QString> segments;
+        QHash<QStringView, const QString *> segmentsByView;
+    };
+    std::array<EdgeShard, SHARDS_COUNT> edgeShards_;
+    std::array<SegmentShard, SHARDS_COUNT> segmentShards_;
+
+    // Текущее ребро каждого объекта. Используется только при регистрации объектов
+    std::unordered_map<const QObject *, Edge> objectEdges_;
+    std::atomic<size_t> objectCount_ = 0;
+
+    struct Waiter final {
+        // Биты хешей сегментов ожидаемого пути
+        quint64 segmentsMask = 0;
+        // Количество потоков, ожидающих этот путь
+        int count = 0;
+        QWaitCondition pathChanged;
+    };
+    mutable QMutex waitMutex_;
+    mutable std::unordered_map<QString, Waiter> waiters_;
+    // Объединение масок всех ожидаемых путей, 0 - если ожидающих нет
+    mutable QAtomicInteger<quint64> awaitedSegmentsMask_ = 0;
+
+    EdgeShard &shardFor(const Edge &edge) noexcept
+    {
+        return edgeShards_[EdgeHash()(edge) % SHARDS_COUNT];
+    }
+    const EdgeShard &shardFor(const Edge &edge) const noexcept
+    {
+        return edgeShards_[EdgeHash()(edge) % SHARDS_COUNT];
+    }
+    static quint64 segmentBit(uint segmentHash) noexcept
+    {
+        return quint64(1) << (segmentHash % 64);
+    }
+
+    const QString *internSegment(const QString &segment, uint segmentHash) noexcept;
+    const QString *findSegment(QStringView segment, uint segmentHash) const noexcept;
+    void insertClaimant(const Edge &edge, QObject *obj) noexcept;
+    void removeClaimant(const Edge &edge, const QObject *obj) noexcept;
+    void appendClaimants(const Edge &edge, Claimants &claimants) const noexcept;
+    void notifyWaiters(uint segmentHash) noexcept;
+};
+} // namespace QtAda::core
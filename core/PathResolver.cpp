@@ -0,0 +1,205 @@
+#include "PathResolver.hpp"
+
+#include <QCoreApplication>
+#include <QGuiApplication>
+#include <QApplication>
+#include <QWindow>
+#include <QWidget>
+#include <QStringView>
+#include <optional>
+
+#include "utils/FilterUtils.hpp"
+
+namespace QtAda::core {
+namespace {
+struct Segment final {
+    bool isNamed = false;
+    // Имя объекта для "n=" или имя класса (без QML-суффиксов) для "c="
+    QStringView name;
+    uint siblingIndex = 0;
+};
+
+std::optional<Segment> parseSegment(QStringView segment) noexcept
+{
+    Segment result;
+    if (segment.startsWith(QLatin1String("n="))) {
+        result.isNamed = true;
+    }
+    else if (!segment.startsWith(QLatin1String("c="))) {
+        return std::nullopt;
+    }
+
+    // Имя может содержать '_', поэтому номер отделяется последним из них
+    const auto separator = segment.lastIndexOf(QLatin1Char('_'));
+    if (separator < 2) {
+        return std::nullopt;
+    }
+    bool isOk = false;
+    result.siblingIndex = segment.mid(separator + 1).toString().toUInt(&isOk);
+    if (!isOk) {
+        return std::nullopt;
+    }
+    result.name = segment.mid(2, separator - 2);
+    return result;
+}
+
+// Нумерация соседей совпадает с utils::objectPath: для "n=" считаются соседи с тем же
+// именем, для "c=" - соседи с тем же указателем className() (в том числе именованные).
+// Разные QML-типы с одинаковым именем нумеруются независимо, поэтому для "c=" номера
+// считаются отдельно для каждого className()
+QObject *findInObjectList(const QObjectList &objects, const Segment &segment) noexcept
+{
+    if (segment.isNamed) {
+        uint index = 0;
+        for (auto *obj : objects) {
+            if (obj->objectName() == segment.name && index++ == segment.siblingIndex) {
+                return obj;
+            }
+        }
+        return nullptr;
+    }
+
+    QHash<const char *, uint> classIndexes;
+    for (auto *obj : objects) {
+        const auto index = classIndexes[obj->metaObject()->className()]++;
+        if (index == segment.siblingIndex && obj->objectName().isEmpty()
+            && *utils::classNameAtom(obj->metaObject()) == segment.name) {
+            return obj;
+        }
+    }
+    return nullptr;
+}
+
+QObject *findRoot(const Segment &segment) noexcept
+{
+    // У корневых объектов нет соседей, поэтому их номер всегда равен 0
+    if (segment.siblingIndex != 0) {
+        return nullptr;
+    }
+
+    QObjectList roots = { QCoreApplication::instance() };
+    if (qobject_cast<QGuiApplication *>(QCoreApplication::instance()) != nullptr) {
+        for (auto *window : QGuiApplication::allWindows()) {
+            if (window->QObject::parent() == nullptr) {
+                roots.push_back(window);
+            }
+        }
+    }
+    if (qobject_cast<QApplication *>(QCoreApplication::instance()) != nullptr) {
+        for (auto *widget : QApplication::topLevelWidgets()) {
+            if (widget->parent() == nullptr) {
+                roots.push_back(widget);
+            }
+        }
+    }
+
+    for (auto *root : roots) {
+        const auto objName = root->objectName();
+        const bool isMatch = segment.isNamed
+                                 ? objName == segment.name
+                                 : objName.isEmpty()
+                                       && *utils::classNameAtom(root->metaObject()) == segment.name;
+        if (isMatch) {
+            return root;
+        }
+    }
+    return nullptr;
+}
+
+// Проверка последнего сегмента пути без построения всего пути объекта: совпадают имя
+// (или класс) и номер среди соседей
+bool isLastSegmentOf(const QObject *obj, const Segment &segment) noexcept
+{
+    const auto objName = obj->objectName();
+    const bool isSameName = segment.isNamed
+                                ? objName == segment.name
+                                : objName.isEmpty()
+                                      && *utils::classNameAtom(obj->metaObject()) == segment.name;
+    if (!isSameName) {
+        return false;
+    }
+
+    const auto *parent = obj->parent();
+    if (parent == nullptr) {
+        return segment.siblingIndex == 0;
+    }
+    uint index = 0;
+    const auto className = obj->metaObject()->className();
+    for (const auto *sibling : parent->children()) {
+        if (sibling == obj) {
+            return index == segment.siblingIndex;
+        }
+        const bool isSameGroup = segment.isNamed ? sibling->objectName() == objName
+                                                 : sibling->metaObject()->className() == className;
+        if (isSameGroup && index++ == segment.siblingIndex) {
+            return false;
+        }
+    }
+    return false;
+}
+} // namespace
+
+bool PathResolver::isValid(const QString &path, const CacheEntry &entry) const noexcept
+{
+    const auto *obj = entry.object.data();
+    if (obj == nullptr) {
+        return false;
+    }
+
+    // Предки сравниваются по указателям и именам, поэтому отслеживается перемещение или
+    // переименование объекта и любого из предков, но не смена номера предка среди соседей
+    const auto *ancestor = obj->parent();
+    for (const auto &cachedAncestor : entry.ancestors) {
+        if (ancestor != cachedAncestor.first || ancestor->objectName() != cachedAncestor.second) {
+            return false;
+        }
+        ancestor = ancestor->parent();
+    }
+    if (ancestor != nullptr) {
+        return false;
+    }
+
+    const auto lastSegment = parseSegment(QStringView(path).mid(path.lastIndexOf('/') + 1));
+    return lastSegment.has_value() && isLastSegmentOf(obj, *lastSegment);
+}
+
+QObject *PathResolver::resolve(const QString &path) noexcept
+{
+    const auto cached = cache_.find(path);
+    if (cached != cache_.end()) {
+        if (isValid(path, cached.value())) {
+            return cached.value().object.data();
+        }
+        cache_.erase(cached);
+    }
+
+    QObject *obj = nullptr;
+    const QStringView pathView(path);
+    qsizetype from = 0;
+    while (from <= pathView.size()) {
+        auto to = pathView.indexOf(QLatin1Char('/'), from);
+        if (to < 0) {
+            to = pathView.size();
+        }
+        const auto segment = parseSegment(pathView.mid(from, to - from));
+        if (!segment.has_value()) {
+            return nullptr;
+        }
+        obj = obj == nullptr ? findRoot(*segment) : findInObjectList(obj->children(), *segment);
+        if (obj == nullptr) {
+            return nullptr;
+        }
+        from = to + 1;
+    }
+
+    if (obj != nullptr) {
+        CacheEntry entry{ obj, {} };
+        for (const auto *ancestor = obj->parent(); ancestor != nullptr;
+             ancestor = ancestor->parent()) {
+            entry.ancestors.emplace_back(ancestor, ancestor->objectName());
+        }
+        cache_.insert(path, std::move(entry));
+    }
+    return obj;
+}
+} // namespace QtAda::core
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QPointer>
+#include <QObject>
+#include <vector>
+#include <utility>
+
+namespace QtAda::core {
+/*
+ * Поиск объекта по пути "по требованию": путь разбирается на сегменты, и объект ищется
+ * обходом потомков, начиная с корневых объектов приложения (qApp, окна и виджеты верхнего
+ * уровня). В отличие от ObjectRegistry не требует регистрации всех объектов приложения,
+ * поэтому потомки других объектов без родителя (не окон) этим способом не находятся: список
+ * таких объектов без отслеживания создания объектов не получить.
+ *
+ * Найденные объекты кешируются (через QPointer, поэтому удаленные объекты из кеша не
+ * возвращаются). Перед использованием закешированного объекта путь заново не строится:
+ * проверяется, что не изменилась цепочка его предков (и их имена) и что последний сегмент
+ * пути все еще соответствует объекту. Используется только из GUI-потока.
+ */
+class PathResolver final {
+public:
+    QObject *resolve(const QString &path) noexcept;
+    void clear() noexcept
+    {
+        cache_.clear();
+    }
+
+private:
+    struct CacheEntry final {
+        QPointer<QObject> object;
+        // Предки объекта от родителя до корня и их имена на момент поиска (указатели
+        // используются только для сравнения)
+        std::vector<std::pair<const QObject *, QString>> ancestors;
+    };
+    QHash<QString, CacheEntry> cache_;
+
+    bool isValid(const QString &path, const CacheEntry &entry) const noexcept;
+};
+} // namespace QtAda::core
@@ -9,9 +9,13 @@
 #include <QRecursiveMutex>
 #include <QWindow>
 #include <private/qhooks_p.h>
+#include <set>
+#include <algorithm>
+#include <iostream>
 
 #include "Paths.hpp"
 #include "ProbeGuard.hpp"
+#include "MessageBatcher.hpp"
 #include "UserEventFilter.hpp"
 #include "UserVerificationFilter.hpp"
 #include "ScriptRunner.hpp"
@@ -22,6 +26,7 @@ namespace QtAda::core {
 static constexpr char QTADA_NAMESPACE[] = "QtAda::";
 static constexpr uint8_t QTADA_NAMESPACE_LEN = 7;
 static constexpr uint8_t LOOP_DETECTION_COUNT = 100;
+static constexpr size_t INITIAL_KNOWN_OBJECTS_CAPACITY = 4096;
 
 //! TODO: Странный класс, который является QObject, и не совсем понятно
 //! что с ним делать: у него нет ни потомков, ни родителей. Все что может
@@ -38,7 +43,9 @@ Q_GLOBAL_STATIC(QRecursiveMutex, s_mutex)
 
 struct LilProbe {
     LilProbe() = default;
+    // Удаленные до инициализации объекты заменяются на nullptr, чтобы не сдвигать вектор
     std::vector<QObject *> objsAddedBeforeProbeInit;
+    std::unordered_map<const QObject *, size_t> objsAddedBeforeProbeInitIdx;
     bool hooksInstalled = false;
 
     //! TODO: нужно добавить структуру отслеживания стека вызовов,
@@ -71,22 +78,36 @@ Probe::Probe(const LaunchType launchType, const std::optional<RecordSettings> &r
     : QObject{ parent }
     , queueTimer_{ new QTimer(this) }
     , launchType_{ launchType }
+    , objectTrackingEnabled_{ launchType != LaunchType::Run || !runSettings.has_value()
+                              || runSettings->pathResolution == PathResolution::Registry }
 {
     Q_ASSERT(thread() == qApp->thread());
 
+    knownObjects_.reserve(INITIAL_KNOWN_OBJECTS_CAPACITY);
+
     queueTimer_->setSingleShot(true);
     queueTimer_->setInterval(0);
     connect(queueTimer_, &QTimer::timeout, this, &Probe::handleObjectsQueue);
 
     inprocessNode_ = new QRemoteObjectNode(this);
-    inprocessNode_->connectToNode(QUrl(paths::REMOTE_OBJECT_PATH));
+    // Адрес задается лаунчером для каждого запуска, чтобы несколько тестируемых приложений
+    // могли работать одновременно. Переменная удаляется, чтобы ее не унаследовали процессы,
+    // запущенные самим приложением
+    auto remoteObjectUrl = qEnvironmentVariable(ENV_REMOTE_OBJECT_URL);
+    qunsetenv(ENV_REMOTE_OBJECT_URL);
+    if (remoteObjectUrl.isEmpty()) {
+        remoteObjectUrl = QString::fromLatin1(paths::REMOTE_OBJECT_PATH);
+    }
+    inprocessNode_->connectToNode(QUrl(remoteObjectUrl));
     inprocessController_.reset(inprocessNode_->acquire<InprocessControllerReplica>());
+    messageBatcher_ = new MessageBatcher(inprocessController_, this);
     connect(inprocessController_.get(), &QRemoteObjectReplica::notified, this, [this] {
         assert(inprocessController_->applicationRunning() == false);
         inprocessController_->pushApplicationRunning(true);
 
 #ifndef DEBUG_RUN
         if (launchType_ == LaunchType::Run) {
+            heartbeatTimer_->start();
             scriptThread_->start();
         }
 #endif
@@ -103,8 +124,8 @@ Probe::Probe(const LaunchType launchType, const std::optional<RecordSettings> &r
         connect(userEventFilter_, &UserEventFilter::newScriptLine, inprocessController_.get(),
                 [this](const QString &msg) { std::cout << qPrintable(msg) << std::endl; });
 #else
-        connect(userEventFilter_, &UserEventFilter::newScriptLine, inprocessController_.get(),
-                &InprocessControllerReplica::sendNewScriptLine);
+        connect(userEventFilter_, &UserEventFilter::newScriptLine, messageBatcher_,
+                &MessageBatcher::addNewScriptLine);
         connect(userVerificationFilter_, &UserVerificationFilter::newFramedRootObjectData,
                 inprocessController_.get(),
                 &InprocessControllerReplica::sendNewFramedRootObjectData);
@@ -128,25 +149,55 @@ Probe::Probe(const LaunchType launchType, const std::optional<RecordSettings> &r
         scriptRunner_ = new ScriptRunner(std::move(*runSettings));
         scriptRunner_->moveToThread(scriptThread_);
 
+        heartbeatTimer_ = new QTimer(this);
+        heartbeatTimer_->setInterval(HEARTBEAT_INTERVAL_MSEC);
+        connect(heartbeatTimer_, &QTimer::timeout, inprocessController_.get(),
+                &InprocessControllerReplica::sendHeartbeat);
+
         connect(this, &Probe::objectCreated, scriptRunner_, &ScriptRunner::registerObjectCreated,
                 Qt::DirectConnection);
         connect(this, &Probe::objectDestroyed, scriptRunner_,
                 &ScriptRunner::registerObjectDestroyed, Qt::DirectConnection);
         connect(this, &Probe::objectReparented, scriptRunner_,
                 &ScriptRunner::registerObjectReparented, Qt::DirectConnection);
-        connect(scriptRunner_, &ScriptRunner::scriptError, inprocessController_.get(),
-                &InprocessControllerReplica::sendScriptRunError);
-        connect(scriptRunner_, &ScriptRunner::scriptWarning, inprocessController_.get(),
-                &InprocessControllerReplica::sendScriptRunWarning);
-        connect(scriptRunner_, &ScriptRunner::scriptLog, inprocessController_.get(),
-                &InprocessControllerReplica::sendScriptRunLog);
-
-        connect(scriptThread_, &QThread::started, scriptRunner_, &ScriptRunner::startScript);
+        connect(this, &Probe::objectRenamed, scriptRunner_, &ScriptRunner::registerObjectRenamed,
+                Qt::DirectConnection);
+        connect(this, &Probe::objectThreadChanged, scriptRunner_,
+                &ScriptRunner::registerObjectThreadChanged, Qt::DirectConnection);
+        connect(scriptRunner_, &ScriptRunner::scriptError, messageBatcher_,
+                &MessageBatcher::addScriptRunError);
+        connect(scriptRunner_, &ScriptRunner::scriptWarning, messageBatcher_,
+                &MessageBatcher::addScriptRunWarning);
+        connect(scriptRunner_, &ScriptRunner::scriptLog, messageBatcher_,
+                &MessageBatcher::addScriptRunLog);
+        if (runSettings->session) {
+            // Следующие скрипты сессии выполняются в том же потоке и с тем же реестром объектов.
+            // Сообщения скрипта должны дойти до лаунчера раньше, чем его результат
+            connect(scriptRunner_, &ScriptRunner::scriptFinished, this, [this](int exitCode) {
+                messageBatcher_->flush();
+                inprocessController_->sendSessionScriptFinished(exitCode);
+            });
+            connect(inprocessController_.get(), &InprocessControllerReplica::sessionScriptRequested,
+                    scriptRunner_, &ScriptRunner::startNextScript);
+            connect(inprocessController_.get(), &InprocessControllerReplica::sessionFinished,
+                    scriptRunner_, &ScriptRunner::finishSession);
+        }
+
+        if (runSettings->deferredStart) {
+            // Приложение запущено заранее и ждет, когда лаунчер передаст ему скрипт
+            connect(inprocessController_.get(), &InprocessControllerReplica::sessionScriptRequested,
+                    scriptRunner_, &ScriptRunner::startNextScript);
+        }
+        else {
+            connect(scriptThread_, &QThread::started, scriptRunner_, &ScriptRunner::startScript);
+        }
         connect(scriptRunner_, &ScriptRunner::aboutToClose, this, [this](int exitCode) {
             assert(scriptThread_ != qApp->thread());
             disconnect(this, &Probe::objectCreated, scriptRunner_, 0);
             disconnect(this, &Probe::objectDestroyed, scriptRunner_, 0);
             disconnect(this, &Probe::objectReparented, scriptRunner_, 0);
+            disconnect(this, &Probe::objectRenamed, scriptRunner_, 0);
+            disconnect(this, &Probe::objectThreadChanged, scriptRunner_, 0);
 
             connect(scriptThread_, &QThread::finished, this, [this, exitCode] {
                 scriptRunner_->deleteLater();
@@ -176,6 +227,18 @@ Probe::Probe(const LaunchType launchType, const std::optional<RecordSettings> &r
 Probe::~Probe() noexcept
 {
     s_probeInstance = QAtomicPointer<Probe>(nullptr);
+
+#ifdef DEBUG_BUILD
+    std::cout << "Internal object checks: " << internalCheckCount_.load()
+              << ", slow path taken: " << internalCheckSlowPathCount_.load() << std::endl;
+#endif
+
+    auto *node = incomingObjects_.exchange(nullptr);
+    while (node != nullptr) {
+        auto *next = node->next;
+        delete node;
+        node = next;
+    }
 }
 
 Probe *Probe::probeInstance() noexcept
@@ -190,6 +253,7 @@ bool Probe::initialized() noexcept
 
 void Probe::smoothKill() noexcept
 {
+    messageBatcher_->flush();
     applicationOnClose_ = true;
     qtHookData[QHooks::AddQObject] = 0;
     qtHookData[QHooks::RemoveQObject] = 0;
@@ -228,12 +292,19 @@ void Probe::initProbe(const LaunchType launchType,
         QMutexLocker lock(s_mutex());
         s_probeInstance = QAtomicPointer<Probe>(probe);
 
-        for (QObject *obj : s_lilProbe->objsAddedBeforeProbeInit) {
-            addObject(obj);
+        if (probe->objectTrackingEnabled_) {
+            for (QObject *obj : s_lilProbe->objsAddedBeforeProbeInit) {
+                if (obj != nullptr) {
+                    addObject(obj);
+                }
+            }
         }
         s_lilProbe->objsAddedBeforeProbeInit.clear();
+        s_lilProbe->objsAddedBeforeProbeInitIdx.clear();
 
-        probe->findObjectsFromCoreApp();
+        if (probe->objectTrackingEnabled_) {
+            probe->findObjectsFromCoreApp();
+        }
     }
 
     QMetaObject::invokeMethod(probe, "installInternalEventFilter", Qt::QueuedConnection);
@@ -277,6 +348,7 @@ void Probe::handleVerificationMode(bool isMode) noexcept
 
 void Probe::handleApplicationFinished(int exitCode) noexcept
 {
+    messageBatcher_->flush();
     inprocessController_->pushApplicationRunning(false);
     QCoreApplication::postEvent(QCoreApplication::instance(), new AsyncCloseEvent(exitCode));
 }
@@ -294,12 +366,38 @@ bool Probe::eventFilter(QObject *reciever, QEvent *event)
         return true;
     }
 
-    if (event->type() == QEvent::ChildAdded || event->type() == QEvent::ChildRemoved) {
+    switch (event->type()) {
+    case QEvent::ChildAdded:
+    case QEvent::ChildRemoved:
+        invalidateInternalVerdict(static_cast<QChildEvent *>(event)->child());
+        break;
+    case QEvent::ParentChange:
+    case QEvent::ThreadChange:
+        invalidateInternalVerdict(reciever);
+        break;
+    default:
+        break;
+    }
+
+    // Событие приходит до переноса объекта, пока его имя еще можно проверять из GUI-потока
+    if (objectTrackingEnabled_ && launchType_ == LaunchType::Run
+        && event->type() == QEvent::ThreadChange && reciever->thread() == thread()) {
+        QMutexLocker lock(s_mutex());
+        if (isKnownObject(reciever) && !isObjectInCreationQueue(reciever)) {
+            trackObjectName(reciever);
+            emit objectThreadChanged(reciever);
+        }
+    }
+
+    if (objectTrackingEnabled_
+        && (event->type() == QEvent::ChildAdded || event->type() == QEvent::ChildRemoved)) {
         QChildEvent *childEvent = static_cast<QChildEvent *>(event);
         QObject *childObj = childEvent->child();
 
         QMutexLocker lock(s_mutex());
-        if (!isIternalObject(childObj) && childEvent->added()) {
+        // При ChildRemoved объект может уже удаляться, поэтому результат для него не
+        // вычисляется и не сохраняется
+        if (childEvent->added() && !isIternalObject(childObj)) {
             if (!isKnownObject(childObj)) {
                 // Ситуация, когда мы узнаем о новом объекте раньше, чем при перехвате хука
                 // QHooks::AddQObject, возникает из-за того, что событие QEvent::ChildAdded
@@ -312,9 +410,7 @@ bool Probe::eventFilter(QObject *reciever, QEvent *event)
                 // Данная ситуация возникает в случае, если мы уже проинициализировали объект
                 // и его нового родителя. Соответственно, нам остается только поменять позицию
                 // этого объекта в дереве элементов
-                reparentedObjects_.erase(
-                    std::remove(reparentedObjects_.begin(), reparentedObjects_.end(), childObj),
-                    reparentedObjects_.end());
+                removeObjectFromReparented(childObj);
                 emit objectReparented(childObj);
             }
             else if (!isKnownObject(childObj->parent())) {
@@ -322,19 +418,17 @@ bool Probe::eventFilter(QObject *reciever, QEvent *event)
                 // родитель, о котором мы до этого ничего не знали. Соответственно, нужно добавить
                 // нового родителя и обновить положение рассматриваемого объекта в дереве
                 addObject(childObj->parent());
-                reparentedObjects_.push_back(childObj);
-                notifyQueueTimer();
+                addObjectToReparented(childObj);
             }
         }
         else if (isKnownObject(childObj)) {
             // Пока не можем понять конечное положение объекта в дереве - "откладываем его"
-            reparentedObjects_.push_back(childObj);
-            notifyQueueTimer();
+            addObjectToReparented(childObj);
         }
     }
 
     // Работает только для QWidgets
-    if (event->type() == QEvent::ParentChange) {
+    if (objectTrackingEnabled_ && event->type() == QEvent::ParentChange) {
         QMutexLocker lock(s_mutex());
         if (!isIternalObject(reciever) && isKnownObject(reciever)
             && isKnownObject(reciever->parent()) && !isObjectInCreationQueue(reciever)
@@ -342,9 +436,7 @@ bool Probe::eventFilter(QObject *reciever, QEvent *event)
             // Данная ситуация возникает в случае, если мы уже проинициализировали объект
             // и его нового родителя. Соответственно, нам остается только поменять позицию
             // этого объекта в дереве элементов
-            reparentedObjects_.erase(
-                std::remove(reparentedObjects_.begin(), reparentedObjects_.end(), reciever),
-                reparentedObjects_.end());
+            removeObjectFromReparented(reciever);
             emit objectReparented(reciever);
         }
         else if (!isKnownObject(reciever->parent())) {
@@ -352,8 +444,7 @@ bool Probe::eventFilter(QObject *reciever, QEvent *event)
             // о котором мы до этого ничего не знали. Соответственно, нужно добавить нового родителя
             // и обновить положение рассматриваемого объекта в дереве
             addObject(reciever->parent());
-            reparentedObjects_.push_back(reciever);
-            notifyQueueTimer();
+            addObjectToReparented(reciever);
         }
     }
 
@@ -363,7 +454,7 @@ bool Probe::eventFilter(QObject *reciever, QEvent *event)
      * ситуация теоретически не может быть, однако это может быть полезно в будущем при
      * написании unit-тестов.
      */
-    if (!s_lilProbe()->hooksInstalled
+    if (objectTrackingEnabled_ && !s_lilProbe()->hooksInstalled
         // Уже обработанные события
         && event->type() != QEvent::ChildAdded && event->type() != QEvent::ChildRemoved
         && event->type() != QEvent::ParentChange
@@ -436,7 +527,10 @@ void Probe::addObject(QObject *obj) noexcept
     //! TODO: StackTrace
 
     if (!initialized()) {
-        s_lilProbe->objsAddedBeforeProbeInit.push_back(obj);
+        auto &beforeObjects = s_lilProbe->objsAddedBeforeProbeInit;
+        if (s_lilProbe->objsAddedBeforeProbeInitIdx.emplace(obj, beforeObjects.size()).second) {
+            beforeObjects.push_back(obj);
+        }
         return;
     }
 
@@ -464,35 +558,253 @@ void Probe::addObject(QObject *obj) noexcept
     probeInstance()->addObjectCreationToQueue(obj);
 }
 
+void Probe::addObjectFromHook(QObject *obj) noexcept
+{
+    auto *probe = probeInstance();
+    if (probe == nullptr) {
+        addObject(obj);
+        return;
+    }
+    if (!probe->objectTrackingEnabled_) {
+        return;
+    }
+
+    if (QThread::currentThread() != probe->thread()) {
+        // Состояние ProbeGuard хранится для каждого потока отдельно, поэтому проверяем его
+        // до передачи объекта в GUI-поток
+        if (ProbeGuard::locked() && obj->thread() == QThread::currentThread()) {
+            return;
+        }
+        probe->pushIncomingObject(obj, QueuedObject::Create);
+        return;
+    }
+
+    QMutexLocker lock(s_mutex());
+    probe->drainIncomingObjects();
+    addObject(obj);
+}
+
+void Probe::removeObjectFromHook(QObject *obj) noexcept
+{
+    auto *probe = probeInstance();
+    if (probe == nullptr) {
+        removeObject(obj);
+        return;
+    }
+    if (!probe->objectTrackingEnabled_) {
+        return;
+    }
+
+    if (QThread::currentThread() != probe->thread()) {
+        // Память объекта будет освобождена сразу после выхода из хука, поэтому дожидаемся,
+        // пока GUI-поток закончит обращаться к нему (если обращается), и помечаем объект
+        // удаленным до того, как уведомление об удалении попадет в стек
+        {
+            QMutexLocker lock(&probe->foreignObjectsMutex_);
+            probe->destroyedForeignObjects_.insert(obj);
+        }
+        probe->pushIncomingObject(obj, QueuedObject::Destroy);
+        return;
+    }
+
+    QMutexLocker lock(s_mutex());
+    probe->drainIncomingObjects();
+    removeObject(obj);
+    // Результат удаляется последним: обработчики удаления могли снова его сохранить
+    probe->internalObjects_.erase(obj);
+}
+
+void Probe::pushIncomingObject(QObject *obj, QueuedObject::Type type) noexcept
+{
+    auto *node = new IncomingObject{ obj, type, incomingObjects_.load() };
+    while (!incomingObjects_.compare_exchange_weak(node->next, node)) {
+    }
+
+    if (!incomingDrainScheduled_.exchange(true)) {
+        notifyQueueTimer();
+    }
+}
+
+void Probe::drainIncomingObjects() noexcept
+{
+    assert(thread() == QThread::currentThread());
+    if (incomingObjects_.load() == nullptr) {
+        return;
+    }
+    processIncomingObjects();
+}
+
+bool Probe::isDestroyedForeignObject(const QObject *obj) const noexcept
+{
+    return destroyedForeignObjects_.find(obj) != destroyedForeignObjects_.end();
+}
+
+void Probe::processIncomingObjects() noexcept
+{
+    std::vector<IncomingObject *> batch;
+    for (auto *node = incomingObjects_.exchange(nullptr); node != nullptr; node = node->next) {
+        batch.push_back(node);
+    }
+    std::reverse(batch.begin(), batch.end());
+
+    // Объекты, которые были созданы и удалены до начала обработки, уже недоступны,
+    // поэтому пропускаем и их создание, и их удаление
+    std::unordered_map<const QObject *, size_t> pendingCreations;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto *node = batch[i];
+        if (node->type == QueuedObject::Create) {
+            pendingCreations[node->obj] = i;
+            continue;
+        }
+        const auto it = pendingCreations.find(node->obj);
+        if (it != pendingCreations.end()) {
+            QMutexLocker lock(&foreignObjectsMutex_);
+            destroyedForeignObjects_.erase(node->obj);
+            batch[it->second]->obj = nullptr;
+            node->obj = nullptr;
+            pendingCreations.erase(it);
+        }
+    }
+
+    for (auto *node : batch) {
+        if (node->obj != nullptr) {
+            switch (node->type) {
+            case QueuedObject::Create: {
+                // Объект мог быть удален уже после того, как стек был забран
+                QMutexLocker lock(&foreignObjectsMutex_);
+                if (!isDestroyedForeignObject(node->obj)) {
+                    postForeignObject(node->obj);
+                }
+                break;
+            }
+            case QueuedObject::Destroy: {
+                removeObject(node->obj);
+                // Запись удаляется только после того, как объект исключен из всех очередей
+                QMutexLocker lock(&foreignObjectsMutex_);
+                destroyedForeignObjects_.erase(node->obj);
+                break;
+            }
+            default:
+                Q_UNREACHABLE();
+            }
+        }
+        delete node;
+    }
+}
+
+void Probe::postForeignObject(QObject *obj) noexcept
+{
+    // Вызов выполнится в цикле событий потока объекта, а если объект будет удален раньше,
+    // то Qt отбросит его вместе с остальными событиями объекта. Объекты потоков без цикла
+    // событий поэтому не отслеживаются
+    QMetaObject::invokeMethod(obj, [obj] { addForeignObject(obj); }, Qt::QueuedConnection);
+}
+
+/*
+ * Объект другого потока читается только в его собственном потоке, где он уже полностью
+ * сконструирован. Его предки находятся в том же потоке, поэтому и проверка на "внутренний"
+ * объект, и регистрация пути (ScriptRunner подключен напрямую) выполняются здесь же, а
+ * s_mutex упорядочивает их с обработкой в GUI-потоке.
+ */
+void Probe::addForeignObject(QObject *obj) noexcept
+{
+    auto *probe = probeInstance();
+    if (probe == nullptr || probe->applicationOnClose_) {
+        return;
+    }
+    assert(obj->thread() == QThread::currentThread());
+
+    QMutexLocker lock(s_mutex());
+    if (probe->isKnownObject(obj) || probe->isIternalObject(obj)) {
+        return;
+    }
+    // Неизвестные предки попадают в индекс путей вместе с объектом
+    for (QObject *o = obj; o != nullptr && !probe->isKnownObject(o); o = o->parent()) {
+        probe->knownObjects_.insert(o);
+        if (probe->launchType_ == LaunchType::Run) {
+            probe->trackObjectName(o);
+        }
+    }
+    emit probe->objectCreated(obj);
+}
+
 bool Probe::isStrangeClass(QObject *obj) const noexcept
 {
     return qstrcmp(obj->metaObject()->className(), STRANGE_CLASS) == 0;
 }
 
+bool Probe::isIternalObjectItself(QObject *obj) const noexcept
+{
+    return obj == this || obj == inprocessController()
+           || qstrncmp(obj->metaObject()->className(), QTADA_NAMESPACE, QTADA_NAMESPACE_LEN) == 0;
+}
+
 bool Probe::isIternalObject(QObject *obj) const noexcept
 {
+    internalCheckCount_.fetch_add(1, std::memory_order_relaxed);
+
+    // Кеш используется только в GUI-потоке и только для его объектов: родители объекта
+    // всегда находятся в том же потоке, что и он сам, поэтому вся цепочка предков
+    // изменяется только из GUI-потока
+    const bool canUseCache = QThread::currentThread() == thread() && obj->thread() == thread();
+    if (canUseCache) {
+        const auto it = internalObjects_.find(obj);
+        if (it != internalObjects_.end()) {
+            return it->second;
+        }
+    }
+    internalCheckSlowPathCount_.fetch_add(1, std::memory_order_relaxed);
+
+    // Поднимаемся до первого предка с уже известным результатом (или до корня),
+    // после чего сохраняем результат для всей пройденной цепочки
+    std::vector<const QObject *> chain;
     std::set<QObject *> checkedObjects;
+    bool isInternal = false;
     int iteration = 0;
-    QObject *o = obj;
-    do {
+    for (QObject *o = obj; o != nullptr; o = o->parent()) {
         if (iteration > LOOP_DETECTION_COUNT) {
             // Возможно закицливание в дереве, поэтому если мы уже проверяли
             // текущий объект, то считаем, что он создан QtAda
-            if (checkedObjects.find(obj) != checkedObjects.end()) {
+            if (checkedObjects.find(o) != checkedObjects.end()) {
                 return true;
             }
             checkedObjects.insert(o);
         }
         ++iteration;
 
-        if (o == this || o == inprocessController()
-            || (qstrncmp(o->metaObject()->className(), QTADA_NAMESPACE, QTADA_NAMESPACE_LEN)
-                == 0)) {
-            return true;
+        if (canUseCache) {
+            const auto it = internalObjects_.find(o);
+            if (it != internalObjects_.end()) {
+                isInternal = it->second;
+                break;
+            }
+            chain.push_back(o);
         }
-        o = o->parent();
-    } while (o);
-    return false;
+        if (isIternalObjectItself(o)) {
+            isInternal = true;
+            break;
+        }
+    }
+
+    for (const auto *o : chain) {
+        internalObjects_[o] = isInternal;
+    }
+    return isInternal;
+}
+
+void Probe::invalidateInternalVerdict(QObject *obj) noexcept
+{
+    if (obj == nullptr || QThread::currentThread() != thread()) {
+        return;
+    }
+    // Если для объекта нет сохраненного результата, то его нет и для всех его потомков,
+    // так как результат сохраняется для всей цепочки предков сразу
+    if (internalObjects_.erase(obj) == 0) {
+        return;
+    }
+    for (auto *child : obj->children()) {
+        invalidateInternalVerdict(child);
+    }
 }
 
 bool Probe::isKnownObject(QObject *obj) const noexcept
@@ -509,9 +821,12 @@ void Probe::removeObject(QObject *obj) noexcept
             return;
         }
 
-        auto &beforeObjects = s_lilProbe()->objsAddedBeforeProbeInit;
-        auto eraseStart = std::remove(beforeObjects.begin(), beforeObjects.end(), obj);
-        beforeObjects.erase(eraseStart, beforeObjects.end());
+        auto &beforeObjectsIdx = s_lilProbe()->objsAddedBeforeProbeInitIdx;
+        const auto it = beforeObjectsIdx.find(obj);
+        if (it != beforeObjectsIdx.end()) {
+            s_lilProbe()->objsAddedBeforeProbeInit[it->second] = nullptr;
+            beforeObjectsIdx.erase(it);
+        }
         return;
     }
 
@@ -539,6 +854,7 @@ void Probe::addObjectCreationToQueue(QObject *obj) noexcept
 {
     assert(!isObjectInCreationQueue(obj));
 
+    creationQueueIndex_.emplace(obj, queuedObjects_.size());
     queuedObjects_.push_back({ obj, QueuedObject::Create });
     notifyQueueTimer();
 }
@@ -551,22 +867,32 @@ void Probe::addObjectDestroyToQueue(QObject *obj) noexcept
 
 void Probe::removeObjectCreationFromQueue(QObject *obj) noexcept
 {
-    auto it = std::find_if(queuedObjects_.begin(), queuedObjects_.end(),
-                           [obj](const QueuedObject &qObj) {
-                               return qObj.obj == obj && qObj.type == QueuedObject::Create;
-                           });
-    if (it != queuedObjects_.end()) {
-        queuedObjects_.erase(it);
+    const auto it = creationQueueIndex_.find(obj);
+    if (it == creationQueueIndex_.end()) {
+        return;
     }
+    auto &queuedObject = queuedObjects_[it->second];
+    assert(queuedObject.obj == obj && queuedObject.type == QueuedObject::Create);
+    queuedObject.obj = nullptr;
+    creationQueueIndex_.erase(it);
 }
 
 bool Probe::isObjectInCreationQueue(QObject *obj) const noexcept
 {
-    auto it = std::find_if(queuedObjects_.begin(), queuedObjects_.end(),
-                           [obj](const QueuedObject &qObj) {
-                               return qObj.obj == obj && qObj.type == QueuedObject::Create;
-                           });
-    return it != queuedObjects_.end();
+    return creationQueueIndex_.find(obj) != creationQueueIndex_.end();
+}
+
+void Probe::addObjectToReparented(QObject *obj) noexcept
+{
+    if (reparentedSet_.insert(obj).second) {
+        reparentedObjects_.push_back(obj);
+    }
+    notifyQueueTimer();
+}
+
+void Probe::removeObjectFromReparented(QObject *obj) noexcept
+{
+    reparentedSet_.erase(obj);
 }
 
 void Probe::notifyQueueTimer() noexcept
@@ -603,12 +929,35 @@ void Probe::handleObjectsQueue() noexcept
     QMutexLocker lock(s_mutex());
     assert(thread() == QThread::currentThread());
 
-    const auto queuedObjects = queuedObjects_;
+    incomingDrainScheduled_.store(false);
+    processIncomingObjects();
+
+    // Объекты, добавленные в очередь во время ее обработки, будут обработаны на следующей
+    // итерации. Объекты из очереди могут принадлежать другим потокам, поэтому обращение к
+    // каждому из них защищено foreignObjectsMutex_
+    std::vector<QueuedObject> queuedObjects;
+    queuedObjects.swap(queuedObjects_);
+    creationQueueIndex_.clear();
     for (const auto &o : queuedObjects) {
+        if (o.obj == nullptr) {
+            continue;
+        }
         switch (o.type) {
-        case QueuedObject::Create:
-            explicitObjectCreation(o.obj);
+        case QueuedObject::Create: {
+            QMutexLocker foreignLock(&foreignObjectsMutex_);
+            if (isDestroyedForeignObject(o.obj)) {
+                break;
+            }
+            // Объект, созданный в GUI-потоке, мог быть перемещен в другой поток
+            if (o.obj->thread() != thread()) {
+                knownObjects_.erase(o.obj);
+                postForeignObject(o.obj);
+            }
+            else {
+                explicitObjectCreation(o.obj);
+            }
             break;
+        }
         case QueuedObject::Destroy:
             emit objectDestroyed(o.obj);
             break;
@@ -616,21 +965,53 @@ void Probe::handleObjectsQueue() noexcept
             Q_UNREACHABLE();
         }
     }
-    queuedObjects_.clear();
 
-    const auto reparentedObjects = reparentedObjects_;
-    for (QObject *obj : reparentedObjects_) {
-        if (!isKnownObject(obj)) {
+    std::vector<QObject *> reparentedObjects;
+    reparentedObjects.swap(reparentedObjects_);
+    for (QObject *obj : reparentedObjects) {
+        if (reparentedSet_.erase(obj) == 0 || !isKnownObject(obj)) {
+            continue;
+        }
+        QMutexLocker foreignLock(&foreignObjectsMutex_);
+        if (isDestroyedForeignObject(obj)) {
             continue;
         }
         if (isIternalObject(obj)) {
+            // Объект может снова стать "внешним" и будет подключен заново
+            disconnect(obj, &QObject::objectNameChanged, this, nullptr);
             removeObject(obj);
         }
         else {
             emit objectReparented(obj);
         }
     }
-    reparentedObjects_.clear();
+}
+
+void Probe::handleObjectNameChanged(QObject *obj) noexcept
+{
+    if (applicationOnClose_) {
+        return;
+    }
+
+    if (QThread::currentThread() != thread()) {
+        // Объект другого потока читается только в его потоке, поэтому и новый путь
+        // регистрируется здесь же, пока объект жив
+        QMutexLocker lock(s_mutex());
+        handleObjectRenamed(obj);
+        return;
+    }
+
+    QMutexLocker lock(s_mutex());
+    drainIncomingObjects();
+    handleObjectRenamed(obj);
+}
+
+void Probe::handleObjectRenamed(QObject *obj) noexcept
+{
+    // Если объект еще в очереди создания, то он будет зарегистрирован уже с новым именем
+    if (isKnownObject(obj) && !isObjectInCreationQueue(obj)) {
+        emit objectRenamed(obj);
+    }
 }
 
 void Probe::explicitObjectCreation(QObject *obj) noexcept
@@ -655,6 +1036,19 @@ void Probe::explicitObjectCreation(QObject *obj) noexcept
     }
     assert(!obj->parent() || isKnownObject(obj->parent()));
 
+    // Имена объектов GUI-потока проверяются перед поиском объектов (см.
+    // ObjectPathIndex::refreshNames), а объекты других потоков обрабатываются в
+    // addForeignObject
     emit objectCreated(obj);
 }
+
+void Probe::trackObjectName(QObject *obj) noexcept
+{
+    // Путь объекта зависит от его имени, а глобального хука для objectName в Qt нет, поэтому
+    // подключаемся к самому объекту, но без очереди событий: обработчик выполняется в потоке
+    // переименования, пока объект жив
+    connect(
+        obj, &QObject::objectNameChanged, this, [this, obj] { handleObjectNameChanged(obj); },
+        Qt::DirectConnection);
+}
 } // namespace QtAda::core
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <QObject>
+#include <QRecursiveMutex>
 #include <vector>
-#include <set>
+#include <unordered_set>
+#include <unordered_map>
 #include <memory>
+#include <atomic>
 
 #include "Settings.hpp"
 
@@ -17,6 +20,7 @@ namespace QtAda::core {
 class UserEventFilter;
 class UserVerificationFilter;
 class ScriptRunner;
+class MessageBatcher;
 
 class Probe final : public QObject {
     Q_OBJECT
@@ -36,6 +40,8 @@ public:
     static void startup() noexcept;
     static void addObject(QObject *obj) noexcept;
     static void removeObject(QObject *obj) noexcept;
+    static void addObjectFromHook(QObject *obj) noexcept;
+    static void removeObjectFromHook(QObject *obj) noexcept;
 
     bool isKnownObject(QObject *obj) const noexcept;
 
@@ -45,6 +51,11 @@ signals:
     void objectCreated(QObject *obj);
     void objectDestroyed(QObject *obj);
     void objectReparented(QObject *obj);
+    // Для объектов других потоков objectCreated и objectRenamed испускаются в потоке объекта
+    // (под тем же мьютексом, что и в GUI-потоке), так как читать объект можно только там
+    void objectRenamed(QObject *obj);
+    // Объект GUI-потока переносится в другой поток (испускается до переноса)
+    void objectThreadChanged(QObject *obj);
 
 private slots:
     void installInternalEventFilter() noexcept;
@@ -64,6 +75,7 @@ private:
 
     QRemoteObjectNode *inprocessNode_ = nullptr;
     std::shared_ptr<InprocessControllerReplica> inprocessController_ = nullptr;
+    MessageBatcher *messageBatcher_ = nullptr;
 
     UserEventFilter *userEventFilter_ = nullptr;
     UserVerificationFilter *userVerificationFilter_ = nullptr;
@@ -72,8 +84,14 @@ private:
 
     ScriptRunner *scriptRunner_ = nullptr;
     QThread *scriptThread_ = nullptr;
+    // Таймер работает в GUI-потоке, поэтому при его зависании лаунчер перестает получать
+    // сигналы и закрывает приложение
+    QTimer *heartbeatTimer_ = nullptr;
 
     const LaunchType launchType_;
+    // В режиме PathResolution::OnDemand объекты ищутся только по запросу скрипта, поэтому
+    // отслеживать создание, удаление и перемещение объектов не нужно
+    const bool objectTrackingEnabled_;
 
     // Очень важно, что построение дерева объектов должно происходить
     // в одном потоке из экземпляров, которые мы сохраняем в knownObjects_
@@ -87,9 +105,44 @@ private:
         {
         }
     };
+    // Удаление объекта из очереди создания заменяет его запись на "пустую" (obj == nullptr),
+    // а позиции ожидающих создания объектов хранятся в creationQueueIndex_, поэтому и проверка
+    // наличия объекта в очереди, и удаление из нее выполняются за O(1)
     std::vector<QueuedObject> queuedObjects_;
-    std::set<const QObject *> knownObjects_;
+    std::unordered_map<const QObject *, size_t> creationQueueIndex_;
+    std::unordered_set<const QObject *> knownObjects_;
+    // Порядок обработки сохраняется в reparentedObjects_, а reparentedSet_ определяет,
+    // какие из записей все еще актуальны
     std::vector<QObject *> reparentedObjects_;
+    std::unordered_set<const QObject *> reparentedSet_;
+
+    // Объекты, созданные и удаленные вне GUI-потока. Хуки добавляют их в стек без блокировок,
+    // а GUI-поток забирает весь стек целиком и обрабатывает его в порядке добавления. Сами
+    // объекты GUI-поток не читает: созданные объекты передаются обратно в их поток (см.
+    // addForeignObject), а для удаленных достаточно данных реестра.
+    struct IncomingObject {
+        QObject *obj;
+        QueuedObject::Type type;
+        IncomingObject *next;
+    };
+    std::atomic<IncomingObject *> incomingObjects_ = nullptr;
+    std::atomic<bool> incomingDrainScheduled_ = false;
+    /*
+     * GUI-поток обращается к объекту (проверяет его поток, передает его в поток объекта) только
+     * под этим мьютексом и только если объекта нет в destroyedForeignObjects_, а хук удаления
+     * в другом потоке добавляет объект в destroyedForeignObjects_ под этим же мьютексом. Поэтому
+     * хук ждет только окончания обработки одного объекта, а не всей очереди. Запись удаляется,
+     * когда GUI-поток обработает удаление объекта.
+     */
+    mutable QRecursiveMutex foreignObjectsMutex_;
+    std::unordered_set<const QObject *> destroyedForeignObjects_;
+
+    bool isDestroyedForeignObject(const QObject *obj) const noexcept;
+    void pushIncomingObject(QObject *obj, QueuedObject::Type type) noexcept;
+    void drainIncomingObjects() noexcept;
+    void processIncomingObjects() noexcept;
+    void postForeignObject(QObject *obj) noexcept;
+    static void addForeignObject(QObject *obj) noexcept;
 
     void addObjectAndParentsToKnown(QObject *obj) noexcept;
     void findObjectsFromCoreApp() noexcept;
@@ -98,10 +151,23 @@ private:
     void addObjectDestroyToQueue(QObject *obj) noexcept;
     void removeObjectCreationFromQueue(QObject *obj) noexcept;
     bool isObjectInCreationQueue(QObject *obj) const noexcept;
+    void addObjectToReparented(QObject *obj) noexcept;
+    void removeObjectFromReparented(QObject *obj) noexcept;
     void explicitObjectCreation(QObject *obj) noexcept;
+    void handleObjectNameChanged(QObject *obj) noexcept;
+    void handleObjectRenamed(QObject *obj) noexcept;
+    void trackObjectName(QObject *obj) noexcept;
     void notifyQueueTimer() noexcept;
 
+    // Результат проверки isIternalObject для объектов GUI-потока. Используется только из
+    // GUI-потока и сбрасывается для всего поддерева объекта при смене его родителя
+    mutable std::unordered_map<const QObject *, bool> internalObjects_;
+    mutable std::atomic<uint64_t> internalCheckCount_ = 0;
+    mutable std::atomic<uint64_t> internalCheckSlowPathCount_ = 0;
+
     bool isIternalObject(QObject *obj) const noexcept;
+    bool isIternalObjectItself(QObject *obj) const noexcept;
+    void invalidateInternalVerdict(QObject *obj) noexcept;
     bool isStrangeClass(QObject *obj) const noexcept;
 
     const QObject *inprocessController() const noexcept;
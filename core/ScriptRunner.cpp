@@ -2,27 +2,30 @@
 
 #include <QCoreApplication>
 #include <QGuiApplication>
+#include <QApplication>
+#include <QWindow>
 #include <QThread>
 #include <QElapsedTimer>
 #include <QFile>
 #include <QTextStream>
 #include <QJSEngine>
-#include <QQmlProperty>
+#include <QJSValueIterator>
 #include <QDateTime>
 #include <QModelIndex>
 #include <QAbstractItemView>
 #include <QAbstractItemModel>
 #include <QLineEdit>
-#include <QFuture>
-#include <QTimer>
-#include <QtConcurrent>
+#include <QSemaphore>
 #include <QQmlEngine>
+#include <QScopeGuard>
+#include <algorithm>
 
 #include "utils/FilterUtils.hpp"
 #include "utils/Tools.hpp"
 
 namespace QtAda::core {
 static constexpr int INVOKE_TIMEOUT_SEC = 3;
+static constexpr int VISIBILITY_CHECK_INTERVAL_MSEC = 10;
 
 static QMouseEvent *simpleMouseEvent(const QEvent::Type type, const QPoint &pos,
                                      const Qt::MouseButton button = Qt::LeftButton) noexcept
@@ -30,31 +33,105 @@ static QMouseEvent *simpleMouseEvent(const QEvent::Type type, const QPoint &pos,
     return new QMouseEvent(type, pos, button, button, Qt::NoModifier);
 }
 
-static std::vector<std::pair<QVariant, QVariant>> parseSelectionData(const QJSValue &selectionData,
-                                                                     bool &isOk, int rowCount,
-                                                                     int columnCount,
-                                                                     QJSEngine *engine)
+static QPoint itemCenter(const QObject *object) noexcept
+{
+    const auto height = utils::getFromVariant<double>(tools::readProperty(object, "height"));
+    const auto width = utils::getFromVariant<double>(tools::readProperty(object, "width"));
+    return QPoint(width / 2, height / 2);
+}
+
+static bool isNumberVariant(const QVariant &value) noexcept
+{
+    switch (value.userType()) {
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static QString readScript(const QString &scriptPath) noexcept
+{
+    QFile script(scriptPath);
+    assert(script.exists());
+
+    const auto opened = script.open(QIODevice::ReadOnly);
+    assert(opened == true);
+
+    QTextStream stream(&script);
+    return stream.readAll();
+}
+
+// Видимые окна верхнего уровня: для QtWidgets - сами виджеты, для остальных - QWindow
+static QObjectList topLevelWindows() noexcept
+{
+    QObjectList windows;
+    if (QCoreApplication::instance()->inherits("QApplication")) {
+        for (auto *widget : QApplication::topLevelWidgets()) {
+            if (widget->isVisible()) {
+                windows.push_back(widget);
+            }
+        }
+    }
+    for (auto *window : QGuiApplication::topLevelWindows()) {
+        if (window->isVisible() && !window->inherits("QWidgetWindow")) {
+            windows.push_back(window);
+        }
+    }
+    return windows;
+}
+
+static void closeSecondaryWindows(const std::vector<QPointer<QObject>> &mainWindows,
+                                  GuiCommandContext &context) noexcept
+{
+    for (auto *window : topLevelWindows()) {
+        const auto isMain
+            = std::any_of(mainWindows.begin(), mainWindows.end(),
+                          [window](const auto &mainWindow) { return mainWindow == window; });
+        if (isMain) {
+            continue;
+        }
+        // Как и в closeWindow, QCloseEvent для виджетов не всегда срабатывает
+        if (window->isWidgetType()) {
+            context.invoke(window, "close");
+        }
+        else {
+            context.postEvents(window, { new QCloseEvent() });
+        }
+    }
+}
+
+/*
+ * Данные выделения разбираются в GUI-потоке (нужны размеры модели), поэтому вместо QJSValue
+ * принимается результат QJSValue::toVariant(): массивы становятся QVariantList, а объекты -
+ * QVariantMap.
+ */
+static std::vector<std::pair<QVariant, QVariant>>
+parseSelectionData(const QVariant &selectionData, int rowCount, int columnCount,
+                   GuiCommandContext &context)
 {
     std::vector<std::pair<QVariant, QVariant>> parsedData;
 
-    if (!selectionData.isArray()) {
-        isOk = false;
-        engine->throwError(QStringLiteral("Passed selection data is not an array"));
+    if (selectionData.userType() != QMetaType::QVariantList) {
+        context.fail(QStringLiteral("Passed selection data is not an array"));
         return parsedData;
     }
 
-    const auto length = selectionData.property("length").toInt();
-    if (length == 0) {
-        isOk = false;
-        engine->throwError(QStringLiteral("Passed selection data is empty"));
+    const auto entries = selectionData.toList();
+    if (entries.isEmpty()) {
+        context.fail(QStringLiteral("Passed selection data is empty"));
         return parsedData;
     }
 
-    for (int i = 0; i < length; i++) {
-        const auto entry = selectionData.property(i);
+    for (const auto &rawEntry : entries) {
+        const auto entry = rawEntry.toMap();
         QVariant rowVar, columnVar;
-        const auto rowValue = entry.property("row").toString();
-        const auto columnRawValue = entry.property("column");
+        const auto rowValue = entry.value(QStringLiteral("row")).toString();
+        const auto columnRawValue = entry.value(QStringLiteral("column"));
 
         if (rowValue == "ALL") {
             rowVar = true;
@@ -63,51 +140,40 @@ static std::vector<std::pair<QVariant, QVariant>> parseSelectionData(const QJSVa
             bool ok;
             const auto row = rowValue.toInt(&ok);
             if (!ok) {
-                isOk = false;
-                engine->throwError(QStringLiteral("Passed selection data is invalid"));
+                context.fail(QStringLiteral("Passed selection data is invalid"));
                 return parsedData;
             }
             else if (row < 0 || row >= rowCount) {
-                isOk = false;
-                engine->throwError(
-                    QStringLiteral("Passed row index '%1' is out of row range [0, %2)")
-                        .arg(row)
-                        .arg(rowCount));
+                context.fail(QStringLiteral("Passed row index '%1' is out of row range [0, %2)")
+                                 .arg(row)
+                                 .arg(rowCount));
                 return parsedData;
             }
             rowVar = row;
         }
 
+        const auto isColumnArray = columnRawValue.userType() == QMetaType::QVariantList;
         if (columnRawValue.toString() == "ALL") {
             columnVar = true;
         }
-        else if (columnRawValue.isArray() || columnRawValue.isNumber()) {
-            const auto isSingleDigit = columnRawValue.isNumber();
-            QList<int> columns;
-            const auto columnLength = isSingleDigit ? 1 : columnRawValue.property("length").toInt();
-            if (columnLength == 0) {
-                isOk = false;
-                engine->throwError(QStringLiteral("Passed selection data is invalid"));
+        else if (isColumnArray || isNumberVariant(columnRawValue)) {
+            const auto rawColumns
+                = isColumnArray ? columnRawValue.toList() : QVariantList{ columnRawValue };
+            if (rawColumns.isEmpty()) {
+                context.fail(QStringLiteral("Passed selection data is invalid"));
                 return parsedData;
             }
 
-            for (int j = 0; j < columnLength; j++) {
+            QList<int> columns;
+            for (const auto &rawColumn : rawColumns) {
                 bool ok;
-                int column = -1;
-                if (isSingleDigit) {
-                    column = columnRawValue.toString().toInt(&ok);
-                }
-                else {
-                    column = columnRawValue.property(j).toString().toInt(&ok);
-                }
+                const auto column = rawColumn.toString().toInt(&ok);
                 if (!ok) {
-                    isOk = false;
-                    engine->throwError(QStringLiteral("Passed selection data is invalid"));
+                    context.fail(QStringLiteral("Passed selection data is invalid"));
                     return parsedData;
                 }
                 else if (column < 0 || column >= columnCount) {
-                    isOk = false;
-                    engine->throwError(
+                    context.fail(
                         QStringLiteral("Passed column index '%1' is out of column range [0, %2)")
                             .arg(column)
                             .arg(columnCount));
@@ -118,8 +184,7 @@ static std::vector<std::pair<QVariant, QVariant>> parseSelectionData(const QJSVa
             columnVar = QVariant::fromValue(columns);
         }
         else {
-            isOk = false;
-            engine->throwError(QStringLiteral("Passed selection data is invalid"));
+            context.fail(QStringLiteral("Passed selection data is invalid"));
             return parsedData;
         }
         parsedData.push_back(std::make_pair(rowVar, columnVar));
@@ -127,183 +192,343 @@ static std::vector<std::pair<QVariant, QVariant>> parseSelectionData(const QJSVa
     return parsedData;
 }
 
+PropertyNotifyWatcher *PropertyNotifyWatcher::watch(QObject *object,
+                                                    const QMetaProperty &property,
+                                                    std::shared_ptr<QSemaphore> semaphore) noexcept
+{
+    assert(object != nullptr);
+    assert(semaphore != nullptr);
+    if (!property.hasNotifySignal()) {
+        return nullptr;
+    }
+
+    auto *watcher = new PropertyNotifyWatcher(std::move(semaphore));
+    const auto *watcherMetaObject = watcher->metaObject();
+    const auto slot
+        = watcherMetaObject->method(watcherMetaObject->indexOfSlot("handlePropertyChanged()"));
+    assert(slot.isValid());
+
+    // Сигнал испускается в GUI-потоке, а поток скрипта в это время заблокирован ожиданием,
+    // поэтому используем Qt::DirectConnection: слот только освобождает семафор
+    watcher->connection_
+        = QObject::connect(object, property.notifySignal(), watcher, slot, Qt::DirectConnection);
+    if (!watcher->connection_) {
+        delete watcher;
+        return nullptr;
+    }
+    // Удаление наблюдателя должно происходить в том же потоке, где испускается сигнал,
+    // чтобы не удалить его во время выполнения слота
+    watcher->moveToThread(object->thread());
+    return watcher;
+}
+
+void PropertyNotifyWatcher::release() noexcept
+{
+    QObject::disconnect(connection_);
+    deleteLater();
+}
+
 ScriptRunner::ScriptRunner(const RunSettings &settings, QObject *parent) noexcept
     : QObject{ parent }
     , runSettings_{ settings }
+    , scriptPath_{ settings.scriptPath }
+    , isLastScript_{ settings.sessionLastScript }
 {
 }
 
 //! TODO: большая проблема возникает из-за объектов графической оболочки -
-//! мы не можем проверять уникальность данных в pathToObject_ и objectToPath_,
+//! мы не можем проверять уникальность данных в registry_,
 //! так как такие объекты могут быть разными указателями, но с одинаковыми путями.
 
-//! TODO: Для QtWidgets используется статический метод QQmlProperty::read/write,
-//! причем название класса говорит о том, что по идее он предназначен для QML,
-//! тем не менее он прекрасно работает и избавляет от нудных операций по типу:
-//!     const QMetaObject* metaObject = object->metaObject();
-//!     int propertyIndex = metaObject->indexOfProperty("....");
-//!     QMetaProperty metaProperty = metaObject->property(propertyIndex);
-//!     QVariant variant = metaProperty.read(object);
-//!     ....
-//! Но тем не менее нужно удостоверится, что все точно работает как надо.
-
 void ScriptRunner::registerObjectCreated(QObject *obj) noexcept
 {
-    const auto path = utils::objectPath(obj);
-    pathToObject_[path] = obj;
-    objectToPath_[obj] = path;
+    QMutexLocker locker(&pathIndexMutex_);
+    applyPathChanges(pathIndex_.add(obj));
 }
 
 void ScriptRunner::registerObjectDestroyed(QObject *obj) noexcept
 {
-    const auto it = objectToPath_.find(obj);
-    if (it == objectToPath_.end()) {
-        return;
-    }
-
-    const auto path = it->second;
-    pathToObject_.erase(path);
-    objectToPath_.erase(it);
+    QMutexLocker locker(&pathIndexMutex_);
+    applyPathChanges(pathIndex_.remove(obj));
 }
 
 void ScriptRunner::registerObjectReparented(QObject *obj) noexcept
 {
-    const auto newPath = utils::objectPath(obj);
+    QMutexLocker locker(&pathIndexMutex_);
+    applyPathChanges(pathIndex_.move(obj));
+}
 
-    const auto it = objectToPath_.find(obj);
-    if (it == objectToPath_.end()) {
-        pathToObject_[newPath] = obj;
-        objectToPath_[obj] = newPath;
-        return;
-    }
+void ScriptRunner::registerObjectRenamed(QObject *obj) noexcept
+{
+    QMutexLocker locker(&pathIndexMutex_);
+    applyPathChanges(pathIndex_.move(obj));
+}
+
+void ScriptRunner::registerObjectThreadChanged(QObject *obj) noexcept
+{
+    QMutexLocker locker(&pathIndexMutex_);
+    pathIndex_.stopNameCheck(obj);
+}
 
-    const auto oldPath = it->second;
-    if (oldPath != newPath) {
-        pathToObject_.erase(oldPath);
-        pathToObject_[newPath] = obj;
-        it->second = newPath;
+void ScriptRunner::applyPathChanges(const ObjectPathIndex::Changes &changes) noexcept
+{
+    for (const auto *obj : changes.removedObjects) {
+        registry_.unregisterObject(obj);
+    }
+    // Потомки перемещенных объектов перемещаются в реестре вместе с ними
+    for (auto *obj : changes.changedObjects) {
+        registry_.registerObject(obj, pathIndex_.parent(obj), pathIndex_.segment(obj));
     }
 }
 
 void ScriptRunner::startScript() noexcept
 {
     assert(this->thread() != qApp->thread());
+    assert(!scriptPath_.isEmpty());
 
-    const auto &scriptPath = runSettings_.scriptPath;
-    assert(!scriptPath.isEmpty());
-
-    QFile script(scriptPath);
-    assert(script.exists());
-
-    const auto opened = script.open(QIODevice::ReadOnly);
-    assert(opened == true);
-
-    QTextStream stream(&script);
-    const auto scriptContent = stream.readAll();
-    script.close();
-
+    const auto scriptContent = readScript(scriptPath_);
     if (scriptContent.trimmed().isEmpty()) {
-        emit scriptError(QStringLiteral("{    ERROR    } Script is empty!").arg(scriptPath));
+        emit scriptError(QStringLiteral("{    ERROR    } Script is empty!").arg(scriptPath_));
         finishThread(false);
         return;
     }
 
-    engine_ = new QJSEngine(this);
-    auto qtAdaJsObj = engine_->newQObject(this);
-    engine_->globalObject().setProperty("QtAda", qtAdaJsObj);
-    const auto runResult = engine_->evaluate(scriptContent);
-
-    if (runResult.isError()) {
-        emit scriptError(QStringLiteral("{    ERROR    } %1\n"
-                                        "{ LINE NUMBER } %2\n"
-                                        "{    STACK    }\n%3\n")
-                             .arg(runResult.property("message").toString())
-                             .arg(runResult.property("lineNumber").toInt())
-                             .arg(runResult.property("stack").toString()));
-        finishThread(false);
+    if (runSettings_.session && !mainWindows_.has_value()) {
+        auto mainWindows = std::make_shared<std::vector<QPointer<QObject>>>();
+        const auto result = executeInGuiThread(
+            [mainWindows](QObject *, GuiCommandContext &) {
+                for (auto *window : topLevelWindows()) {
+                    mainWindows->emplace_back(window);
+                }
+            },
+            INVOKE_TIMEOUT_SEC * 1000);
+        mainWindows_.emplace();
+        if (result.status == GuiCommandResult::Status::Done) {
+            *mainWindows_ = std::move(*mainWindows);
+        }
+        else if (runSettings_.sessionCloseWindows) {
+            // Без списка окон вернуть приложение в исходное состояние не получится
+            emit scriptWarning(QStringLiteral("Failed to collect the application windows (%1), "
+                                              "the application will be relaunched")
+                                   .arg(result.message));
+            relaunchRequested_ = true;
+        }
     }
-    else {
-        finishThread(true);
+
+    // Результат не должен пережить движок, который может быть удален в finishThread
+    bool isOk = true;
+    {
+        const auto runResult = evaluateInNewEngine(scriptContent);
+        if (runResult.isError()) {
+            emit scriptError(QStringLiteral("{    ERROR    } %1\n"
+                                            "{ LINE NUMBER } %2\n"
+                                            "{    STACK    }\n%3\n")
+                                 .arg(runResult.property("message").toString())
+                                 .arg(runResult.property("lineNumber").toInt())
+                                 .arg(runResult.property("stack").toString()));
+            isOk = false;
+        }
     }
+    finishThread(isOk);
 }
 
-void ScriptRunner::finishThread(bool isOk) noexcept
+void ScriptRunner::startNextScript(const QString &scriptPath, bool isLastScript) noexcept
 {
-    emit aboutToClose(isOk ? 0 : 1);
+    assert(runSettings_.session || runSettings_.deferredStart);
+    scriptPath_ = scriptPath;
+    isLastScript_ = isLastScript;
+    startScript();
 }
 
-//! TODO: Хоть эта функция вызывается только для Quick компонентов, для которых
-//! по идее не должно быть проблемы с блокировкой текущего потока, нужно все равно
-//! проверить, что проблем не будет
-void ScriptRunner::writePropertyInGuiThread(QObject *object, const QString &propertyName,
-                                            const QVariant &value) const noexcept
+void ScriptRunner::finishSession() noexcept
 {
-    assert(object != nullptr);
-    auto func
-        = [object, propertyName, value]() { QQmlProperty::write(object, propertyName, value); };
-    bool ok = QMetaObject::invokeMethod(object, func, Qt::BlockingQueuedConnection);
-    assert(ok == true);
+    assert(runSettings_.session);
+    emit aboutToClose(0);
 }
 
-void ScriptRunner::invokeBlockMethodWithTimeout(QObject *object, const char *method,
-                                                QGenericArgument val0, QGenericArgument val1,
-                                                QGenericArgument val2) const noexcept
+void ScriptRunner::finishThread(bool isOk) noexcept
 {
-    assert(object != nullptr);
+    if (runSettings_.showElapsed && runSettings_.pathResolution == PathResolution::Registry) {
+        const auto objectCount = registry_.objectCount();
+        emit scriptLog(QStringLiteral("Object registry: %1 objects, %2 bytes per object")
+                           .arg(objectCount)
+                           .arg(objectCount > 0 ? registry_.memoryUsage() / objectCount : 0));
+    }
 
-    auto future = QtConcurrent::run([object, method, val0, val1, val2]() {
-        bool ok = QMetaObject::invokeMethod(object, method, Qt::BlockingQueuedConnection, val0,
-                                            val1, val2);
-        assert(ok == true);
-    });
+    const auto exitCode = isOk ? 0 : 1;
+    // В режиме сессии приложение продолжает работу, если оно не закрывается, скрипт не
+    // запросил перезапуск и приложение удалось вернуть в исходное состояние (после последнего
+    // скрипта этого не требуется: лаунчер сразу завершит сессию)
+    if (runSettings_.session && !relaunchRequested_ && !applicationClosing_
+        && (isLastScript_ || resetSession())) {
+        emit scriptFinished(exitCode);
+        return;
+    }
+    emit aboutToClose(exitCode);
+}
+
+/*
+ * Каждый скрипт выполняется в своем движке, поэтому глобальные переменные предыдущего
+ * скрипта сессии (и объекты, найденные через QtAda.find) в следующий скрипт не попадают.
+ */
+QJSValue ScriptRunner::evaluateInNewEngine(const QString &scriptContent) noexcept
+{
+    delete engine_;
+    activeHandle_ = nullptr;
+    batchSteps_.clear();
+    batchPaths_.clear();
+    batchDepth_ = 0;
 
-    //! TODO: Конечно, лучше объявить эти данные в качестве поля данных в классе,
-    //! но пока что они объявлены как const, в связи с чем пришлось бы убирать этот
-    //! спецификатор. Позже нужно решить, что с этим делать
-    QFutureWatcher<void> watcher;
-    QEventLoop loop;
-    QTimer timer;
+    engine_ = new QJSEngine(this);
+    // Без явного указания объект без родителя перешел бы во владение движка и был бы удален
+    // вместе с ним
+    QJSEngine::setObjectOwnership(this, QJSEngine::CppOwnership);
+    auto qtAdaJsObj = engine_->newQObject(this);
+    engine_->globalObject().setProperty("QtAda", qtAdaJsObj);
+    return engine_->evaluate(scriptContent);
+}
 
-    timer.setSingleShot(true);
-    timer.start(INVOKE_TIMEOUT_SEC * 1000);
+/*
+ * Возвращает приложение в исходное состояние между скриптами сессии. Если это не удалось,
+ * то следующий скрипт будет выполнен уже в перезапущенном приложении.
+ */
+bool ScriptRunner::resetSession() noexcept
+{
+    if (runSettings_.sessionCloseWindows) {
+        assert(mainWindows_.has_value());
+        const auto result = executeInGuiThread(
+            [mainWindows = *mainWindows_](QObject *, GuiCommandContext &context) {
+                closeSecondaryWindows(mainWindows, context);
+            },
+            INVOKE_TIMEOUT_SEC * 1000);
+        if (result.status != GuiCommandResult::Status::Done) {
+            emit scriptWarning(QStringLiteral("Failed to close the windows opened by the script "
+                                              "(%1), the application will be relaunched")
+                                   .arg(result.message));
+            return false;
+        }
+        if (result.eventsPosted) {
+            waitForEventsDelivered();
+        }
+    }
 
-    QObject::connect(&watcher, &QFutureWatcher<void>::finished, &loop, &QEventLoop::quit);
-    QObject::connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
+    const auto &resetScriptPath = runSettings_.sessionResetScript;
+    if (!resetScriptPath.isEmpty()) {
+        const auto resetResult = evaluateInNewEngine(readScript(resetScriptPath));
+        if (resetResult.isError()) {
+            emit scriptWarning(QStringLiteral("Session reset script failed (%1, line %2), "
+                                              "the application will be relaunched")
+                                   .arg(resetResult.property("message").toString())
+                                   .arg(resetResult.property("lineNumber").toInt()));
+            return false;
+        }
+    }
+    return true;
+}
 
-    watcher.setFuture(future);
+/*
+ * Отложенные события и вызовы с Qt::QueuedConnection попадают в одну и ту же очередь
+ * потока-получателя и обрабатываются строго в порядке добавления. Поэтому после отправки
+ * событий ставим в очередь GUI-потока "барьер" и ждем только до момента его выполнения -
+ * к этому моменту все отправленные ранее события уже доставлены. В качестве контекста
+ * используем qApp, а не сам объект, так как объект может быть удален при обработке
+ * событий (например, QCloseEvent), и тогда вызов был бы отброшен.
+ */
+void ScriptRunner::waitForEventsDelivered() const noexcept
+{
+    auto barrier = std::make_shared<QSemaphore>();
+    bool ok = QMetaObject::invokeMethod(
+        QCoreApplication::instance(), [barrier] { barrier->release(); }, Qt::QueuedConnection);
+    assert(ok == true);
 
-    loop.exec();
+    if (!barrier->tryAcquire(1, INVOKE_TIMEOUT_SEC * 1000)) {
+        emit scriptWarning(QStringLiteral("Posted events took too long to be delivered (> %1 sec), "
+                                          "stopping the wait for their completion")
+                               .arg(INVOKE_TIMEOUT_SEC));
+        return;
+    }
 
-    if (timer.isActive()) {
-        timer.stop();
-        future.waitForFinished();
-        assert(watcher.future().isFinished());
+    // Дополнительное время на "успокоение" GUI, если обработка событий порождает
+    // отложенные действия, которые барьер отследить не может
+    const auto settleTime = runSettings_.eventSettleTime;
+    assert(settleTime >= MINIMUM_EVENT_SETTLE_TIME);
+    if (settleTime > 0) {
+        QThread::msleep(settleTime);
     }
-    else {
-        emit scriptWarning(QStringLiteral("Method '%1' took too long to execute (> %2 sec), "
-                                          "stopping the wait for its completion")
-                               .arg(method)
-                               .arg(INVOKE_TIMEOUT_SEC));
+}
+
+QObject *ScriptRunner::waitForObject(const QString &path, QDeadlineTimer deadline) const noexcept
+{
+    if (runSettings_.pathResolution == PathResolution::Registry) {
+        // Переименование объектов GUI-потока обнаруживается только при проверке их имен,
+        // поэтому во время ожидания она повторяется с интервалом
+        while (true) {
+            refreshObjectNames();
+            auto *object = registry_.waitFor(
+                path, std::min(deadline, QDeadlineTimer(runSettings_.retrievalInterval)));
+            if (object != nullptr || deadline.hasExpired()) {
+                return object;
+            }
+        }
+    }
+
+    // Без реестра нет уведомлений о появлении объектов, поэтому поиск повторяется с интервалом
+    while (true) {
+        QObject *object = nullptr;
+        bool ok = QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [this, &path, &object] { object = lookupObject(path); },
+            Qt::BlockingQueuedConnection);
+        assert(ok == true);
+        if (object != nullptr || deadline.hasExpired()) {
+            return object;
+        }
+        QThread::msleep(
+            std::min<qint64>(runSettings_.retrievalInterval, deadline.remainingTime()));
     }
 }
 
-//! TODO: желательно отправлять события аналогично тому, как работает
-//! QMetaObject::invokeMethod(..., Qt::BlockingQueuedConnection);
-//! чтобы точно все "события" выполнялись по очереди. Но пока непонятно
-//! как это делать с обычными событиями, поэтому используем небольшую
-//! задержку: QThread::msleep(100);
+void ScriptRunner::refreshObjectNames() const noexcept
+{
+    bool ok = QMetaObject::invokeMethod(
+        QCoreApplication::instance(),
+        [this] {
+            // Имена объектов GUI-потока читаются только в нем, поэтому снимаем const только здесь
+            auto *runner = const_cast<ScriptRunner *>(this);
+            QMutexLocker locker(&runner->pathIndexMutex_);
+            runner->applyPathChanges(runner->pathIndex_.refreshNames());
+        },
+        Qt::BlockingQueuedConnection);
+    assert(ok == true);
+}
+
+QObject *ScriptRunner::lookupObject(const QString &path) const noexcept
+{
+    assert(QThread::currentThread() == QCoreApplication::instance()->thread());
+    return runSettings_.pathResolution == PathResolution::Registry ? registry_.find(path)
+                                                                   : pathResolver_.resolve(path);
+}
 
-void ScriptRunner::postEvents(QObject *object, std::vector<QEvent *> events) const noexcept
+GuiObjectGetter ScriptRunner::objectGetter(const QString &path) const noexcept
 {
-    assert(object != nullptr);
-    for (auto *event : events) {
-        QGuiApplication::postEvent(object, event);
+    if (activeHandle_ != nullptr) {
+        assert(activeHandle_->path() == path);
+        // Если объект, найденный через QtAda.find, был удален, то ищем новый по тому же пути
+        return [this, path, object = activeHandle_->object()] {
+            return object.isNull() ? lookupObject(path) : object.data();
+        };
     }
-    QThread::msleep(100);
+    return [this, path] { return lookupObject(path); };
 }
 
-QObject *ScriptRunner::findObjectByPath(const QString &path) const noexcept
+bool ScriptRunner::findObjectByPath(const QString &path) const noexcept
 {
+    if (activeHandle_ != nullptr) {
+        // Объект проверяется уже в GUI-потоке при выполнении команды (см. objectGetter)
+        assert(activeHandle_->path() == path);
+        return true;
+    }
+
     QElapsedTimer timer;
     timer.start();
 
@@ -312,214 +537,638 @@ QObject *ScriptRunner::findObjectByPath(const QString &path) const noexcept
     const auto interval = runSettings_.retrievalInterval;
     assert(interval >= MINIMUM_RETRIEVAL_INTERVAL);
 
-    auto it = pathToObject_.end();
-    for (int i = 0; i < attempts; i++) {
-        it = pathToObject_.find(path);
-        if (it != pathToObject_.end() && it->second != nullptr) {
-            if (runSettings_.showElapsed) {
-                auto elapsed = timer.elapsed();
-                emit scriptLog(QStringLiteral("'%1' retrieved in %2 ms").arg(path).arg(elapsed));
-            }
-            return it->second;
-        }
-        if (i != attempts - 1) {
-            QThread::msleep(interval);
+    // Раньше ожидание происходило попытками с интервалом, поэтому общее время ожидания
+    // сохраняем таким же, как и суммарное время между попытками
+    const auto timeout = (attempts - 1) * interval;
+    if (waitForObject(path, QDeadlineTimer(timeout)) != nullptr) {
+        if (runSettings_.showElapsed) {
+            auto elapsed = timer.elapsed();
+            emit scriptLog(QStringLiteral("'%1' retrieved in %2 ms").arg(path).arg(elapsed));
         }
+        return true;
     }
 
-    assert(it == pathToObject_.end());
     engine_->throwError(QStringLiteral("Failed to find the object at path '%1' "
-                                       "after %2 attempts with an interval of %3 ms.")
+                                       "within %2 ms (%3 attempts with an interval of %4 ms).")
                             .arg(path)
+                            .arg(timeout)
                             .arg(attempts)
                             .arg(interval));
-    return nullptr;
+    return false;
+}
+
+/*
+ * Команда целиком (проверка доступности объекта, проверка его типа, поиск элемента по тексту
+ * и само действие) выполняется в GUI-потоке за один переход между потоками. Внутри
+ * QtAda.batch команда не выполняется сразу, а добавляется к накопленным командам.
+ */
+void ScriptRunner::executeCommand(const QString &path, GuiCommand command) const noexcept
+{
+    if (batchDepth_ > 0) {
+        enqueueCommand(path, std::move(command));
+        return;
+    }
+
+    if (!findObjectByPath(path)) {
+        return;
+    }
+    runCommand(path, objectGetter(path), command);
 }
 
-bool ScriptRunner::checkObjectAvailability(const QObject *object, const QString &path,
-                                           bool shouldBeVisible) const noexcept
+/*
+ * Если объект еще недоступен, команда повторяется с интервалом retrievalInterval, но не более
+ * retrievalAttempts раз, причем ожидание происходит только тогда, когда объект действительно
+ * недоступен. Объект берется заново при каждой попытке (уже в GUI-потоке), так как за время
+ * ожидания он мог быть удален. Возвращает false, если в скрипте была выброшена ошибка.
+ */
+bool ScriptRunner::runCommand(const QString &path, const GuiObjectGetter &getObject,
+                              const GuiCommand &command) const noexcept
 {
     const auto attempts = runSettings_.retrievalAttempts;
     assert(attempts >= MINIMUM_RETRIEVAL_ATTEMPTS);
     const auto interval = runSettings_.retrievalInterval;
     assert(interval >= MINIMUM_RETRIEVAL_INTERVAL);
 
-    bool enabled = false;
-    bool visible = shouldBeVisible ? false : true;
-
     //! TODO: позже нужно "встроить" это ожидание в функцию ScriptRunner::findObjectByPath
-    for (int i = 0; i < attempts && (!enabled || !visible); i++) {
-        enabled = utils::getFromVariant<bool>(QQmlProperty::read(object, "enabled"));
-        if (shouldBeVisible) {
-            visible = utils::getFromVariant<bool>(QQmlProperty::read(object, "visible"));
-        }
-        if (i != attempts - 1) {
+    GuiCommandResult result;
+    for (int i = 0; i < attempts; i++) {
+        if (i != 0) {
             QThread::msleep(interval);
         }
+        result = executeInGuiThread(getObject, command, INVOKE_TIMEOUT_SEC * 1000);
+        if (result.status != GuiCommandResult::Status::Unavailable) {
+            break;
+        }
+    }
+    if (activeHandle_ != nullptr && result.status != GuiCommandResult::Status::TimedOut) {
+        activeHandle_->rebind(result.object);
     }
 
-    if (!enabled) {
-        emit scriptWarning(
-            QStringLiteral("'%1': action on object ignored due to its disabled state").arg(path));
-        return false;
+    if (result.eventsPosted) {
+        waitForEventsDelivered();
+    }
+    return reportCommandResult(path, result);
+}
+
+bool ScriptRunner::reportCommandResult(const QString &path,
+                                       const GuiCommandResult &result) const noexcept
+{
+    for (const auto &warning : result.warnings) {
+        emit scriptWarning(warning);
     }
-    else if (!visible) {
-        emit scriptWarning(
-            QStringLiteral("'%1': action on object ignored due to its invisibility").arg(path));
+
+    switch (result.status) {
+    case GuiCommandResult::Status::Done:
+        return true;
+    case GuiCommandResult::Status::Unavailable:
+        emit scriptWarning(QStringLiteral("'%1': action on object ignored due to its %2")
+                               .arg(path)
+                               .arg(result.message));
+        return true;
+    case GuiCommandResult::Status::Failed:
+        engine_->throwError(result.message);
         return false;
+    case GuiCommandResult::Status::TimedOut:
+        emit scriptWarning(QStringLiteral("'%1': action took too long to execute (> %2 sec) and "
+                                          "is %3, stopping the wait for its completion")
+                               .arg(path)
+                               .arg(INVOKE_TIMEOUT_SEC)
+                               .arg(result.message));
+        return true;
+    default:
+        Q_UNREACHABLE();
     }
-    return true;
 }
 
-void ScriptRunner::verify(const QString &path, const QString &property,
-                          const QString &value) const noexcept
+/*
+ * Здесь объект только ищется, а сам объект команда получит уже в GUI-потоке при выполнении
+ * блока (см. objectGetter), поэтому указатели на объекты в потоке скрипта не хранятся.
+ */
+void ScriptRunner::enqueueCommand(const QString &path, GuiCommand command) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
+    if (activeHandle_ == nullptr && waitForObject(path, QDeadlineTimer(0)) == nullptr) {
+        // Объект может появиться в результате уже накопленных команд, поэтому ждем его
+        // только после их выполнения
+        if (!flushBatch() || !findObjectByPath(path)) {
+            return;
+        }
     }
 
-    QElapsedTimer timer;
-    timer.start();
+    batchSteps_.push_back({ objectGetter(path), std::move(command) });
+    batchPaths_.push_back(path);
+}
 
-    const auto *metaObject = object->metaObject();
-    const auto propertyIndex = metaObject->indexOfProperty(qPrintable(property));
-    if (propertyIndex == -1) {
-        engine_->throwError(QStringLiteral("Unknown meta-property name: '%1'").arg(property));
-        return;
+/*
+ * Выполняет накопленные команды блоками, каждый за один переход в GUI-поток. Блок
+ * заканчивается на команде, отправившей события: следующий блок встает в очередь GUI-потока
+ * уже после этих событий, поэтому барьер нужен только для времени "успокоения" GUI и после
+ * последней команды. Команды с недоступным (или удаленным) объектом, как и команда, которую
+ * блок не успел начать за отведенное время, выполняются отдельно, с ожиданием и повторным
+ * поиском объекта. Возвращает false, если была выброшена ошибка.
+ */
+bool ScriptRunner::flushBatch() const noexcept
+{
+    if (batchSteps_.empty()) {
+        return true;
     }
 
-    const auto attempts = runSettings_.verifyAttempts;
-    assert(attempts >= MINIMUM_VERIFY_ATTEMPTS);
-    const auto interval = runSettings_.verifyInterval;
-    assert(interval >= MINIMUM_VERIFY_INTERVAL);
+    const auto steps = std::exchange(batchSteps_, {});
+    const auto paths = std::exchange(batchPaths_, {});
+    // Накопленные команды могли быть вызваны через другие ObjectHandle
+    const auto *activeHandle = std::exchange(activeHandle_, nullptr);
 
-    for (int i = 0; i < attempts; i++) {
-        const auto metaProperty = metaObject->property(propertyIndex);
-        const auto currentValue = tools::metaPropertyValueToString(object, metaProperty);
+    bool isOk = true;
+    size_t next = 0;
+    while (isOk && next < steps.size()) {
+        const auto results = executeStepsInGuiThread(steps, next, INVOKE_TIMEOUT_SEC * 1000);
+        if (results.empty()) {
+            // GUI-поток был занят, и блок не начал ни одной команды: первая из них выполняется
+            // отдельно, а ее собственный таймаут ограничивает ожидание занятого GUI-потока
+            isOk = runCommand(paths[next], steps[next].getObject, steps[next].command);
+            next++;
+            continue;
+        }
+        next += results.size();
 
-        if (currentValue == value) {
-            if (runSettings_.showElapsed) {
-                const auto elapsed = timer.elapsed();
-                emit scriptLog(QStringLiteral("'%1' verified in %2 ms").arg(path).arg(elapsed));
+        const auto &lastResult = results.back();
+        const auto &lastPath = paths[next - 1];
+        for (size_t i = 0; i + 1 < results.size(); i++) {
+            for (const auto &warning : results[i].warnings) {
+                emit scriptWarning(warning);
             }
-            return;
         }
 
-        if (i == attempts - 1) {
-            engine_->throwError(QStringLiteral("Verify Failed!\n"
-                                               "Object Path:      '%1'\n"
-                                               "Property:         '%2'\n"
-                                               "Expected Value:   '%3'\n"
-                                               "Current Value:    '%4'\n"
-                                               "Verify attempts:  '%5'\n"
-                                               "Verify interval:  '%6'")
-                                    .arg(path)
-                                    .arg(property)
-                                    .arg(value)
-                                    .arg(currentValue)
-                                    .arg(attempts)
-                                    .arg(interval));
-            return;
+        if (lastResult.status == GuiCommandResult::Status::Unavailable) {
+            const auto &step = steps[next - 1];
+            isOk = findObjectByPath(lastPath) && runCommand(lastPath, step.getObject, step.command);
+            continue;
         }
-        else {
-            QThread::msleep(interval);
+        if (lastResult.eventsPosted
+            && (next == steps.size() || runSettings_.eventSettleTime > 0)) {
+            waitForEventsDelivered();
         }
+        isOk = reportCommandResult(lastPath, lastResult);
     }
-}
 
-void ScriptRunner::waitFor(const QString &path, int sec) const noexcept
-{
-    mwaitFor(path, sec * 1000);
+    activeHandle_ = activeHandle;
+    return isOk;
 }
 
-void ScriptRunner::mwaitFor(const QString &path, int msec) const noexcept
+/*
+ * Команды действий, вызванные внутри функции, не выполняются сразу, а накапливаются и затем
+ * выполняются подряд, без отдельного перехода в GUI-поток для каждой команды. Остальные
+ * команды (verify, waitFor, sleep и т.д.) сначала выполняют уже накопленные действия, поэтому
+ * порядок команд сохраняется. Если функция завершилась ошибкой, еще не выполненные действия
+ * отбрасываются.
+ */
+void ScriptRunner::batch(const QJSValue &function) const noexcept
 {
-    QElapsedTimer timer;
-    timer.start();
+    if (!function.isCallable()) {
+        engine_->throwError(QStringLiteral("Passed batch argument is not a function"));
+        return;
+    }
 
-    auto it = pathToObject_.end();
-    while (!timer.hasExpired(msec)) {
-        it = pathToObject_.find(path);
-        if (it != pathToObject_.end() && it->second != nullptr) {
-            auto *object = it->second;
-            const auto *metaObject = object->metaObject();
-            const auto propertyIndex = metaObject->indexOfProperty("visible");
-            if (propertyIndex == -1) {
-                engine_->throwError(
-                    QStringLiteral("This function is intended to wait for the creation"
-                                   " and visibility of an object, but the object"
-                                   " does not have a 'visible' property"));
-                return;
-            }
-            const auto visible = object->property("visible").toBool();
-            if (visible) {
-                if (runSettings_.showElapsed) {
-                    auto elapsed = timer.elapsed();
-                    emit scriptLog(
-                        QStringLiteral("'%1' retrieved in %2 ms").arg(path).arg(elapsed));
-                }
-                return;
-            }
+    batchDepth_++;
+    const auto result = function.call();
+    batchDepth_--;
+    // Вложенный batch выполняется в составе внешнего
+    const auto isOuter = batchDepth_ == 0;
+
+    if (result.isError()) {
+        if (isOuter) {
+            batchSteps_.clear();
+            batchPaths_.clear();
         }
+        // QJSValue::call перехватывает исключение, поэтому выбрасываем его повторно, указав
+        // строку исходной ошибки (иначе ошибка будет указывать на строку вызова batch)
+        const auto message = result.property("message").toString();
+        engine_->throwError(isOuter ? QStringLiteral("%1 (line %2 inside batch)")
+                                          .arg(message)
+                                          .arg(result.property("lineNumber").toInt())
+                                    : message);
+        return;
+    }
+    if (isOuter) {
+        flushBatch();
     }
-
-    assert(it == pathToObject_.end());
-    engine_->throwError(QStringLiteral("Failed to wait for the object at path '%1' "
-                                       "within %2 ms.")
-                            .arg(path)
-                            .arg(msec));
 }
 
-void ScriptRunner::sleep(int sec)
+QJSValue ScriptRunner::find(const QString &path) const noexcept
 {
-    QThread::sleep(sec);
+    if (!flushBatch()) {
+        return QJSValue();
+    }
+    if (!findObjectByPath(path)) {
+        return QJSValue();
+    }
+    // QPointer на найденный объект можно создать только в GUI-потоке
+    const auto result = executeInGuiThread(
+        objectGetter(path), [](QObject *, GuiCommandContext &) {}, INVOKE_TIMEOUT_SEC * 1000);
+    switch (result.status) {
+    case GuiCommandResult::Status::Done:
+        break;
+    case GuiCommandResult::Status::Unavailable:
+        engine_->throwError(
+            QStringLiteral("The object at path '%1' was destroyed before it was found").arg(path));
+        return QJSValue();
+    case GuiCommandResult::Status::TimedOut:
+        engine_->throwError(QStringLiteral("'%1': the object could not be found within %2 sec")
+                                .arg(path)
+                                .arg(INVOKE_TIMEOUT_SEC));
+        return QJSValue();
+    default:
+        // Пустая команда не может завершиться ошибкой
+        Q_UNREACHABLE();
+    }
+    // У объекта нет родителя, поэтому им владеет движок скрипта
+    return engine_->newQObject(new ObjectHandle(this, path, result.object));
 }
 
-void ScriptRunner::msleep(int msec)
-{
-    QThread::msleep(msec);
-}
+namespace {
+struct WatchedProperties final {
+    std::vector<QMetaProperty> metaProperties;
+    // nullptr для свойств без NOTIFY-сигнала
+    std::vector<PropertyNotifyWatcher *> watchers;
+};
+} // namespace
 
-void ScriptRunner::usleep(int usec)
+/*
+ * Выполняется в GUI-потоке: свойства ищутся, а наблюдатели подключаются там же, где объект
+ * может быть удален, поэтому в потоке скрипта объект не разыменовывается.
+ */
+static void watchProperties(QObject *object, const QStringList &properties,
+                            const std::shared_ptr<QSemaphore> &notifySemaphore,
+                            WatchedProperties &watched, GuiCommandContext &context) noexcept
 {
-    QThread::usleep(usec);
+    const auto *metaObject = object->metaObject();
+    for (const auto &property : properties) {
+        const auto propertyIndex = tools::propertyIndex(metaObject, qPrintable(property));
+        if (propertyIndex == -1) {
+            context.fail(QStringLiteral("Unknown meta-property name: '%1'").arg(property));
+            return;
+        }
+        watched.metaProperties.push_back(metaObject->property(propertyIndex));
+    }
+    for (const auto &metaProperty : watched.metaProperties) {
+        watched.watchers.push_back(
+            PropertyNotifyWatcher::watch(object, metaProperty, notifySemaphore));
+    }
 }
 
-void ScriptRunner::mouseClickTemplate(const QString &path, const QString &mouseButtonStr, int x,
-                                      int y, bool isDouble) const noexcept
-{
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
+/*
+ * Наблюдатели освобождаются отдельным шагом в GUI-потоке, не дожидаясь его. Шаг встает в
+ * очередь после шага подключения наблюдателей, поэтому освобождает их, даже если тот начался
+ * уже после таймаута ожидания.
+ */
+static void releaseWatchers(const std::shared_ptr<WatchedProperties> &watched) noexcept
+{
+    QMetaObject::invokeMethod(
+        QCoreApplication::instance(),
+        [watched] {
+            for (auto *watcher : watched->watchers) {
+                if (watcher != nullptr) {
+                    watcher->release();
+                }
+            }
+        },
+        Qt::QueuedConnection);
+}
+
+bool ScriptRunner::checkWatchResult(const QString &path,
+                                    const GuiCommandResult &result) const noexcept
+{
+    switch (result.status) {
+    case GuiCommandResult::Status::Done:
+        return true;
+    case GuiCommandResult::Status::Unavailable:
+        engine_->throwError(
+            QStringLiteral("The object at path '%1' was destroyed before verification")
+                .arg(path));
+        return false;
+    case GuiCommandResult::Status::Failed:
+        engine_->throwError(result.message);
+        return false;
+    case GuiCommandResult::Status::TimedOut:
+        engine_->throwError(QStringLiteral("'%1': verification could not start within %2 sec")
+                                .arg(path)
+                                .arg(INVOKE_TIMEOUT_SEC));
+        return false;
+    default:
+        Q_UNREACHABLE();
+    }
+}
+
+void ScriptRunner::verify(const QString &path, const QString &property,
+                          const QString &value) const noexcept
+{
+    if (!flushBatch()) {
         return;
     }
+    verifyProperties(path, { { property, value } });
+}
 
-    const auto mouseButton = utils::mouseButtonFromString(mouseButtonStr);
-    if (!mouseButton.has_value()) {
-        engine_->throwError(QStringLiteral("Unknown mouse button: '%1'").arg(mouseButtonStr));
+void ScriptRunner::verifyAll(const QString &path, const QJSValue &expectedValues) const noexcept
+{
+    if (!flushBatch()) {
         return;
     }
-    if (!checkObjectAvailability(object, path)) {
+
+    if (!expectedValues.isObject() || expectedValues.isArray()) {
+        engine_->throwError(QStringLiteral("Passed expected values are not an object"));
+        return;
+    }
+
+    Verifications verifications;
+    QJSValueIterator it(expectedValues);
+    while (it.hasNext()) {
+        it.next();
+        verifications.emplace_back(it.name(), it.value().toString());
+    }
+    if (verifications.empty()) {
+        engine_->throwError(QStringLiteral("Passed expected values are empty"));
+        return;
+    }
+    verifyProperties(path, verifications);
+}
+
+/*
+ * Проверка свойств объекта (verify - частный случай с одним свойством): все свойства
+ * считываются за одно обращение к GUI-потоку, попытки и время ожидания общие для всех
+ * свойств, а в случае ошибки перечисляются все несовпавшие свойства.
+ */
+void ScriptRunner::verifyProperties(const QString &path,
+                                    const Verifications &verifications) const noexcept
+{
+    assert(!verifications.empty());
+    if (!findObjectByPath(path)) {
         return;
     }
 
-    const auto pos = QPoint(x, y);
-    if (isDouble) {
-        if (object->inherits("QQuickItem")) {
-            postEvents(object,
-                       { simpleMouseEvent(QEvent::MouseButtonDblClick, pos, *mouseButton) });
+    QElapsedTimer timer;
+    timer.start();
+
+    // Если у свойств есть NOTIFY-сигналы, то перепроверяем значения только после испускания
+    // любого из них, а опрос с интервалом verifyInterval оставляем только на случай, когда
+    // хотя бы у одного свойства уведомления нет. Наблюдатели подключаются до первого чтения,
+    // чтобы не пропустить изменение значения между чтением и началом ожидания.
+    QStringList properties;
+    for (const auto &verification : verifications) {
+        properties.push_back(verification.first);
+    }
+    auto notifySemaphore = std::make_shared<QSemaphore>();
+    auto watched = std::make_shared<WatchedProperties>();
+    const auto watchersGuard = qScopeGuard([watched] { releaseWatchers(watched); });
+    const auto watchResult = executeInGuiThread(
+        objectGetter(path),
+        [properties, notifySemaphore, watched](QObject *object, GuiCommandContext &context) {
+            watchProperties(object, properties, notifySemaphore, *watched, context);
+        },
+        INVOKE_TIMEOUT_SEC * 1000);
+    if (!checkWatchResult(path, watchResult)) {
+        return;
+    }
+    if (activeHandle_ != nullptr) {
+        activeHandle_->rebind(watchResult.object);
+    }
+    // Дальше проверяется именно этот объект, даже если по тому же пути появится другой
+    const auto getObject = [object = watchResult.object] { return object.data(); };
+
+    struct Expectation final {
+        QMetaProperty metaProperty;
+        QString value;
+        // Для простых типов ожидаемое значение приводится к типу свойства один раз, и дальше
+        // сравниваются сами значения без преобразования текущего значения в строку
+        std::optional<QVariant> typedValue;
+    };
+    std::vector<Expectation> expectations;
+    expectations.reserve(verifications.size());
+    for (size_t i = 0; i < verifications.size(); i++) {
+        const auto &metaProperty = watched->metaProperties[i];
+        const auto &value = verifications[i].second;
+        expectations.push_back(
+            { metaProperty, value, tools::typedExpectedValue(metaProperty, value) });
+    }
+    const bool allNotifiable = std::all_of(watched->watchers.cbegin(), watched->watchers.cend(),
+                                           [](const auto *watcher) { return watcher != nullptr; });
+
+    const auto attempts = runSettings_.verifyAttempts;
+    assert(attempts >= MINIMUM_VERIFY_ATTEMPTS);
+    const auto interval = runSettings_.verifyInterval;
+    assert(interval >= MINIMUM_VERIFY_INTERVAL);
+
+    // Возвращает индексы несовпавших свойств, а при describe - и их текущие значения
+    const auto checkAll = [&](bool describe) {
+        return executeInGuiThread(
+            getObject,
+            [expectations, describe](QObject *object, GuiCommandContext &context) {
+                QVariantList mismatches;
+                for (int i = 0; i < static_cast<int>(expectations.size()); i++) {
+                    const auto &expectation = expectations[i];
+                    const auto matched
+                        = expectation.typedValue.has_value()
+                              ? tools::propertyValueEquals(object, expectation.metaProperty,
+                                                           *expectation.typedValue)
+                              : tools::metaPropertyValueToString(object, expectation.metaProperty)
+                                    == expectation.value;
+                    if (matched) {
+                        continue;
+                    }
+                    if (describe) {
+                        const auto currentValue
+                            = tools::metaPropertyValueToString(object, expectation.metaProperty);
+                        mismatches.push_back(QVariantList{ i, currentValue });
+                    }
+                    else {
+                        mismatches.push_back(i);
+                    }
+                }
+                context.setValue(mismatches);
+            },
+            INVOKE_TIMEOUT_SEC * 1000);
+    };
+
+    // Общее время ожидания сохраняем таким же, как и суммарное время между попытками
+    QDeadlineTimer deadline((attempts - 1) * interval);
+    bool verified = false;
+    while (true) {
+        const auto result = checkAll(false);
+        verified = result.status == GuiCommandResult::Status::Done
+                   && result.value.toList().isEmpty();
+        if (verified || deadline.hasExpired()) {
+            break;
+        }
+
+        if (allNotifiable) {
+            const auto remainingTime = static_cast<int>(deadline.remainingTime());
+            if (!notifySemaphore->tryAcquire(1, remainingTime)) {
+                break;
+            }
+            // Несколько уведомлений подряд не требуют нескольких проверок
+            notifySemaphore->tryAcquire(notifySemaphore->available());
         }
         else {
-            postEvents(object, { simpleMouseEvent(QEvent::MouseButtonPress, pos, *mouseButton),
-                                 simpleMouseEvent(QEvent::MouseButtonRelease, pos, *mouseButton),
-                                 simpleMouseEvent(QEvent::MouseButtonDblClick, pos, *mouseButton),
-                                 simpleMouseEvent(QEvent::MouseButtonRelease, pos, *mouseButton) });
+            QThread::msleep(std::min<qint64>(interval, deadline.remainingTime()));
         }
     }
-    else {
-        postEvents(object, { simpleMouseEvent(QEvent::MouseButtonPress, pos, *mouseButton),
-                             simpleMouseEvent(QEvent::MouseButtonRelease, pos, *mouseButton) });
+
+    if (verified) {
+        if (runSettings_.showElapsed) {
+            const auto elapsed = timer.elapsed();
+            emit scriptLog(QStringLiteral("'%1' verified in %2 ms").arg(path).arg(elapsed));
+        }
+        return;
+    }
+
+    QString mismatchesDescription;
+    const auto result = checkAll(true);
+    for (const auto &rawMismatch : result.value.toList()) {
+        const auto mismatch = rawMismatch.toList();
+        assert(mismatch.size() == 2);
+        const auto &verification = verifications[mismatch[0].toInt()];
+        mismatchesDescription += QStringLiteral("Property:         '%1'\n"
+                                                "Expected Value:   '%2'\n"
+                                                "Current Value:    '%3'\n")
+                                     .arg(verification.first)
+                                     .arg(verification.second)
+                                     .arg(mismatch[1].toString());
+    }
+    engine_->throwError(QStringLiteral("Verify Failed!\n"
+                                       "Object Path:      '%1'\n"
+                                       "%2"
+                                       "Verify attempts:  '%3'\n"
+                                       "Verify interval:  '%4'")
+                            .arg(path)
+                            .arg(mismatchesDescription)
+                            .arg(attempts)
+                            .arg(interval));
+}
+
+void ScriptRunner::waitFor(const QString &path, int sec) const noexcept
+{
+    mwaitFor(path, sec * 1000);
+}
+
+void ScriptRunner::mwaitFor(const QString &path, int msec) const noexcept
+{
+    if (!flushBatch()) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QDeadlineTimer deadline(msec);
+    while (true) {
+        auto *object = waitForObject(path, deadline);
+        if (object == nullptr) {
+            break;
+        }
+
+        const auto result = executeInGuiThread(
+            objectGetter(path),
+            [](QObject *object, GuiCommandContext &context) {
+                const auto *metaObject = object->metaObject();
+                const auto propertyIndex = tools::propertyIndex(metaObject, "visible");
+                if (propertyIndex == -1) {
+                    context.fail(QStringLiteral("This function is intended to wait for the creation"
+                                                " and visibility of an object, but the object"
+                                                " does not have a 'visible' property"));
+                    return;
+                }
+                context.setValue(metaObject->property(propertyIndex).read(object));
+            },
+            INVOKE_TIMEOUT_SEC * 1000);
+        if (result.status == GuiCommandResult::Status::Failed) {
+            engine_->throwError(result.message);
+            return;
+        }
+        if (result.value.toBool()) {
+            if (runSettings_.showElapsed) {
+                auto elapsed = timer.elapsed();
+                emit scriptLog(QStringLiteral("'%1' retrieved in %2 ms").arg(path).arg(elapsed));
+            }
+            return;
+        }
+        if (deadline.hasExpired()) {
+            break;
+        }
+
+        //! TODO: Для свойства visible нет общего для QWidget и QQuickItem уведомления,
+        //! которое можно было бы отслеживать в реестре объектов, поэтому видимость уже
+        //! найденного объекта проверяем с небольшим интервалом.
+        QThread::msleep(std::min<qint64>(VISIBILITY_CHECK_INTERVAL_MSEC, deadline.remainingTime()));
+    }
+
+    engine_->throwError(QStringLiteral("Failed to wait for the object at path '%1' "
+                                       "within %2 ms.")
+                            .arg(path)
+                            .arg(msec));
+}
+
+void ScriptRunner::sleep(int sec)
+{
+    if (!flushBatch()) {
+        return;
+    }
+    QThread::sleep(sec);
+}
+
+void ScriptRunner::msleep(int msec)
+{
+    if (!flushBatch()) {
+        return;
+    }
+    QThread::msleep(msec);
+}
+
+void ScriptRunner::usleep(int usec)
+{
+    if (!flushBatch()) {
+        return;
+    }
+    QThread::usleep(usec);
+}
+
+void ScriptRunner::requestRelaunch() noexcept
+{
+    relaunchRequested_ = true;
+}
+
+void ScriptRunner::mouseClickTemplate(const QString &path, const QString &mouseButtonStr, int x,
+                                      int y, bool isDouble) const noexcept
+{
+    const auto mouseButton = utils::mouseButtonFromString(mouseButtonStr);
+    if (!mouseButton.has_value()) {
+        engine_->throwError(QStringLiteral("Unknown mouse button: '%1'").arg(mouseButtonStr));
+        return;
     }
+
+    executeCommand(path, [button = *mouseButton, x, y, isDouble](QObject *object,
+                                                                  GuiCommandContext &context) {
+        if (!context.checkAvailability(object)) {
+            return;
+        }
+
+        const auto pos = QPoint(x, y);
+        if (isDouble) {
+            if (object->inherits("QQuickItem")) {
+                context.postEvents(object,
+                                   { simpleMouseEvent(QEvent::MouseButtonDblClick, pos, button) });
+            }
+            else {
+                context.postEvents(object,
+                                   { simpleMouseEvent(QEvent::MouseButtonPress, pos, button),
+                                     simpleMouseEvent(QEvent::MouseButtonRelease, pos, button),
+                                     simpleMouseEvent(QEvent::MouseButtonDblClick, pos, button),
+                                     simpleMouseEvent(QEvent::MouseButtonRelease, pos, button) });
+            }
+        }
+        else {
+            context.postEvents(object,
+                               { simpleMouseEvent(QEvent::MouseButtonPress, pos, button),
+                                 simpleMouseEvent(QEvent::MouseButtonRelease, pos, button) });
+        }
+    });
 }
 
 void ScriptRunner::mouseClick(const QString &path, const QString &mouseButtonStr, int x,
@@ -543,53 +1192,45 @@ void ScriptRunner::mouseDblClick(const QString &path, const QString &mouseButton
  */
 void ScriptRunner::buttonClick(const QString &path) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
+    executeCommand(path, [](QObject *object, GuiCommandContext &context) {
+        bool isWidgetButton = object->inherits("QAbstractButton");
+        bool isQuickButton = object->inherits("QQuickAbstractButton");
 
-    bool isWidgetButton = object->inherits("QAbstractButton");
-    bool isQuickButton = object->inherits("QQuickAbstractButton");
-
-    if (!isWidgetButton && !isQuickButton) {
-        engine_->throwError(QStringLiteral("Passed object is not a button"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
+        if (!isWidgetButton && !isQuickButton) {
+            context.fail(QStringLiteral("Passed object is not a button"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
 
-    if (isWidgetButton) {
-        invokeBlockMethodWithTimeout(object, "click");
-    }
-    else {
-        const auto height = utils::getFromVariant<double>(QQmlProperty::read(object, "height"));
-        const auto width = utils::getFromVariant<double>(QQmlProperty::read(object, "width"));
-        const auto pos = QPoint(width / 2, height / 2);
-        postEvents(object, { simpleMouseEvent(QEvent::MouseButtonPress, pos),
-                             simpleMouseEvent(QEvent::MouseButtonRelease, pos) });
-    }
+        if (isWidgetButton) {
+            context.invoke(object, "click");
+        }
+        else {
+            const auto pos = itemCenter(object);
+            context.postEvents(object, { simpleMouseEvent(QEvent::MouseButtonPress, pos),
+                                         simpleMouseEvent(QEvent::MouseButtonRelease, pos) });
+        }
+    });
 }
 
 void ScriptRunner::buttonToggle(const QString &path) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    bool isWidgetButton = object->inherits("QAbstractButton");
-    bool isQuickButton = object->inherits("QQuickAbstractButton");
+    executeCommand(path, [](QObject *object, GuiCommandContext &context) {
+        bool isWidgetButton = object->inherits("QAbstractButton");
+        bool isQuickButton = object->inherits("QQuickAbstractButton");
 
-    if (!isWidgetButton && !isQuickButton) {
-        engine_->throwError(QStringLiteral("Passed object is not a button"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
+        if (!isWidgetButton && !isQuickButton) {
+            context.fail(QStringLiteral("Passed object is not a button"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
 
-    invokeBlockMethodWithTimeout(object, "toggle");
+        context.invoke(object, "toggle");
+    });
 }
 
 /*
@@ -604,96 +1245,82 @@ void ScriptRunner::buttonToggle(const QString &path) const noexcept
  */
 void ScriptRunner::buttonDblClick(const QString &path) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    const auto isWidgetButton = object->inherits("QAbstractButton");
-    const auto isQuickButton = object->inherits("QQuickAbstractButton");
+    executeCommand(path, [](QObject *object, GuiCommandContext &context) {
+        const auto isWidgetButton = object->inherits("QAbstractButton");
+        const auto isQuickButton = object->inherits("QQuickAbstractButton");
 
-    if (!isWidgetButton && !isQuickButton) {
-        engine_->throwError(QStringLiteral("Passed object is not a button"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
+        if (!isWidgetButton && !isQuickButton) {
+            context.fail(QStringLiteral("Passed object is not a button"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
 
-    const auto height = utils::getFromVariant<double>(QQmlProperty::read(object, "height"));
-    const auto width = utils::getFromVariant<double>(QQmlProperty::read(object, "width"));
-    const auto pos = QPoint(width / 2, height / 2);
-    if (isQuickButton) {
-        postEvents(object, { simpleMouseEvent(QEvent::MouseButtonDblClick, pos) });
-    }
-    else if (isWidgetButton) {
-        postEvents(object, { simpleMouseEvent(QEvent::MouseButtonPress, pos),
-                             simpleMouseEvent(QEvent::MouseButtonRelease, pos),
-                             simpleMouseEvent(QEvent::MouseButtonDblClick, pos),
-                             simpleMouseEvent(QEvent::MouseButtonRelease, pos) });
-    }
-    else {
-        Q_UNREACHABLE();
-    }
+        const auto pos = itemCenter(object);
+        if (isQuickButton) {
+            context.postEvents(object, { simpleMouseEvent(QEvent::MouseButtonDblClick, pos) });
+        }
+        else if (isWidgetButton) {
+            context.postEvents(object, { simpleMouseEvent(QEvent::MouseButtonPress, pos),
+                                         simpleMouseEvent(QEvent::MouseButtonRelease, pos),
+                                         simpleMouseEvent(QEvent::MouseButtonDblClick, pos),
+                                         simpleMouseEvent(QEvent::MouseButtonRelease, pos) });
+        }
+        else {
+            Q_UNREACHABLE();
+        }
+    });
 }
 
 void ScriptRunner::buttonPress(const QString &path) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    const auto isWidgetButton = object->inherits("QAbstractButton");
-    const auto isQuickButton = object->inherits("QQuickAbstractButton");
+    executeCommand(path, [](QObject *object, GuiCommandContext &context) {
+        const auto isWidgetButton = object->inherits("QAbstractButton");
+        const auto isQuickButton = object->inherits("QQuickAbstractButton");
 
-    if (!isWidgetButton && !isQuickButton) {
-        engine_->throwError(QStringLiteral("Passed object is not a button"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
+        if (!isWidgetButton && !isQuickButton) {
+            context.fail(QStringLiteral("Passed object is not a button"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
 
-    const auto height = utils::getFromVariant<double>(QQmlProperty::read(object, "height"));
-    const auto width = utils::getFromVariant<double>(QQmlProperty::read(object, "width"));
-    const auto pos = QPoint(width / 2, height / 2);
-    if (isQuickButton) {
-        postEvents(object, { simpleMouseEvent(QEvent::MouseButtonPress, pos) });
-    }
-    else if (isWidgetButton) {
-        postEvents(object, { simpleMouseEvent(QEvent::MouseButtonPress, pos),
-                             simpleMouseEvent(QEvent::MouseButtonRelease, QPoint(-10, -10)) });
-    }
-    else {
-        Q_UNREACHABLE();
-    }
+        const auto pos = itemCenter(object);
+        if (isQuickButton) {
+            context.postEvents(object, { simpleMouseEvent(QEvent::MouseButtonPress, pos) });
+        }
+        else if (isWidgetButton) {
+            context.postEvents(
+                object, { simpleMouseEvent(QEvent::MouseButtonPress, pos),
+                          simpleMouseEvent(QEvent::MouseButtonRelease, QPoint(-10, -10)) });
+        }
+        else {
+            Q_UNREACHABLE();
+        }
+    });
 }
 
 void ScriptRunner::mouseAreaEventTemplate(const QString &path,
                                           const std::vector<QEvent::Type> eventTypes) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    if (!object->inherits("QQuickMouseArea")) {
-        engine_->throwError(QStringLiteral("Passed object is not a mouse area"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
+    executeCommand(path, [eventTypes](QObject *object, GuiCommandContext &context) {
+        if (!object->inherits("QQuickMouseArea")) {
+            context.fail(QStringLiteral("Passed object is not a mouse area"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
 
-    const auto height = utils::getFromVariant<double>(QQmlProperty::read(object, "height"));
-    const auto width = utils::getFromVariant<double>(QQmlProperty::read(object, "width"));
-    const auto pos = QPoint(width / 2, height / 2);
-    std::vector<QEvent *> events;
-    for (const auto &event : eventTypes) {
-        events.push_back(simpleMouseEvent(event, pos));
-    }
-    postEvents(object, events);
+        const auto pos = itemCenter(object);
+        std::vector<QEvent *> events;
+        for (const auto &event : eventTypes) {
+            events.push_back(simpleMouseEvent(event, pos));
+        }
+        context.postEvents(object, events);
+    });
 }
 
 void ScriptRunner::mouseAreaClick(const QString &path) const noexcept
@@ -713,150 +1340,147 @@ void ScriptRunner::mouseAreaPress(const QString &path) const noexcept
 
 void ScriptRunner::checkButton(const QString &path, bool isChecked) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    const auto isWidgetButton = object->inherits("QAbstractButton");
-    const auto isQuickButton = object->inherits("QQuickAbstractButton");
-    if (!isWidgetButton && !isQuickButton) {
-        engine_->throwError(QStringLiteral("Passed object is not a button"));
-        return;
-    }
-    if (!utils::getFromVariant<bool>(QQmlProperty::read(object, "checkable"))) {
-        engine_->throwError(QStringLiteral("Button is not checkable"));
-        return;
-    }
+    executeCommand(path, [path, isChecked](QObject *object, GuiCommandContext &context) {
+        const auto isWidgetButton = object->inherits("QAbstractButton");
+        const auto isQuickButton = object->inherits("QQuickAbstractButton");
+        if (!isWidgetButton && !isQuickButton) {
+            context.fail(QStringLiteral("Passed object is not a button"));
+            return;
+        }
+        if (!utils::getFromVariant<bool>(tools::readProperty(object, "checkable"))) {
+            context.fail(QStringLiteral("Button is not checkable"));
+            return;
+        }
 
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
 
-    if (utils::getFromVariant<bool>(QQmlProperty::read(object, "checked")) == isChecked) {
-        emit scriptWarning(QStringLiteral("'%1': button already has state '%2'")
-                               .arg(path)
-                               .arg(isChecked ? "true" : "false"));
-    }
-    else {
-        //! TODO: Скорее всего toggle вообще бесполезен, так как в большинстве используется
-        //! обработка события клика, а он не воспроизводится при выполнении метода `toggle`.
-        //! invokeBlockMethodWithTimeout(object, "toggle");
-        if (isWidgetButton) {
-            invokeBlockMethodWithTimeout(object, "click");
+        if (utils::getFromVariant<bool>(tools::readProperty(object, "checked")) == isChecked) {
+            context.warn(QStringLiteral("'%1': button already has state '%2'")
+                             .arg(path)
+                             .arg(isChecked ? "true" : "false"));
         }
         else {
-            const auto height = utils::getFromVariant<double>(QQmlProperty::read(object, "height"));
-            const auto width = utils::getFromVariant<double>(QQmlProperty::read(object, "width"));
-            const auto pos = QPoint(width / 2, height / 2);
-            postEvents(object, { simpleMouseEvent(QEvent::MouseButtonPress, pos),
-                                 simpleMouseEvent(QEvent::MouseButtonRelease, pos) });
+            //! TODO: Скорее всего toggle вообще бесполезен, так как в большинстве используется
+            //! обработка события клика, а он не воспроизводится при выполнении метода `toggle`.
+            //! context.invoke(object, "toggle");
+            if (isWidgetButton) {
+                context.invoke(object, "click");
+            }
+            else {
+                const auto pos = itemCenter(object);
+                context.postEvents(object, { simpleMouseEvent(QEvent::MouseButtonPress, pos),
+                                             simpleMouseEvent(QEvent::MouseButtonRelease, pos) });
+            }
         }
-    }
+    });
 }
 
 void ScriptRunner::selectItemTemplate(const QString &path, int index, const QString &text,
                                       TextIndexBehavior behavior) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    const auto isWidgetComboBox = object->inherits("QComboBox");
-    const auto isQuickComboBox = object->inherits("QQuickComboBox");
-    const auto isQuickTumbler = object->inherits("QQuickTumbler");
-
-    if (!isWidgetComboBox && !isQuickComboBox && !isQuickTumbler) {
-        engine_->throwError(QStringLiteral("Passed object is not a combobox or tumbler"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
-
-    const auto count = utils::getFromVariant<int>(QQmlProperty::read(object, "count"));
-    if (count == 0) {
-        engine_->throwError(QStringLiteral("Passed object has no selectable items"));
-        return;
-    }
+    executeCommand(path, [path, index, text, behavior](QObject *object,
+                                                       GuiCommandContext &context) {
+        const auto isWidgetComboBox = object->inherits("QComboBox");
+        const auto isQuickComboBox = object->inherits("QQuickComboBox");
+        const auto isQuickTumbler = object->inherits("QQuickTumbler");
 
-    auto indexHandler = [&](int currentIndex) {
-        if (currentIndex < 0 || currentIndex >= count) {
-            engine_->throwError(
-                QStringLiteral("Index '%1' is out of range [0, %2)").arg(currentIndex).arg(count));
+        if (!isWidgetComboBox && !isQuickComboBox && !isQuickTumbler) {
+            context.fail(QStringLiteral("Passed object is not a combobox or tumbler"));
             return;
         }
-        if (isWidgetComboBox) {
-            invokeBlockMethodWithTimeout(object, "setCurrentIndex", Q_ARG(int, currentIndex));
-        }
-        else if (isQuickComboBox || isQuickTumbler) {
-            writePropertyInGuiThread(object, "currentIndex", currentIndex);
-        }
-        else {
-            Q_UNREACHABLE();
-        }
-    };
-
-    auto indexFromText = [&] {
-        int textIndex = -1;
-        if (isWidgetComboBox) {
-            bool ok = QMetaObject::invokeMethod(object, "findText", Qt::BlockingQueuedConnection,
-                                                Q_RETURN_ARG(int, textIndex), Q_ARG(QString, text));
-            assert(ok == true);
-        }
-        else if (isQuickComboBox) {
-            bool ok = QMetaObject::invokeMethod(object, "find", Qt::BlockingQueuedConnection,
-                                                Q_RETURN_ARG(int, textIndex), Q_ARG(QString, text));
-            assert(ok == true);
-        }
-        else {
-            Q_UNREACHABLE();
+        if (!context.checkAvailability(object)) {
+            return;
         }
-        return textIndex;
-    };
 
-    switch (behavior) {
-    case TextIndexBehavior::OnlyIndex: {
-        indexHandler(index);
-        break;
-    }
-    case TextIndexBehavior::OnlyText:
-    case TextIndexBehavior::TextIndex: {
-        if (isQuickTumbler) {
-            engine_->throwError(QStringLiteral(
-                "This QtAda version can't handle with text from this GUI component"));
+        const auto count = utils::getFromVariant<int>(tools::readProperty(object, "count"));
+        if (count == 0) {
+            context.fail(QStringLiteral("Passed object has no selectable items"));
             return;
         }
 
-        auto textIndex = indexFromText();
-        if (textIndex == -1) {
-            switch (behavior) {
-            case TextIndexBehavior::OnlyText: {
-                engine_->throwError(QStringLiteral("Item with text '%1' does not exist").arg(text));
-                break;
+        auto indexHandler = [&](int currentIndex) {
+            if (currentIndex < 0 || currentIndex >= count) {
+                context.fail(QStringLiteral("Index '%1' is out of range [0, %2)")
+                                 .arg(currentIndex)
+                                 .arg(count));
+                return;
             }
-            case TextIndexBehavior::TextIndex: {
-                emit scriptWarning(QStringLiteral("'%1': item with text '%2' does not exist, "
-                                                  "trying to use index '%3' instead")
-                                       .arg(path)
-                                       .arg(text)
-                                       .arg(index));
-                indexHandler(index);
-                break;
+            if (isWidgetComboBox) {
+                context.invoke(object, "setCurrentIndex", Q_ARG(int, currentIndex));
             }
-            default:
+            else if (isQuickComboBox || isQuickTumbler) {
+                context.writeProperty(object, "currentIndex", currentIndex);
+            }
+            else {
                 Q_UNREACHABLE();
             }
-            return;
+        };
+
+        auto indexFromText = [&] {
+            int textIndex = -1;
+            if (isWidgetComboBox) {
+                bool ok = QMetaObject::invokeMethod(object, "findText", Qt::DirectConnection,
+                                                    Q_RETURN_ARG(int, textIndex),
+                                                    Q_ARG(QString, text));
+                assert(ok == true);
+            }
+            else if (isQuickComboBox) {
+                bool ok = QMetaObject::invokeMethod(object, "find", Qt::DirectConnection,
+                                                    Q_RETURN_ARG(int, textIndex),
+                                                    Q_ARG(QString, text));
+                assert(ok == true);
+            }
+            else {
+                Q_UNREACHABLE();
+            }
+            return textIndex;
+        };
+
+        switch (behavior) {
+        case TextIndexBehavior::OnlyIndex: {
+            indexHandler(index);
+            break;
         }
-        assert(textIndex < count);
-        indexHandler(textIndex);
-        break;
-    }
-    default:
-        Q_UNREACHABLE();
-    }
+        case TextIndexBehavior::OnlyText:
+        case TextIndexBehavior::TextIndex: {
+            if (isQuickTumbler) {
+                context.fail(QStringLiteral(
+                    "This QtAda version can't handle with text from this GUI component"));
+                return;
+            }
+
+            auto textIndex = indexFromText();
+            if (textIndex == -1) {
+                switch (behavior) {
+                case TextIndexBehavior::OnlyText: {
+                    context.fail(
+                        QStringLiteral("Item with text '%1' does not exist").arg(text));
+                    break;
+                }
+                case TextIndexBehavior::TextIndex: {
+                    context.warn(QStringLiteral("'%1': item with text '%2' does not exist, "
+                                                "trying to use index '%3' instead")
+                                     .arg(path)
+                                     .arg(text)
+                                     .arg(index));
+                    indexHandler(index);
+                    break;
+                }
+                default:
+                    Q_UNREACHABLE();
+                }
+                return;
+            }
+            assert(textIndex < count);
+            indexHandler(textIndex);
+            break;
+        }
+        default:
+            Q_UNREACHABLE();
+        }
+    });
 }
 
 void ScriptRunner::selectItem(const QString &path, int index) const noexcept
@@ -874,7 +1498,8 @@ void ScriptRunner::selectItem(const QString &path, const QString &text, int inde
     selectItemTemplate(path, index, text, TextIndexBehavior::TextIndex);
 }
 
-void ScriptRunner::setValueIntoQmlSpinBox(QObject *object, const QString &value) const noexcept
+static void setValueIntoQmlSpinBox(QObject *object, GuiCommandContext &context,
+                                   const QString &value) noexcept
 {
     assert(object != nullptr);
 
@@ -882,21 +1507,21 @@ void ScriptRunner::setValueIntoQmlSpinBox(QObject *object, const QString &value)
         bool ok = false;
         int intValue = value.toInt(&ok);
         if (!ok) {
-            engine_->throwError(
+            context.fail(
                 QStringLiteral("Can't convert '%1' to an integer (required for QML SpinBox)")
                     .arg(value));
         }
         else {
-            writePropertyInGuiThread(object, "value", intValue);
+            context.writeProperty(object, "value", intValue);
         }
     };
 
     auto issueWarningAndFallback = [&](const QString &warningMessage) {
-        emit scriptWarning(warningMessage);
+        context.warn(warningMessage);
         standardWayToSetValue();
     };
 
-    auto rawValueFromText = QQmlProperty::read(object, "valueFromText");
+    auto rawValueFromText = tools::readProperty(object, "valueFromText");
     if (rawValueFromText.canConvert<QJSValue>()) {
         auto valueFromText = rawValueFromText.value<QJSValue>();
         if (valueFromText.isCallable()) {
@@ -914,7 +1539,7 @@ void ScriptRunner::setValueIntoQmlSpinBox(QObject *object, const QString &value)
 
             auto rawValue = valueFromText.call(QJSValueList() << jsValue << jsLocale);
             if (!rawValue.isError() && rawValue.isNumber()) {
-                writePropertyInGuiThread(object, "value", rawValue.toInt());
+                context.writeProperty(object, "value", rawValue.toInt());
             }
             else {
                 issueWarningAndFallback("Invalid result from `valueFromText` for QML SpinBox. "
@@ -932,8 +1557,7 @@ void ScriptRunner::setValueIntoQmlSpinBox(QObject *object, const QString &value)
     }
 }
 
-void ScriptRunner::setValueTemplate(QObject *object, const QString &path,
-                                    double value) const noexcept
+static void setValueTemplate(QObject *object, GuiCommandContext &context, double value) noexcept
 {
     assert(object != nullptr);
 
@@ -947,27 +1571,27 @@ void ScriptRunner::setValueTemplate(QObject *object, const QString &path,
 
     if (!isIntRequiringWidget && !isDoubleRequiringWidget && !isQuickSlider && !isQuickScrollBar
         && !isQuickSpinBox && !isQuickDial) {
-        engine_->throwError(QStringLiteral("This function doesn't support such an object"));
+        context.fail(QStringLiteral("This function doesn't support such an object"));
         return;
     }
-    if (!checkObjectAvailability(object, path)) {
+    if (!context.checkAvailability(object)) {
         return;
     }
 
     if (isIntRequiringWidget) {
-        invokeBlockMethodWithTimeout(object, "setValue", Q_ARG(int, value));
+        context.invoke(object, "setValue", Q_ARG(int, value));
     }
     else if (isDoubleRequiringWidget) {
-        invokeBlockMethodWithTimeout(object, "setValue", Q_ARG(double, value));
+        context.invoke(object, "setValue", Q_ARG(double, value));
     }
     else if (isQuickSlider || isQuickDial) {
-        writePropertyInGuiThread(object, "value", value);
+        context.writeProperty(object, "value", value);
     }
     else if (isQuickScrollBar) {
-        writePropertyInGuiThread(object, "position", value);
+        context.writeProperty(object, "position", value);
     }
     else if (isQuickSpinBox) {
-        setValueIntoQmlSpinBox(object, QString::number(value));
+        setValueIntoQmlSpinBox(object, context, QString::number(value));
     }
     else {
         Q_UNREACHABLE();
@@ -976,33 +1600,27 @@ void ScriptRunner::setValueTemplate(QObject *object, const QString &path,
 
 void ScriptRunner::setValue(const QString &path, double value) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-    setValueTemplate(object, path, value);
+    executeCommand(path, [value](QObject *object, GuiCommandContext &context) {
+        setValueTemplate(object, context, value);
+    });
 }
 
 void ScriptRunner::setValue(const QString &path, double leftValue, double rightValue) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    if (!object->inherits("QQuickRangeSlider")) {
-        engine_->throwError(QStringLiteral("Passed object is not a range slider"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
-    invokeBlockMethodWithTimeout(object, "setValues", Q_ARG(double, leftValue),
-                                 Q_ARG(double, rightValue));
+    executeCommand(path, [leftValue, rightValue](QObject *object, GuiCommandContext &context) {
+        if (!object->inherits("QQuickRangeSlider")) {
+            context.fail(QStringLiteral("Passed object is not a range slider"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
+        context.invoke(object, "setValues", Q_ARG(double, leftValue), Q_ARG(double, rightValue));
+    });
 }
 
-void ScriptRunner::setValueTemplate(QObject *object, const QString &path,
-                                    const QString &value) const noexcept
+static void setValueTemplate(QObject *object, GuiCommandContext &context,
+                             const QString &value) noexcept
 {
     assert(object != nullptr);
 
@@ -1010,10 +1628,10 @@ void ScriptRunner::setValueTemplate(QObject *object, const QString &path,
     const auto isWidgetEdit = object->inherits("QDateTimeEdit");
     const auto isQuickSpinBox = object->inherits("QQuickSpinBox");
     if (!isWidgetCalendar && !isWidgetEdit && !isQuickSpinBox) {
-        engine_->throwError(QStringLiteral("This function doesn't support such an object"));
+        context.fail(QStringLiteral("This function doesn't support such an object"));
         return;
     }
-    if (!checkObjectAvailability(object, path)) {
+    if (!context.checkAvailability(object)) {
         return;
     }
 
@@ -1026,18 +1644,18 @@ void ScriptRunner::setValueTemplate(QObject *object, const QString &path,
         const auto dateTimeValid = !dateTime.isNull() && dateTime.isValid();
 
         if (!dateTimeValid && !timeValid && !dateValid) {
-            engine_->throwError(
+            context.fail(
                 QStringLiteral("Can't convert '%1' to QDateTime (or QDate, or QTime)").arg(value));
             return;
         }
         if (dateTimeValid) {
-            invokeBlockMethodWithTimeout(object, "setDateTime", Q_ARG(QDateTime, dateTime));
+            context.invoke(object, "setDateTime", Q_ARG(QDateTime, dateTime));
         }
         else if (timeValid) {
-            invokeBlockMethodWithTimeout(object, "setTime", Q_ARG(QTime, time));
+            context.invoke(object, "setTime", Q_ARG(QTime, time));
         }
         else if (dateValid) {
-            invokeBlockMethodWithTimeout(object, "setDate", Q_ARG(QDate, date));
+            context.invoke(object, "setDate", Q_ARG(QDate, date));
         }
         else {
             Q_UNREACHABLE();
@@ -1046,13 +1664,13 @@ void ScriptRunner::setValueTemplate(QObject *object, const QString &path,
     else if (isWidgetCalendar) {
         const auto date = QDate::fromString(value, Qt::ISODate);
         if (date.isNull() || !date.isValid()) {
-            engine_->throwError(QStringLiteral("Can't convert '%1' to QDate").arg(value));
+            context.fail(QStringLiteral("Can't convert '%1' to QDate").arg(value));
             return;
         }
-        invokeBlockMethodWithTimeout(object, "setSelectedDate", Q_ARG(QDate, date));
+        context.invoke(object, "setSelectedDate", Q_ARG(QDate, date));
     }
     else if (isQuickSpinBox) {
-        setValueIntoQmlSpinBox(object, value);
+        setValueIntoQmlSpinBox(object, context, value);
     }
     else {
         Q_UNREACHABLE();
@@ -1061,204 +1679,196 @@ void ScriptRunner::setValueTemplate(QObject *object, const QString &path,
 
 void ScriptRunner::setValue(const QString &path, const QString &value) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-    setValueTemplate(object, path, value);
+    executeCommand(path, [value](QObject *object, GuiCommandContext &context) {
+        setValueTemplate(object, context, value);
+    });
 }
 
 void ScriptRunner::changeValue(const QString &path, const QString &type) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
     const auto changeType = utils::changeTypeFromString(type);
     if (!changeType.has_value()) {
         engine_->throwError(QStringLiteral("Unknown change type: '%1'").arg(type));
         return;
     }
 
-    const auto isWidgetSlider = object->inherits("QAbstractSlider");
-    const auto isWidgetSpinBox = object->inherits("QSpinBox") || object->inherits("QDoubleSpinBox");
-    const auto isQuickSpinBox = object->inherits("QQuickSpinBox");
-    if (!isWidgetSlider && !isWidgetSpinBox && !isQuickSpinBox) {
-        engine_->throwError(QStringLiteral("This function doesn't support such an object"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
+    executeCommand(path, [changeType = *changeType](QObject *object,
+                                                    GuiCommandContext &context) {
+        const auto isWidgetSlider = object->inherits("QAbstractSlider");
+        const auto isWidgetSpinBox
+            = object->inherits("QSpinBox") || object->inherits("QDoubleSpinBox");
+        const auto isQuickSpinBox = object->inherits("QQuickSpinBox");
+        if (!isWidgetSlider && !isWidgetSpinBox && !isQuickSpinBox) {
+            context.fail(QStringLiteral("This function doesn't support such an object"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
+
+        if (isWidgetSlider) {
+            auto value = utils::getFromVariant<int>(tools::readProperty(object, "value"));
+
+            switch (changeType) {
+            case ChangeType::Up:
+            case ChangeType::Down:
+            case ChangeType::SingleStepAdd:
+            case ChangeType::SingleStepSub: {
+                const auto singleStep
+                    = utils::getFromVariant<int>(tools::readProperty(object, "singleStep"));
+                const auto isIncrease
+                    = changeType == ChangeType::Up || changeType == ChangeType::SingleStepAdd;
+                value += singleStep * (isIncrease ? 1 : -1);
+                break;
+            }
+            case ChangeType::PageStepAdd:
+            case ChangeType::PageStepSub: {
+                const auto pageStep
+                    = utils::getFromVariant<int>(tools::readProperty(object, "pageStep"));
+                value += pageStep * (changeType == ChangeType::PageStepAdd ? 1 : -1);
+                break;
+            }
+            case ChangeType::ToMinimum: {
+                value = utils::getFromVariant<int>(tools::readProperty(object, "minimum"));
+                break;
+            }
+            case ChangeType::ToMaximum: {
+                value = utils::getFromVariant<int>(tools::readProperty(object, "maximum"));
+                break;
+            }
+            default:
+                Q_UNREACHABLE();
+            }
+
+            context.invoke(object, "setValue", Q_ARG(int, value));
+            return;
+        }
 
-    if (isWidgetSlider) {
-        bool isSliderType = true;
-        auto value = utils::getFromVariant<int>(QQmlProperty::read(object, "value"));
-
-        switch (*changeType) {
-        case ChangeType::Up:
-        case ChangeType::Down:
-        case ChangeType::SingleStepAdd:
-        case ChangeType::SingleStepSub: {
-            const auto singleStep
-                = utils::getFromVariant<int>(QQmlProperty::read(object, "singleStep"));
-            value += (singleStep
-                      * ((*changeType == ChangeType::Up || *changeType == ChangeType::SingleStepAdd)
-                             ? 1
-                             : -1));
+        auto up = [&] {
+            assert(isWidgetSpinBox == true || isQuickSpinBox == true);
+            context.invoke(object, isWidgetSpinBox ? "stepUp" : "increase");
+        };
+        auto down = [&] {
+            assert(isWidgetSpinBox == true || isQuickSpinBox == true);
+            context.invoke(object, isWidgetSpinBox ? "stepDown" : "decrease");
+        };
+
+        switch (changeType) {
+        case ChangeType::Up: {
+            up();
             break;
         }
-        case ChangeType::PageStepAdd:
-        case ChangeType::PageStepSub: {
-            const auto pageStep
-                = utils::getFromVariant<int>(QQmlProperty::read(object, "pageStep"));
-            value += pageStep * (*changeType == ChangeType::PageStepAdd ? 1 : -1);
+        case ChangeType::DblUp: {
+            up();
+            up();
             break;
         }
-        case ChangeType::ToMinimum: {
-            value = utils::getFromVariant<int>(QQmlProperty::read(object, "minimum"));
+        case ChangeType::Down: {
+            down();
             break;
         }
-        case ChangeType::ToMaximum: {
-            value = utils::getFromVariant<int>(QQmlProperty::read(object, "maximum"));
+        case ChangeType::DblDown: {
+            down();
+            down();
             break;
         }
         default:
-            Q_UNREACHABLE();
+            context.fail(QStringLiteral("This object doesn't support such a change type"));
         }
-
-        invokeBlockMethodWithTimeout(object, "setValue", Q_ARG(int, value));
-        return;
-    }
-
-    auto up = [&] {
-        assert(isWidgetSpinBox == true || isQuickSpinBox == true);
-        invokeBlockMethodWithTimeout(object, isWidgetSpinBox ? "stepUp" : "increase");
-    };
-    auto down = [&] {
-        assert(isWidgetSpinBox == true || isQuickSpinBox == true);
-        invokeBlockMethodWithTimeout(object, isWidgetSpinBox ? "stepDown" : "decrease");
-    };
-
-    switch (*changeType) {
-    case ChangeType::Up: {
-        up();
-        break;
-    }
-    case ChangeType::DblUp: {
-        up();
-        up();
-        break;
-    }
-    case ChangeType::Down: {
-        down();
-        break;
-    }
-    case ChangeType::DblDown: {
-        down();
-        down();
-        break;
-    }
-    default:
-        engine_->throwError(QStringLiteral("This object doesn't support such a change type"));
-    }
+    });
 }
 
 void ScriptRunner::setDelayProgress(const QString &path, double delay) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    if (!object->inherits("QQuickDelayButton")) {
-        engine_->throwError(QStringLiteral("Passed object is not a delay button"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
-    writePropertyInGuiThread(object, "progress", delay);
+    executeCommand(path, [delay](QObject *object, GuiCommandContext &context) {
+        if (!object->inherits("QQuickDelayButton")) {
+            context.fail(QStringLiteral("Passed object is not a delay button"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
+        context.writeProperty(object, "progress", delay);
+    });
 }
 
 void ScriptRunner::selectTabItemTemplate(const QString &path, int index, const QString &text,
                                          TextIndexBehavior behavior) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    if (!object->inherits("QTabBar")) {
-        engine_->throwError(QStringLiteral("Passed object is not a tab widget"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
-
-    const auto count = utils::getFromVariant<int>(QQmlProperty::read(object, "count"));
-    if (count == 0) {
-        engine_->throwError(QStringLiteral("Passed object has no selectable items"));
-        return;
-    }
+    executeCommand(path, [path, index, text, behavior](QObject *object,
+                                                       GuiCommandContext &context) {
+        if (!object->inherits("QTabBar")) {
+            context.fail(QStringLiteral("Passed object is not a tab widget"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
 
-    auto indexHandler = [&](int currentIndex) {
-        if (currentIndex < 0 || currentIndex >= count) {
-            engine_->throwError(
-                QStringLiteral("Index '%1' is out of range [0, %2)").arg(currentIndex).arg(count));
+        const auto count = utils::getFromVariant<int>(tools::readProperty(object, "count"));
+        if (count == 0) {
+            context.fail(QStringLiteral("Passed object has no selectable items"));
             return;
         }
-        invokeBlockMethodWithTimeout(object, "setCurrentIndex", Q_ARG(int, currentIndex));
-    };
 
-    auto indexFromText = [&] {
-        for (int i = 0; i < count; i++) {
-            QString currentText;
-            bool ok = QMetaObject::invokeMethod(object, "tabText", Qt::BlockingQueuedConnection,
-                                                Q_RETURN_ARG(QString, currentText), Q_ARG(int, i));
-            assert(ok == true);
-            if (currentText == text) {
-                return i;
+        auto indexHandler = [&](int currentIndex) {
+            if (currentIndex < 0 || currentIndex >= count) {
+                context.fail(QStringLiteral("Index '%1' is out of range [0, %2)")
+                                 .arg(currentIndex)
+                                 .arg(count));
+                return;
             }
-        }
-        return -1;
-    };
+            context.invoke(object, "setCurrentIndex", Q_ARG(int, currentIndex));
+        };
+
+        auto indexFromText = [&] {
+            for (int i = 0; i < count; i++) {
+                QString currentText;
+                bool ok = QMetaObject::invokeMethod(object, "tabText", Qt::DirectConnection,
+                                                    Q_RETURN_ARG(QString, currentText),
+                                                    Q_ARG(int, i));
+                assert(ok == true);
+                if (currentText == text) {
+                    return i;
+                }
+            }
+            return -1;
+        };
 
-    switch (behavior) {
-    case TextIndexBehavior::OnlyIndex: {
-        indexHandler(index);
-        break;
-    }
-    case TextIndexBehavior::OnlyText: {
-        auto textIndex = indexFromText();
-        if (textIndex == -1) {
-            engine_->throwError(QStringLiteral("Tab with text '%1' does not exist").arg(text));
-            break;
-        }
-        indexHandler(textIndex);
-        break;
-    }
-    case TextIndexBehavior::TextIndex: {
-        auto textIndex = indexFromText();
-        if (textIndex == -1) {
-            emit scriptWarning(QStringLiteral("'%1': tab with text '%2' does not exist, "
-                                              "trying to use index '%3' instead")
-                                   .arg(path)
-                                   .arg(text)
-                                   .arg(index));
+        switch (behavior) {
+        case TextIndexBehavior::OnlyIndex: {
             indexHandler(index);
+            break;
         }
-        else {
-            assert(textIndex < count);
+        case TextIndexBehavior::OnlyText: {
+            auto textIndex = indexFromText();
+            if (textIndex == -1) {
+                context.fail(QStringLiteral("Tab with text '%1' does not exist").arg(text));
+                break;
+            }
             indexHandler(textIndex);
+            break;
         }
-        break;
-    }
-    default:
-        Q_UNREACHABLE();
-    }
+        case TextIndexBehavior::TextIndex: {
+            auto textIndex = indexFromText();
+            if (textIndex == -1) {
+                context.warn(QStringLiteral("'%1': tab with text '%2' does not exist, "
+                                            "trying to use index '%3' instead")
+                                 .arg(path)
+                                 .arg(text)
+                                 .arg(index));
+                indexHandler(index);
+            }
+            else {
+                assert(textIndex < count);
+                indexHandler(textIndex);
+            }
+            break;
+        }
+        default:
+            Q_UNREACHABLE();
+        }
+    });
 }
 
 void ScriptRunner::selectTabItem(const QString &path, int index) const noexcept
@@ -1279,52 +1889,49 @@ void ScriptRunner::selectTabItem(const QString &path, const QString &text, int i
 void ScriptRunner::treeViewTemplate(const QString &path, const QList<int> &indexPath,
                                     bool isExpand) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    if (!object->inherits("QTreeView")) {
-        engine_->throwError(QStringLiteral("Passed object is not a tree"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
-
-    auto *view = qobject_cast<QAbstractItemView *>(object);
-    assert(view != nullptr);
-    auto *model = view->model();
-
-    if (model == nullptr) {
-        engine_->throwError(QStringLiteral("Object model is not accessible"));
-        return;
-    }
-
-    QModelIndex lastIndex;
-    for (const auto &row : indexPath) {
-        QModelIndex index;
-        if (lastIndex.isValid()) {
-            index = model->index(row, 0, lastIndex);
+    executeCommand(path, [indexPath, isExpand](QObject *object, GuiCommandContext &context) {
+        if (!object->inherits("QTreeView")) {
+            context.fail(QStringLiteral("Passed object is not a tree"));
+            return;
         }
-        else {
-            index = model->index(row, 0);
+        if (!context.checkAvailability(object)) {
+            return;
         }
 
-        if (!index.isValid()) {
-            engine_->throwError(QStringLiteral("Can't get accesible model index from path"));
+        auto *view = qobject_cast<QAbstractItemView *>(object);
+        assert(view != nullptr);
+        auto *model = view->model();
+
+        if (model == nullptr) {
+            context.fail(QStringLiteral("Object model is not accessible"));
             return;
         }
 
-        if (isExpand) {
-            invokeBlockMethodWithTimeout(object, "expand", Q_ARG(QModelIndex, index));
+        QModelIndex lastIndex;
+        for (const auto &row : indexPath) {
+            QModelIndex index;
+            if (lastIndex.isValid()) {
+                index = model->index(row, 0, lastIndex);
+            }
+            else {
+                index = model->index(row, 0);
+            }
+
+            if (!index.isValid()) {
+                context.fail(QStringLiteral("Can't get accesible model index from path"));
+                return;
+            }
+
+            if (isExpand) {
+                context.invoke(object, "expand", Q_ARG(QModelIndex, index));
+            }
+            lastIndex = index;
         }
-        lastIndex = index;
-    }
 
-    if (!isExpand) {
-        invokeBlockMethodWithTimeout(object, "collapse", Q_ARG(QModelIndex, lastIndex));
-    }
+        if (!isExpand) {
+            context.invoke(object, "collapse", Q_ARG(QModelIndex, lastIndex));
+        }
+    });
 }
 
 void ScriptRunner::expandDelegate(const QString &path, const QList<int> &indexPath) const noexcept
@@ -1345,66 +1952,60 @@ void ScriptRunner::undoCommand(const QString &path, int index) const noexcept
 
 void ScriptRunner::selectViewItem(const QString &path, int index) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    if (!object->inherits("QQuickPathView") && !object->inherits("QQuickSwipeView")) {
-        engine_->throwError(QStringLiteral("Passed object is not a path or swipe view"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
+    executeCommand(path, [index](QObject *object, GuiCommandContext &context) {
+        if (!object->inherits("QQuickPathView") && !object->inherits("QQuickSwipeView")) {
+            context.fail(QStringLiteral("Passed object is not a path or swipe view"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
 
-    const auto count = utils::getFromVariant<int>(QQmlProperty::read(object, "count"));
-    if (count == 0) {
-        engine_->throwError(QStringLiteral("Passed object has no selectable items"));
-        return;
-    }
+        const auto count = utils::getFromVariant<int>(tools::readProperty(object, "count"));
+        if (count == 0) {
+            context.fail(QStringLiteral("Passed object has no selectable items"));
+            return;
+        }
 
-    if (index < 0 || index >= count) {
-        engine_->throwError(
-            QStringLiteral("Index '%1' is out of range [0, %2)").arg(index).arg(count));
-        return;
-    }
-    writePropertyInGuiThread(object, "currentIndex", index);
+        if (index < 0 || index >= count) {
+            context.fail(
+                QStringLiteral("Index '%1' is out of range [0, %2)").arg(index).arg(count));
+            return;
+        }
+        context.writeProperty(object, "currentIndex", index);
+    });
 }
 
 void ScriptRunner::actionTemplate(const QString &path, std::optional<bool> isChecked) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
+    executeCommand(path, [path, isChecked](QObject *object, GuiCommandContext &context) {
+        if (!object->inherits("QAction")) {
+            context.fail(QStringLiteral("Passed object is not an action"));
+            return;
+        }
+        if (!context.checkAvailability(object, false)) {
+            return;
+        }
 
-    if (!object->inherits("QAction")) {
-        engine_->throwError(QStringLiteral("Passed object is not an action"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path, false)) {
-        return;
-    }
-
-    if (!isChecked.has_value()) {
-        invokeBlockMethodWithTimeout(object, "trigger");
-        return;
-    }
+        if (!isChecked.has_value()) {
+            context.invoke(object, "trigger");
+            return;
+        }
 
-    if (!utils::getFromVariant<bool>(QQmlProperty::read(object, "checkable"))) {
-        engine_->throwError(QStringLiteral("Action is not checkable"));
-        return;
-    }
+        if (!utils::getFromVariant<bool>(tools::readProperty(object, "checkable"))) {
+            context.fail(QStringLiteral("Action is not checkable"));
+            return;
+        }
 
-    if (utils::getFromVariant<bool>(QQmlProperty::read(object, "checked")) == *isChecked) {
-        emit scriptWarning(QStringLiteral("'%1': button already has state '%2'")
-                               .arg(path)
-                               .arg(*isChecked ? "true" : "false"));
-    }
-    else {
-        invokeBlockMethodWithTimeout(object, "toggle");
-    }
+        if (utils::getFromVariant<bool>(tools::readProperty(object, "checked")) == *isChecked) {
+            context.warn(QStringLiteral("'%1': button already has state '%2'")
+                             .arg(path)
+                             .arg(*isChecked ? "true" : "false"));
+        }
+        else {
+            context.invoke(object, "toggle");
+        }
+    });
 }
 
 void ScriptRunner::triggerAction(const QString &path) const noexcept
@@ -1419,53 +2020,46 @@ void ScriptRunner::triggerAction(const QString &path, bool isChecked) const noex
 
 void ScriptRunner::delegateTemplate(const QString &path, int index, bool isDouble) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    if (!object->inherits("QQuickItemView")) {
-        engine_->throwError(QStringLiteral("Passed object is not an item view"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path, false)) {
-        return;
-    }
-
-    const auto count = utils::getFromVariant<int>(QQmlProperty::read(object, "count"));
-    if (count == 0) {
-        engine_->throwError(QStringLiteral("Passed object has no delegates"));
-        return;
-    }
+    executeCommand(path, [index, isDouble](QObject *object, GuiCommandContext &context) {
+        if (!object->inherits("QQuickItemView")) {
+            context.fail(QStringLiteral("Passed object is not an item view"));
+            return;
+        }
+        if (!context.checkAvailability(object, false)) {
+            return;
+        }
 
-    if (index < 0 || index >= count) {
-        engine_->throwError(
-            QStringLiteral("Index '%1' is out of range [0, %2)").arg(index).arg(count));
-        return;
-    }
+        const auto count = utils::getFromVariant<int>(tools::readProperty(object, "count"));
+        if (count == 0) {
+            context.fail(QStringLiteral("Passed object has no delegates"));
+            return;
+        }
 
-    QQuickItem *item = nullptr;
-    bool ok = QMetaObject::invokeMethod(object, "itemAtIndex", Qt::BlockingQueuedConnection,
-                                        Q_RETURN_ARG(QQuickItem *, item), Q_ARG(int, index));
-    assert(ok == true);
+        if (index < 0 || index >= count) {
+            context.fail(
+                QStringLiteral("Index '%1' is out of range [0, %2)").arg(index).arg(count));
+            return;
+        }
 
-    if (item == nullptr) {
-        engine_->throwError(
-            QStringLiteral("Delegate with index '%1' is not accessible").arg(index));
-        return;
-    }
+        QQuickItem *item = nullptr;
+        bool ok = QMetaObject::invokeMethod(object, "itemAtIndex", Qt::DirectConnection,
+                                            Q_RETURN_ARG(QQuickItem *, item), Q_ARG(int, index));
+        assert(ok == true);
 
-    const auto height = utils::getFromVariant<double>(QQmlProperty::read(object, "height"));
-    const auto width = utils::getFromVariant<double>(QQmlProperty::read(object, "width"));
-    const auto pos = QPoint(width / 2, height / 2);
+        if (item == nullptr) {
+            context.fail(QStringLiteral("Delegate with index '%1' is not accessible").arg(index));
+            return;
+        }
 
-    if (isDouble) {
-        postEvents(item, { simpleMouseEvent(QEvent::MouseButtonDblClick, pos) });
-    }
-    else {
-        postEvents(item, { simpleMouseEvent(QEvent::MouseButtonPress, pos),
-                           simpleMouseEvent(QEvent::MouseButtonRelease, pos) });
-    }
+        const auto pos = itemCenter(object);
+        if (isDouble) {
+            context.postEvents(item, { simpleMouseEvent(QEvent::MouseButtonDblClick, pos) });
+        }
+        else {
+            context.postEvents(item, { simpleMouseEvent(QEvent::MouseButtonPress, pos),
+                                       simpleMouseEvent(QEvent::MouseButtonRelease, pos) });
+        }
+    });
 }
 
 void ScriptRunner::delegateClick(const QString &path, int index) const noexcept
@@ -1482,88 +2076,86 @@ void ScriptRunner::delegateTemplate(const QString &path, std::optional<QList<int
                                     std::optional<std::pair<int, int>> index,
                                     bool isDouble) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    bool isTreeView = false;
-    bool isUsualView = false;
+    executeCommand(path, [indexPath, index, isDouble](QObject *object,
+                                                      GuiCommandContext &context) {
+        bool isTreeView = false;
+        bool isUsualView = false;
 
-    if (indexPath.has_value()) {
-        assert(!index.has_value());
-        isTreeView = object->inherits("QTreeView");
-    }
-    else if (index.has_value()) {
-        assert(!indexPath.has_value());
-        isUsualView = object->inherits("QAbstractItemView");
-    }
-    else {
-        Q_UNREACHABLE();
-    }
+        if (indexPath.has_value()) {
+            assert(!index.has_value());
+            isTreeView = object->inherits("QTreeView");
+        }
+        else if (index.has_value()) {
+            assert(!indexPath.has_value());
+            isUsualView = object->inherits("QAbstractItemView");
+        }
+        else {
+            Q_UNREACHABLE();
+        }
 
-    if (!isTreeView && !isUsualView) {
-        engine_->throwError(QStringLiteral("Passed object is not a %1")
-                                .arg(indexPath.has_value() ? "tree" : "view"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
+        if (!isTreeView && !isUsualView) {
+            context.fail(QStringLiteral("Passed object is not a %1")
+                             .arg(indexPath.has_value() ? "tree" : "view"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
 
-    auto *view = qobject_cast<QAbstractItemView *>(object);
-    assert(view != nullptr);
-    auto *model = view->model();
+        auto *view = qobject_cast<QAbstractItemView *>(object);
+        assert(view != nullptr);
+        auto *model = view->model();
 
-    if (model == nullptr) {
-        engine_->throwError(QStringLiteral("Object model is not accessible"));
-        return;
-    }
+        if (model == nullptr) {
+            context.fail(QStringLiteral("Object model is not accessible"));
+            return;
+        }
 
-    QModelIndex lastIndex;
-    if (isTreeView) {
-        assert(!index.has_value());
-        for (const auto &row : *indexPath) {
-            QModelIndex index;
-            if (lastIndex.isValid()) {
-                index = model->index(row, 0, lastIndex);
-            }
-            else {
-                index = model->index(row, 0);
-            }
+        QModelIndex lastIndex;
+        if (isTreeView) {
+            assert(!index.has_value());
+            for (const auto &row : *indexPath) {
+                QModelIndex index;
+                if (lastIndex.isValid()) {
+                    index = model->index(row, 0, lastIndex);
+                }
+                else {
+                    index = model->index(row, 0);
+                }
 
-            if (!index.isValid()) {
-                engine_->throwError(QStringLiteral("Can't get accesible model index from path"));
-                return;
+                if (!index.isValid()) {
+                    context.fail(QStringLiteral("Can't get accesible model index from path"));
+                    return;
+                }
+                lastIndex = index;
             }
-            lastIndex = index;
         }
-    }
-    else if (isUsualView) {
-        lastIndex = model->index(index->first, index->second);
-    }
-    else {
-        Q_UNREACHABLE();
-    }
+        else if (isUsualView) {
+            lastIndex = model->index(index->first, index->second);
+        }
+        else {
+            Q_UNREACHABLE();
+        }
 
-    const auto rect = view->visualRect(lastIndex);
-    if (rect.isEmpty() || rect.isNull()) {
-        engine_->throwError(QStringLiteral("Delegate is not accessible"));
-        return;
-    }
+        const auto rect = view->visualRect(lastIndex);
+        if (rect.isEmpty() || rect.isNull()) {
+            context.fail(QStringLiteral("Delegate is not accessible"));
+            return;
+        }
 
-    const auto pos = rect.center();
-    auto *viewport = view->viewport();
-    assert(viewport != nullptr);
+        const auto pos = rect.center();
+        auto *viewport = view->viewport();
+        assert(viewport != nullptr);
 
-    std::vector<QEvent *> events;
-    events.push_back(simpleMouseEvent(QEvent::MouseButtonPress, pos));
-    events.push_back(simpleMouseEvent(QEvent::MouseButtonRelease, pos));
-    if (isDouble) {
-        events.push_back(simpleMouseEvent(QEvent::MouseButtonDblClick, pos));
+        std::vector<QEvent *> events;
+        events.push_back(simpleMouseEvent(QEvent::MouseButtonPress, pos));
         events.push_back(simpleMouseEvent(QEvent::MouseButtonRelease, pos));
-    }
-    postEvents(viewport, events);
+        if (isDouble) {
+            events.push_back(simpleMouseEvent(QEvent::MouseButtonDblClick, pos));
+            events.push_back(simpleMouseEvent(QEvent::MouseButtonRelease, pos));
+        }
+        context.postEvents(viewport, events);
+    });
 }
 
 void ScriptRunner::delegateClick(const QString &path, QList<int> indexPath) const noexcept
@@ -1588,278 +2180,269 @@ void ScriptRunner::delegateDblClick(const QString &path, int row, int column) co
 
 void ScriptRunner::setSelection(const QString &path, const QJSValue &selectionData) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    if (!object->inherits("QAbstractItemView")) {
-        engine_->throwError(QStringLiteral("Passed object is not a view"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
-
-    auto *view = qobject_cast<QAbstractItemView *>(object);
-    assert(view != nullptr);
-    auto *model = view->model();
-    if (model == nullptr) {
-        engine_->throwError(QStringLiteral("Object model is not accessible"));
-        return;
-    }
-    auto *selectionModel = view->selectionModel();
-    if (selectionModel == nullptr) {
-        engine_->throwError(QStringLiteral("Object selection model is not accessible"));
-        return;
-    }
+    // QJSValue можно использовать только в потоке движка скрипта, поэтому в GUI-поток
+    // передаем уже преобразованные в QVariant данные
+    executeCommand(path, [data = selectionData.toVariant()](QObject *object,
+                                                           GuiCommandContext &context) {
+        if (!object->inherits("QAbstractItemView")) {
+            context.fail(QStringLiteral("Passed object is not a view"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
 
-    bool isOk = true;
-    const auto rowCount = model->rowCount();
-    const auto columnCount = model->columnCount();
-    const auto data = parseSelectionData(selectionData, isOk, rowCount, columnCount, engine_);
-    if (!isOk) {
-        return;
-    }
+        auto *view = qobject_cast<QAbstractItemView *>(object);
+        assert(view != nullptr);
+        auto *model = view->model();
+        if (model == nullptr) {
+            context.fail(QStringLiteral("Object model is not accessible"));
+            return;
+        }
+        auto *selectionModel = view->selectionModel();
+        if (selectionModel == nullptr) {
+            context.fail(QStringLiteral("Object selection model is not accessible"));
+            return;
+        }
 
-    QItemSelection selection;
-    invokeBlockMethodWithTimeout(selectionModel, "clearSelection");
-    //! TODO: слишком много дублирования кода, нужно будет переписать
-    for (const auto &pair : data) {
-        const auto &rawRow = pair.first;
-        const auto &rawColumn = pair.second;
-        const auto rawRowType = rawRow.type();
-        const auto rawColumnType = rawColumn.type();
+        const auto rowCount = model->rowCount();
+        const auto columnCount = model->columnCount();
+        const auto parsedData = parseSelectionData(data, rowCount, columnCount, context);
+        if (context.hasFailed()) {
+            return;
+        }
 
-        if (rawRowType == QVariant::Bool) {
-            if (rawColumnType == QVariant::Bool) {
-                for (int r = 0; r < rowCount; r++) {
+        QItemSelection selection;
+        context.invoke(selectionModel, "clearSelection");
+        //! TODO: слишком много дублирования кода, нужно будет переписать
+        for (const auto &pair : parsedData) {
+            const auto &rawRow = pair.first;
+            const auto &rawColumn = pair.second;
+            const auto rawRowType = rawRow.type();
+            const auto rawColumnType = rawColumn.type();
+
+            if (rawRowType == QVariant::Bool) {
+                if (rawColumnType == QVariant::Bool) {
+                    for (int r = 0; r < rowCount; r++) {
+                        for (int c = 0; c < columnCount; c++) {
+                            auto index = model->index(r, c);
+                            selection.select(index, index);
+                        }
+                    }
+                    break;
+                }
+                else {
+                    const auto cols = rawColumn.value<QList<int>>();
+                    assert(!cols.isEmpty());
+                    for (int r = 0; r < rowCount; r++) {
+                        for (const auto &c : cols) {
+                            auto index = model->index(r, c);
+                            selection.select(index, index);
+                        }
+                    }
+                }
+            }
+            else if (rawRowType == QVariant::Int) {
+                const auto row = rawRow.toInt();
+                if (rawColumnType == QVariant::Bool) {
                     for (int c = 0; c < columnCount; c++) {
-                        auto index = model->index(r, c);
+                        auto index = model->index(row, c);
                         selection.select(index, index);
                     }
                 }
-                break;
-            }
-            else {
-                const auto cols = rawColumn.value<QList<int>>();
-                assert(!cols.isEmpty());
-                for (int r = 0; r < rowCount; r++) {
+                else {
+                    const auto cols = rawColumn.value<QList<int>>();
+                    assert(!cols.isEmpty());
                     for (const auto &c : cols) {
-                        auto index = model->index(r, c);
+                        auto index = model->index(row, c);
                         selection.select(index, index);
                     }
                 }
             }
-        }
-        else if (rawRowType == QVariant::Int) {
-            const auto row = rawRow.toInt();
-            if (rawColumnType == QVariant::Bool) {
-                for (int c = 0; c < columnCount; c++) {
-                    auto index = model->index(row, c);
-                    selection.select(index, index);
-                }
-            }
             else {
-                const auto cols = rawColumn.value<QList<int>>();
-                assert(!cols.isEmpty());
-                for (const auto &c : cols) {
-                    auto index = model->index(row, c);
-                    selection.select(index, index);
-                }
+                Q_UNREACHABLE();
             }
         }
-        else {
-            Q_UNREACHABLE();
-        }
-    }
-    invokeBlockMethodWithTimeout(
-        selectionModel, "select", Q_ARG(QItemSelection, selection),
-        Q_ARG(QItemSelectionModel::SelectionFlags, QItemSelectionModel::Select));
+        context.invoke(selectionModel, "select", Q_ARG(QItemSelection, selection),
+                       Q_ARG(QItemSelectionModel::SelectionFlags, QItemSelectionModel::Select));
+    });
 }
 
 void ScriptRunner::clearSelection(const QString &path) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    if (!object->inherits("QAbstractItemView")) {
-        engine_->throwError(QStringLiteral("Passed object is not a view"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
+    executeCommand(path, [](QObject *object, GuiCommandContext &context) {
+        if (!object->inherits("QAbstractItemView")) {
+            context.fail(QStringLiteral("Passed object is not a view"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
 
-    auto *view = qobject_cast<QAbstractItemView *>(object);
-    assert(view != nullptr);
-    auto *selectionModel = view->selectionModel();
-    if (selectionModel == nullptr) {
-        engine_->throwError(QStringLiteral("Object selection model is not accessible"));
-        return;
-    }
-    invokeBlockMethodWithTimeout(selectionModel, "clearSelection");
+        auto *view = qobject_cast<QAbstractItemView *>(object);
+        assert(view != nullptr);
+        auto *selectionModel = view->selectionModel();
+        if (selectionModel == nullptr) {
+            context.fail(QStringLiteral("Object selection model is not accessible"));
+            return;
+        }
+        context.invoke(selectionModel, "clearSelection");
+    });
 }
 
 void ScriptRunner::setText(const QString &path, const QString &text) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
+    executeCommand(path, [text](QObject *object, GuiCommandContext &context) {
+        //! TODO: Нужно тщательней проверить какие еще компоненты могут иметь "под копотом"
+        //! QLineEdit, чтобы избежать ошибки "Passed object is not an text edit".
+        const auto isWidgetComboBox = object->inherits("QComboBox");
+        const auto isWidgetSpinBox = object->inherits("QAbstractSpinBox");
+        const auto isQuickComboBox = object->inherits("QQuickComboBox");
+        const auto isQuickSpinBox = object->inherits("QQuickSpinBox");
+        if (isWidgetComboBox || isWidgetSpinBox || isQuickComboBox || isQuickSpinBox) {
+            const auto isEditable
+                = isWidgetSpinBox
+                      ? !utils::getFromVariant<bool>(tools::readProperty(object, "readOnly"))
+                      : utils::getFromVariant<bool>(tools::readProperty(object, "editable"));
+            if (!isEditable) {
+                context.fail(
+                    QStringLiteral("Passed %1 is not editable")
+                        .arg(isWidgetComboBox || isQuickComboBox ? "ComboBox" : "SpinBox"));
+                return;
+            }
 
-    //! TODO: Нужно тщательней проверить какие еще компоненты могут иметь "под копотом"
-    //! QLineEdit, чтобы избежать ошибки "Passed object is not an text edit".
-    const auto isWidgetComboBox = object->inherits("QComboBox");
-    const auto isWidgetSpinBox = object->inherits("QAbstractSpinBox");
-    const auto isQuickComboBox = object->inherits("QQuickComboBox");
-    const auto isQuickSpinBox = object->inherits("QQuickSpinBox");
-    if (isWidgetComboBox || isWidgetSpinBox || isQuickComboBox || isQuickSpinBox) {
-        const auto isEditable
-            = isWidgetSpinBox ? !utils::getFromVariant<bool>(QQmlProperty::read(object, "readOnly"))
-                              : utils::getFromVariant<bool>(QQmlProperty::read(object, "editable"));
-        if (!isEditable) {
-            engine_->throwError(
-                QStringLiteral("Passed %1 is not editable")
-                    .arg(isWidgetComboBox || isQuickComboBox ? "ComboBox" : "SpinBox"));
-            return;
-        }
-
-        if (isWidgetSpinBox) {
-            if (object->inherits("QSpinBox") || object->inherits("QDoubleSpinBox")) {
-                bool isOk = false;
-                auto doubleValue = QLocale::system().toDouble(text, &isOk);
-                if (!isOk) {
-                    engine_->throwError(
-                        QStringLiteral("Can't convert '%1' to a number (required for QSpinBox and "
-                                       "QDoubleSpinBox)")
-                            .arg(text));
-                    return;
+            if (isWidgetSpinBox) {
+                if (object->inherits("QSpinBox") || object->inherits("QDoubleSpinBox")) {
+                    bool isOk = false;
+                    auto doubleValue = QLocale::system().toDouble(text, &isOk);
+                    if (!isOk) {
+                        context.fail(QStringLiteral(
+                                         "Can't convert '%1' to a number (required for QSpinBox "
+                                         "and QDoubleSpinBox)")
+                                         .arg(text));
+                        return;
+                    }
+                    setValueTemplate(object, context, doubleValue);
+                }
+                else {
+                    setValueTemplate(object, context, text);
                 }
-                setValueTemplate(object, path, doubleValue);
+            }
+            else if (isWidgetComboBox) {
+                context.invoke(object, "setEditText", Q_ARG(QString, text));
+            }
+            else if (isQuickSpinBox) {
+                setValueTemplate(object, context, text);
+            }
+            else if (isQuickComboBox) {
+                context.writeProperty(object, "editText", text);
             }
             else {
-                setValueTemplate(object, path, text);
+                Q_UNREACHABLE();
             }
+            return;
+        }
+
+        const auto isQuickTextEdit
+            = object->inherits("QQuickTextEdit") || object->inherits("QQuickTextInput");
+        const auto isWidgetTextEdit
+            = object->inherits("QTextEdit") || object->inherits("QLineEdit");
+        const auto isWidgetPlainTextEdit = object->inherits("QPlainTextEdit");
+        const auto isWidgetKeySeqEdit = object->inherits("QKeySequenceEdit");
+
+        if (!isQuickTextEdit && !isWidgetTextEdit && !isWidgetPlainTextEdit
+            && !isWidgetKeySeqEdit) {
+            context.fail(QStringLiteral("Passed object is not an text edit"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
+
+        if (isQuickTextEdit) {
+            context.writeProperty(object, "text", text);
         }
-        else if (isWidgetComboBox) {
-            invokeBlockMethodWithTimeout(object, "setEditText", Q_ARG(QString, text));
+        else if (isWidgetTextEdit) {
+            context.invoke(object, "setText", Q_ARG(QString, text));
         }
-        else if (isQuickSpinBox) {
-            setValueTemplate(object, path, text);
+        else if (isWidgetPlainTextEdit) {
+            context.invoke(object, "setPlainText", Q_ARG(QString, text));
         }
-        else if (isQuickComboBox) {
-            writePropertyInGuiThread(object, "editText", text);
+        else if (isWidgetKeySeqEdit) {
+            context.invoke(object, "setKeySequence", Q_ARG(QKeySequence, QKeySequence(text)));
         }
         else {
             Q_UNREACHABLE();
         }
-        return;
-    }
-
-    const auto isQuickTextEdit
-        = object->inherits("QQuickTextEdit") || object->inherits("QQuickTextInput");
-    const auto isWidgetTextEdit = object->inherits("QTextEdit") || object->inherits("QLineEdit");
-    const auto isWidgetPlainTextEdit = object->inherits("QPlainTextEdit");
-    const auto isWidgetKeySeqEdit = object->inherits("QKeySequenceEdit");
-
-    if (!isQuickTextEdit && !isWidgetTextEdit && !isWidgetPlainTextEdit && !isWidgetKeySeqEdit) {
-        engine_->throwError(QStringLiteral("Passed object is not an text edit"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
-
-    if (isQuickTextEdit) {
-        writePropertyInGuiThread(object, "text", text);
-    }
-    else if (isWidgetTextEdit) {
-        invokeBlockMethodWithTimeout(object, "setText", Q_ARG(QString, text));
-    }
-    else if (isWidgetPlainTextEdit) {
-        invokeBlockMethodWithTimeout(object, "setPlainText", Q_ARG(QString, text));
-    }
-    else if (isWidgetKeySeqEdit) {
-        invokeBlockMethodWithTimeout(object, "setKeySequence",
-                                     Q_ARG(QKeySequence, QKeySequence(text)));
-    }
-    else {
-        Q_UNREACHABLE();
-    }
+    });
 }
 
 void ScriptRunner::setTextTemplate(const QString &path, std::optional<QList<int>> indexPath,
                                    std::optional<std::pair<int, int>> index,
                                    const QString &text) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
+    executeCommand(path, [indexPath, index, text](QObject *object, GuiCommandContext &context) {
+        bool isTreeView = false;
+        bool isUsualView = false;
 
-    bool isTreeView = false;
-    bool isUsualView = false;
-
-    if (indexPath.has_value()) {
-        assert(!index.has_value());
-        isTreeView = object->inherits("QTreeView");
-    }
-    else if (index.has_value()) {
-        assert(!indexPath.has_value());
-        isUsualView = object->inherits("QAbstractItemView");
-    }
-    else {
-        Q_UNREACHABLE();
-    }
+        if (indexPath.has_value()) {
+            assert(!index.has_value());
+            isTreeView = object->inherits("QTreeView");
+        }
+        else if (index.has_value()) {
+            assert(!indexPath.has_value());
+            isUsualView = object->inherits("QAbstractItemView");
+        }
+        else {
+            Q_UNREACHABLE();
+        }
 
-    if (!isTreeView && !isUsualView) {
-        engine_->throwError(QStringLiteral("Passed object is not a %1")
-                                .arg(indexPath.has_value() ? "tree" : "view"));
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
+        if (!isTreeView && !isUsualView) {
+            context.fail(QStringLiteral("Passed object is not a %1")
+                             .arg(indexPath.has_value() ? "tree" : "view"));
+            return;
+        }
+        if (!context.checkAvailability(object)) {
+            return;
+        }
 
-    auto *view = qobject_cast<QAbstractItemView *>(object);
-    assert(view != nullptr);
-    auto *model = view->model();
+        auto *view = qobject_cast<QAbstractItemView *>(object);
+        assert(view != nullptr);
+        auto *model = view->model();
 
-    if (model == nullptr) {
-        engine_->throwError(QStringLiteral("Object model is not accessible"));
-        return;
-    }
+        if (model == nullptr) {
+            context.fail(QStringLiteral("Object model is not accessible"));
+            return;
+        }
 
-    QModelIndex lastIndex;
-    if (isTreeView) {
-        assert(!index.has_value());
-        for (const auto &row : *indexPath) {
-            QModelIndex index;
-            if (lastIndex.isValid()) {
-                index = model->index(row, 0, lastIndex);
-            }
-            else {
-                index = model->index(row, 0);
-            }
+        QModelIndex lastIndex;
+        if (isTreeView) {
+            assert(!index.has_value());
+            for (const auto &row : *indexPath) {
+                QModelIndex index;
+                if (lastIndex.isValid()) {
+                    index = model->index(row, 0, lastIndex);
+                }
+                else {
+                    index = model->index(row, 0);
+                }
 
-            if (!index.isValid()) {
-                engine_->throwError(QStringLiteral("Can't get accesible model index from path"));
-                return;
+                if (!index.isValid()) {
+                    context.fail(QStringLiteral("Can't get accesible model index from path"));
+                    return;
+                }
+                lastIndex = index;
             }
-            lastIndex = index;
         }
-    }
-    else if (isUsualView) {
-        lastIndex = model->index(index->first, index->second);
-    }
-    else {
-        Q_UNREACHABLE();
-    }
-    invokeBlockMethodWithTimeout(model, "setData", Q_ARG(QModelIndex, lastIndex),
-                                 Q_ARG(QVariant, QVariant(text)), Q_ARG(int, Qt::EditRole));
+        else if (isUsualView) {
+            lastIndex = model->index(index->first, index->second);
+        }
+        else {
+            Q_UNREACHABLE();
+        }
+        context.invoke(model, "setData", Q_ARG(QModelIndex, lastIndex),
+                       Q_ARG(QVariant, QVariant(text)), Q_ARG(int, Qt::EditRole));
+    });
 }
 
 void ScriptRunner::setText(const QString &path, int row, int column,
@@ -1876,61 +2459,54 @@ void ScriptRunner::setText(const QString &path, QList<int> indexPath,
 
 void ScriptRunner::closeDialog(const QString &path) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-    if (!object->inherits("QDialog")) {
-        engine_->throwError(QStringLiteral("Passed object is not a dialog"));
-        return;
-    }
-    postEvents(object, { new QCloseEvent() });
+    executeCommand(path, [](QObject *object, GuiCommandContext &context) {
+        if (!object->inherits("QDialog")) {
+            context.fail(QStringLiteral("Passed object is not a dialog"));
+            return;
+        }
+        context.postEvents(object, { new QCloseEvent() });
+    });
 }
 
 void ScriptRunner::closeWindow(const QString &path) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-
-    const auto isWidgetWindow = object->inherits("QMainWindow");
-    const auto isQuickWindow = object->inherits("QQuickWindow");
-    if (!isWidgetWindow && !isQuickWindow) {
-        engine_->throwError(QStringLiteral("Passed object is not a window"));
-        return;
-    }
+    executeCommand(path, [](QObject *object, GuiCommandContext &context) {
+        const auto isWidgetWindow = object->inherits("QMainWindow");
+        const auto isQuickWindow = object->inherits("QQuickWindow");
+        if (!isWidgetWindow && !isQuickWindow) {
+            context.fail(QStringLiteral("Passed object is not a window"));
+            return;
+        }
 
-    if (isWidgetWindow) {
-        //! TODO: Почему-то именно для QMainWindow не работает
-        //! QGuiApplication::postEvent(object, new QCloseEvent());
-        invokeBlockMethodWithTimeout(object, "close");
-    }
-    else if (isQuickWindow) {
-        postEvents(object, { new QCloseEvent() });
-    }
+        if (isWidgetWindow) {
+            //! TODO: Почему-то именно для QMainWindow не работает
+            //! QGuiApplication::postEvent(object, new QCloseEvent());
+            context.invoke(object, "close");
+        }
+        else if (isQuickWindow) {
+            context.postEvents(object, { new QCloseEvent() });
+        }
+    });
 }
 
 void ScriptRunner::keyEvent(const QString &path, const QString &keyText) const noexcept
 {
-    auto *object = findObjectByPath(path);
-    if (object == nullptr) {
-        return;
-    }
-    if (!checkObjectAvailability(object, path)) {
-        return;
-    }
-    //! TODO: Пока непонятно, что делать с keyEvent и нужен ли он вообще. Сейчас он
-    //! точно не важен, поэтому сделал "тестовый" вариант, но учитывая, что из-за
-    //! "модификаторов" куча других действий могут потребовать правок (с учетом
-    //! модификаторов обычные нажатия могут приводить к другим результатам).
-    emit scriptWarning(QStringLiteral("In this QtAda version function 'keyEvent' is unstable, "
-                                      "so be attentive to use it"));
-    QKeySequence keySequence(keyText);
-    const auto key = keySequence[0];
-    const auto modifiers = Qt::KeyboardModifiers(keySequence[0] & Qt::KeyboardModifierMask);
-    postEvents(object, { new QKeyEvent(QEvent::KeyPress, key, modifiers, keyText),
-                         new QKeyEvent(QEvent::KeyRelease, key, modifiers, keyText) });
+    executeCommand(path, [keyText](QObject *object, GuiCommandContext &context) {
+        if (!context.checkAvailability(object)) {
+            return;
+        }
+        //! TODO: Пока непонятно, что делать с keyEvent и нужен ли он вообще. Сейчас он
+        //! точно не важен, поэтому сделал "тестовый" вариант, но учитывая, что из-за
+        //! "модификаторов" куча других действий могут потребовать правок (с учетом
+        //! модификаторов обычные нажатия могут приводить к другим результатам).
+        context.warn(QStringLiteral("In this QtAda version function 'keyEvent' is unstable, "
+                                    "so be attentive to use it"));
+        QKeySequence keySequence(keyText);
+        const auto key = keySequence[0];
+        const auto modifiers = Qt::KeyboardModifiers(keySequence[0] & Qt::KeyboardModifierMask);
+        context.postEvents(object, { new QKeyEvent(QEvent::KeyPress, key, modifiers, keyText),
+                                     new QKeyEvent(QEvent::KeyRelease, key, modifiers, keyText) });
+    });
 }
 
 void ScriptRunner::wheelEvent(const QString &path, int dx, int dy) const noexcept
@@ -1941,4 +2517,233 @@ void ScriptRunner::wheelEvent(const QString &path, int dx, int dy) const noexcep
     emit scriptWarning(QStringLiteral("In this QtAda version function 'wheelEvent' is unstable, "
                                       "so it is better to use 'mouseClick' if it is possible"));
 }
+
+template <typename Command> void ObjectHandle::run(Command command) const noexcept
+{
+    assert(runner_ != nullptr);
+    assert(runner_->activeHandle_ == nullptr);
+    runner_->activeHandle_ = this;
+    command();
+    runner_->activeHandle_ = nullptr;
+}
+
+void ObjectHandle::verify(const QString &property, const QString &value) const noexcept
+{
+    run([&] { runner_->verify(path_, property, value); });
+}
+
+void ObjectHandle::verifyAll(const QJSValue &expectedValues) const noexcept
+{
+    run([&] { runner_->verifyAll(path_, expectedValues); });
+}
+
+void ObjectHandle::mouseClick(const QString &mouseButtonStr, int x, int y) const noexcept
+{
+    run([&] { runner_->mouseClick(path_, mouseButtonStr, x, y); });
+}
+
+void ObjectHandle::mouseDblClick(const QString &mouseButtonStr, int x, int y) const noexcept
+{
+    run([&] { runner_->mouseDblClick(path_, mouseButtonStr, x, y); });
+}
+
+void ObjectHandle::keyEvent(const QString &keyText) const noexcept
+{
+    run([&] { runner_->keyEvent(path_, keyText); });
+}
+
+void ObjectHandle::wheelEvent(int dx, int dy) const noexcept
+{
+    run([&] { runner_->wheelEvent(path_, dx, dy); });
+}
+
+void ObjectHandle::buttonClick() const noexcept
+{
+    run([&] { runner_->buttonClick(path_); });
+}
+
+void ObjectHandle::buttonToggle() const noexcept
+{
+    run([&] { runner_->buttonToggle(path_); });
+}
+
+void ObjectHandle::buttonDblClick() const noexcept
+{
+    run([&] { runner_->buttonDblClick(path_); });
+}
+
+void ObjectHandle::buttonPress() const noexcept
+{
+    run([&] { runner_->buttonPress(path_); });
+}
+
+void ObjectHandle::mouseAreaClick() const noexcept
+{
+    run([&] { runner_->mouseAreaClick(path_); });
+}
+
+void ObjectHandle::mouseAreaDblClick() const noexcept
+{
+    run([&] { runner_->mouseAreaDblClick(path_); });
+}
+
+void ObjectHandle::mouseAreaPress() const noexcept
+{
+    run([&] { runner_->mouseAreaPress(path_); });
+}
+
+void ObjectHandle::checkButton(bool isChecked) const noexcept
+{
+    run([&] { runner_->checkButton(path_, isChecked); });
+}
+
+void ObjectHandle::selectItem(int index) const noexcept
+{
+    run([&] { runner_->selectItem(path_, index); });
+}
+
+void ObjectHandle::selectItem(const QString &text) const noexcept
+{
+    run([&] { runner_->selectItem(path_, text); });
+}
+
+void ObjectHandle::selectItem(const QString &text, int index) const noexcept
+{
+    run([&] { runner_->selectItem(path_, text, index); });
+}
+
+void ObjectHandle::setValue(double value) const noexcept
+{
+    run([&] { runner_->setValue(path_, value); });
+}
+
+void ObjectHandle::setValue(double leftValue, double rightValue) const noexcept
+{
+    run([&] { runner_->setValue(path_, leftValue, rightValue); });
+}
+
+void ObjectHandle::setValue(const QString &value) const noexcept
+{
+    run([&] { runner_->setValue(path_, value); });
+}
+
+void ObjectHandle::changeValue(const QString &type) const noexcept
+{
+    run([&] { runner_->changeValue(path_, type); });
+}
+
+void ObjectHandle::setDelayProgress(double delay) const noexcept
+{
+    run([&] { runner_->setDelayProgress(path_, delay); });
+}
+
+void ObjectHandle::selectTabItem(int index) const noexcept
+{
+    run([&] { runner_->selectTabItem(path_, index); });
+}
+
+void ObjectHandle::selectTabItem(const QString &text) const noexcept
+{
+    run([&] { runner_->selectTabItem(path_, text); });
+}
+
+void ObjectHandle::selectTabItem(const QString &text, int index) const noexcept
+{
+    run([&] { runner_->selectTabItem(path_, text, index); });
+}
+
+void ObjectHandle::expandDelegate(const QList<int> &indexPath) const noexcept
+{
+    run([&] { runner_->expandDelegate(path_, indexPath); });
+}
+
+void ObjectHandle::collapseDelegate(const QList<int> &indexPath) const noexcept
+{
+    run([&] { runner_->collapseDelegate(path_, indexPath); });
+}
+
+void ObjectHandle::undoCommand(int index) const noexcept
+{
+    run([&] { runner_->undoCommand(path_, index); });
+}
+
+void ObjectHandle::selectViewItem(int index) const noexcept
+{
+    run([&] { runner_->selectViewItem(path_, index); });
+}
+
+void ObjectHandle::triggerAction() const noexcept
+{
+    run([&] { runner_->triggerAction(path_); });
+}
+
+void ObjectHandle::triggerAction(bool isChecked) const noexcept
+{
+    run([&] { runner_->triggerAction(path_, isChecked); });
+}
+
+void ObjectHandle::delegateClick(int index) const noexcept
+{
+    run([&] { runner_->delegateClick(path_, index); });
+}
+
+void ObjectHandle::delegateDblClick(int index) const noexcept
+{
+    run([&] { runner_->delegateDblClick(path_, index); });
+}
+
+void ObjectHandle::delegateClick(QList<int> indexPath) const noexcept
+{
+    run([&] { runner_->delegateClick(path_, indexPath); });
+}
+
+void ObjectHandle::delegateDblClick(QList<int> indexPath) const noexcept
+{
+    run([&] { runner_->delegateDblClick(path_, indexPath); });
+}
+
+void ObjectHandle::delegateClick(int row, int column) const noexcept
+{
+    run([&] { runner_->delegateClick(path_, row, column); });
+}
+
+void ObjectHandle::delegateDblClick(int row, int column) const noexcept
+{
+    run([&] { runner_->delegateDblClick(path_, row, column); });
+}
+
+void ObjectHandle::setSelection(const QJSValue &selectionData) const noexcept
+{
+    run([&] { runner_->setSelection(path_, selectionData); });
+}
+
+void ObjectHandle::clearSelection() const noexcept
+{
+    run([&] { runner_->clearSelection(path_); });
+}
+
+void ObjectHandle::setText(const QString &text) const noexcept
+{
+    run([&] { runner_->setText(path_, text); });
+}
+
+void ObjectHandle::setText(int row, int column, const QString &text) const noexcept
+{
+    run([&] { runner_->setText(path_, row, column, text); });
+}
+
+void ObjectHandle::setText(QList<int> indexPath, const QString &text) const noexcept
+{
+    run([&] { runner_->setText(path_, indexPath, text); });
+}
+
+void ObjectHandle::closeDialog() const noexcept
+{
+    run([&] { runner_->closeDialog(path_); });
+}
+
+void ObjectHandle::closeWindow() const noexcept
+{
+    run([&] { runner_->closeWindow(path_); });
+}
 } // namespace QtAda::core
@@ -2,27 +2,152 @@
 
 #include <QObject>
 #include <QEvent>
+#include <QDeadlineTimer>
+#include <QSemaphore>
+#include <QMutex>
+#include <QPointer>
+#include <QJSValue>
+#include <memory>
+#include <atomic>
 
 #include "Settings.hpp"
+#include "ObjectRegistry.hpp"
+#include "ObjectPathIndex.hpp"
+#include "PathResolver.hpp"
+#include "GuiCommand.hpp"
 
 QT_BEGIN_NAMESPACE
 class QJSEngine;
-class QJSValue;
+class QMetaProperty;
 QT_END_NAMESPACE
 
 namespace QtAda::core {
+class PropertyNotifyWatcher final : public QObject {
+    Q_OBJECT
+public:
+    static PropertyNotifyWatcher *watch(QObject *object, const QMetaProperty &property,
+                                        std::shared_ptr<QSemaphore> semaphore) noexcept;
+    void release() noexcept;
+
+private slots:
+    void handlePropertyChanged() noexcept
+    {
+        semaphore_->release();
+    }
+
+private:
+    explicit PropertyNotifyWatcher(std::shared_ptr<QSemaphore> semaphore) noexcept
+        : semaphore_{ std::move(semaphore) }
+    {
+    }
+
+    const std::shared_ptr<QSemaphore> semaphore_;
+    QMetaObject::Connection connection_;
+};
+
+class ScriptRunner;
+
+/*
+ * Объект, возвращаемый из QtAda.find(path). Хранит найденный объект через QPointer, поэтому
+ * команды, вызванные через него, не ищут объект по пути повторно, пока он не будет удален.
+ * QPointer создается и проверяется только в GUI-потоке (см. GuiCommandResult::object), а в
+ * потоке скрипта лишь копируется. Методы повторяют методы QtAda, только без первого
+ * аргумента с путем.
+ */
+class ObjectHandle final : public QObject {
+    Q_OBJECT
+public:
+    ObjectHandle(const ScriptRunner *runner, const QString &path,
+                 const QPointer<QObject> &object) noexcept
+        : runner_{ runner }
+        , path_{ path }
+        , object_{ object }
+    {
+    }
+
+    const QString &path() const noexcept
+    {
+        return path_;
+    }
+    QPointer<QObject> object() const noexcept
+    {
+        return object_;
+    }
+    void rebind(const QPointer<QObject> &object) const noexcept
+    {
+        object_ = object;
+    }
+
+    Q_INVOKABLE void verify(const QString &property, const QString &value) const noexcept;
+    Q_INVOKABLE void verifyAll(const QJSValue &expectedValues) const noexcept;
+    Q_INVOKABLE void mouseClick(const QString &mouseButtonStr, int x, int y) const noexcept;
+    Q_INVOKABLE void mouseDblClick(const QString &mouseButtonStr, int x, int y) const noexcept;
+    Q_INVOKABLE void keyEvent(const QString &keyText) const noexcept;
+    Q_INVOKABLE void wheelEvent(int dx, int dy) const noexcept;
+    Q_INVOKABLE void buttonClick() const noexcept;
+    Q_INVOKABLE void buttonToggle() const noexcept;
+    Q_INVOKABLE void buttonDblClick() const noexcept;
+    Q_INVOKABLE void buttonPress() const noexcept;
+    Q_INVOKABLE void mouseAreaClick() const noexcept;
+    Q_INVOKABLE void mouseAreaDblClick() const noexcept;
+    Q_INVOKABLE void mouseAreaPress() const noexcept;
+    Q_INVOKABLE void checkButton(bool isChecked) const noexcept;
+    Q_INVOKABLE void selectItem(int index) const noexcept;
+    Q_INVOKABLE void selectItem(const QString &text) const noexcept;
+    Q_INVOKABLE void selectItem(const QString &text, int index) const noexcept;
+    Q_INVOKABLE void setValue(double value) const noexcept;
+    Q_INVOKABLE void setValue(double leftValue, double rightValue) const noexcept;
+    Q_INVOKABLE void setValue(const QString &value) const noexcept;
+    Q_INVOKABLE void changeValue(const QString &type) const noexcept;
+    Q_INVOKABLE void setDelayProgress(double delay) const noexcept;
+    Q_INVOKABLE void selectTabItem(int index) const noexcept;
+    Q_INVOKABLE void selectTabItem(const QString &text) const noexcept;
+    Q_INVOKABLE void selectTabItem(const QString &text, int index) const noexcept;
+    Q_INVOKABLE void expandDelegate(const QList<int> &indexPath) const noexcept;
+    Q_INVOKABLE void collapseDelegate(const QList<int> &indexPath) const noexcept;
+    Q_INVOKABLE void undoCommand(int index) const noexcept;
+    Q_INVOKABLE void selectViewItem(int index) const noexcept;
+    Q_INVOKABLE void triggerAction() const noexcept;
+    Q_INVOKABLE void triggerAction(bool isChecked) const noexcept;
+    Q_INVOKABLE void delegateClick(int index) const noexcept;
+    Q_INVOKABLE void delegateDblClick(int index) const noexcept;
+    Q_INVOKABLE void delegateClick(QList<int> indexPath) const noexcept;
+    Q_INVOKABLE void delegateDblClick(QList<int> indexPath) const noexcept;
+    Q_INVOKABLE void delegateClick(int row, int column) const noexcept;
+    Q_INVOKABLE void delegateDblClick(int row, int column) const noexcept;
+    Q_INVOKABLE void setSelection(const QJSValue &selectionData) const noexcept;
+    Q_INVOKABLE void clearSelection() const noexcept;
+    Q_INVOKABLE void setText(const QString &text) const noexcept;
+    Q_INVOKABLE void setText(int row, int column, const QString &text) const noexcept;
+    Q_INVOKABLE void setText(QList<int> indexPath, const QString &text) const noexcept;
+    Q_INVOKABLE void closeDialog() const noexcept;
+    Q_INVOKABLE void closeWindow() const noexcept;
+
+private:
+    template <typename Command> void run(Command command) const noexcept;
+
+    const ScriptRunner *runner_ = nullptr;
+    const QString path_;
+    mutable QPointer<QObject> object_;
+};
+
 class ScriptRunner final : public QObject {
     Q_OBJECT
 public:
     ScriptRunner(const RunSettings &settings, QObject *parent = nullptr) noexcept;
 
+    Q_INVOKABLE QJSValue find(const QString &path) const noexcept;
+    Q_INVOKABLE void batch(const QJSValue &function) const noexcept;
     Q_INVOKABLE void verify(const QString &path, const QString &property,
                             const QString &value) const noexcept;
+    Q_INVOKABLE void verifyAll(const QString &path,
+                               const QJSValue &expectedValues) const noexcept;
     Q_INVOKABLE void waitFor(const QString &path, int sec) const noexcept;
     Q_INVOKABLE void mwaitFor(const QString &path, int msec) const noexcept;
     Q_INVOKABLE void sleep(int sec);
     Q_INVOKABLE void msleep(int msec);
     Q_INVOKABLE void usleep(int usec);
+    Q_INVOKABLE void requestRelaunch() noexcept;
     Q_INVOKABLE void mouseClick(const QString &path, const QString &mouseButtonStr, int x,
                                 int y) const noexcept;
     Q_INVOKABLE void mouseDblClick(const QString &path, const QString &mouseButtonStr, int x,
@@ -77,8 +202,11 @@ public:
 
     void handleApplicationClosing() noexcept
     {
-        pathToObject_.clear();
-        objectToPath_.clear();
+        applicationClosing_ = true;
+        QMutexLocker locker(&pathIndexMutex_);
+        registry_.clear();
+        pathIndex_.clear();
+        pathResolver_.clear();
     }
 
 signals:
@@ -86,35 +214,78 @@ signals:
     void scriptWarning(const QString &msg) const;
     void scriptLog(const QString &msg) const;
 
+    // Скрипт сессии завершен, и поток ждет следующего скрипта
+    void scriptFinished(int exitCode);
     void aboutToClose(int exitCode);
 
 public slots:
     void startScript() noexcept;
+    void startNextScript(const QString &scriptPath, bool isLastScript) noexcept;
+    void finishSession() noexcept;
 
     void registerObjectCreated(QObject *obj) noexcept;
     void registerObjectDestroyed(QObject *obj) noexcept;
     void registerObjectReparented(QObject *obj) noexcept;
+    // Для объектов других потоков вызываются в потоке объекта
+    void registerObjectRenamed(QObject *obj) noexcept;
+    void registerObjectThreadChanged(QObject *obj) noexcept;
 
 private:
-    std::map<const QString, QObject *> pathToObject_;
-    std::map<const QObject *, QString> objectToPath_;
+    friend class ObjectHandle;
+
+    void applyPathChanges(const ObjectPathIndex::Changes &changes) noexcept;
+
+    ObjectRegistry registry_;
+    // Изменяется в обработчиках registerObject* (объекты других потоков обрабатываются в их
+    // потоках) и в refreshObjectNames, всегда под pathIndexMutex_ вместе с registry_
+    mutable QMutex pathIndexMutex_;
+    ObjectPathIndex pathIndex_;
+    // Используется вместо registry_ при PathResolution::OnDemand, только из GUI-потока
+    mutable PathResolver pathResolver_;
 
     const RunSettings runSettings_;
+    QString scriptPath_;
     QJSEngine *engine_ = nullptr;
 
+    bool relaunchRequested_ = false;
+    // После текущего скрипта сессии следующего не будет, и приложение возвращать в исходное
+    // состояние не нужно
+    bool isLastScript_ = false;
+    std::atomic<bool> applicationClosing_ = false;
+    // Окна, открытые к началу первого скрипта сессии. QPointer создаются и проверяются только
+    // в GUI-потоке, а здесь лишь хранятся их копии
+    std::optional<std::vector<QPointer<QObject>>> mainWindows_;
+    // Объект, через который вызвана текущая команда (только из потока скрипта)
+    mutable const ObjectHandle *activeHandle_ = nullptr;
+    // Команды, накопленные внутри QtAda.batch, и их пути (только из потока скрипта)
+    mutable std::vector<GuiCommandStep> batchSteps_;
+    mutable QStringList batchPaths_;
+    mutable int batchDepth_ = 0;
+
     void finishThread(bool isOk) noexcept;
+    QJSValue evaluateInNewEngine(const QString &scriptContent) noexcept;
+    bool resetSession() noexcept;
+
+    QObject *waitForObject(const QString &path, QDeadlineTimer deadline) const noexcept;
+    void refreshObjectNames() const noexcept;
 
-    void writePropertyInGuiThread(QObject *object, const QString &propertyName,
-                                  const QVariant &value) const noexcept;
-    void invokeBlockMethodWithTimeout(QObject *object, const char *method,
-                                      QGenericArgument val0 = QGenericArgument(nullptr),
-                                      QGenericArgument val1 = QGenericArgument(),
-                                      QGenericArgument val2 = QGenericArgument()) const noexcept;
-    void postEvents(QObject *object, std::vector<QEvent *> events) const noexcept;
+    void waitForEventsDelivered() const noexcept;
 
-    QObject *findObjectByPath(const QString &path) const noexcept;
-    bool checkObjectAvailability(const QObject *object, const QString &path,
-                                 bool shouldBeVisible = true) const noexcept;
+    // Только из GUI-потока: поиск без ожидания
+    QObject *lookupObject(const QString &path) const noexcept;
+    GuiObjectGetter objectGetter(const QString &path) const noexcept;
+    // Ждет появления объекта, возвращает false (выбросив ошибку в скрипте), если его нет
+    bool findObjectByPath(const QString &path) const noexcept;
+    void executeCommand(const QString &path, GuiCommand command) const noexcept;
+    bool runCommand(const QString &path, const GuiObjectGetter &getObject,
+                    const GuiCommand &command) const noexcept;
+    bool reportCommandResult(const QString &path, const GuiCommandResult &result) const noexcept;
+    bool checkWatchResult(const QString &path, const GuiCommandResult &result) const noexcept;
+    // Пары "свойство - ожидаемое значение"
+    using Verifications = std::vector<std::pair<QString, QString>>;
+    void verifyProperties(const QString &path, const Verifications &verifications) const noexcept;
+    void enqueueCommand(const QString &path, GuiCommand command) const noexcept;
+    bool flushBatch() const noexcept;
 
     void mouseClickTemplate(const QString &path, const QString &mouseButtonStr, int x, int y,
                             bool isDouble) const noexcept;
@@ -133,9 +304,5 @@ private:
     void setTextTemplate(const QString &path, std::optional<QList<int>> indexPath,
                          std::optional<std::pair<int, int>> index,
                          const QString &text) const noexcept;
-    void setValueTemplate(QObject *object, const QString &path,
-                          const QString &value) const noexcept;
-    void setValueTemplate(QObject *object, const QString &path, double value) const noexcept;
-    void setValueIntoQmlSpinBox(QObject *object, const QString &value) const noexcept;
 };
 } // namespace QtAda::core
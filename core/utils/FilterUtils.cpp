@@ -6,7 +6,10 @@
 #include <QMenu>
 #include <QMenuBar>
 #include <QItemSelectionModel>
+#include <QReadWriteLock>
 #include <optional>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace QtAda::core::utils {
 static const std::pair<Qt::MouseButton, QLatin1String> s_mouseButtons[] = {
@@ -34,6 +37,44 @@ static const std::pair<ChangeType, QLatin1String> s_changeTypes[] = {
 static const std::vector<std::pair<char, QString>> s_escapeReplacements
     = { { '\n', "\\n" }, { '\r', "\\r" }, { '\t', "\\t" }, { '\v', "\\v" } };
 
+struct ClassNameAtoms {
+    QReadWriteLock lock;
+    // Для QML-типов QMetaObject создается динамически и может быть удален, поэтому вместе с
+    // атомом храним указатель на className(), по которому проверяем актуальность записи
+    std::unordered_map<const QMetaObject *, std::pair<const char *, const QString *>>
+        metaObjectToAtom;
+    std::unordered_set<QString> atoms;
+};
+Q_GLOBAL_STATIC(ClassNameAtoms, s_classNameAtoms)
+
+const QString *classNameAtom(const QMetaObject *metaObject) noexcept
+{
+    assert(metaObject != nullptr);
+    auto *atoms = s_classNameAtoms();
+    const auto *className = metaObject->className();
+    {
+        QReadLocker locker(&atoms->lock);
+        const auto it = atoms->metaObjectToAtom.find(metaObject);
+        if (it != atoms->metaObjectToAtom.end() && it->second.first == className) {
+            return it->second.second;
+        }
+    }
+
+    //! TODO: В className() для классов, созданных в QML, автоматически устанавливается
+    //! суффикс "QMLTYPE_{число}" (это примерно то, что мы и делаем при нахождении objectPath),
+    //! но проблема в том, что это число - не постоянная величина (особенно это видно со
+    //! "специфическими" надстройками над графической оболочкой). Поэтому при запуске скриптов
+    //! могут быть проблемы. В связи с этим решено пока что убирать этот суффикс, если он есть.
+    static const QRegularExpression s_qmlSuffix(
+        "(?<=.)(_(QMLTYPE|QML)_\\d+)|(_QMLTYPE_\\d+_QML_\\d+)|(_QML_\\d+_QMLTYPE_\\d+)$");
+    const auto normalizedName = QString(className).remove(s_qmlSuffix);
+
+    QWriteLocker locker(&atoms->lock);
+    const auto *atom = &*atoms->atoms.insert(normalizedName).first;
+    atoms->metaObjectToAtom[metaObject] = { className, atom };
+    return atom;
+}
+
 static uint metaObjectIndexInObjectList(const QObject *obj, const QObjectList &children) noexcept
 {
     assert(!children.isEmpty());
@@ -66,39 +107,33 @@ static uint objectIndexInObjectList(const QObject *obj, const QObjectList &child
     Q_UNREACHABLE();
 }
 
-static QString metaObjectId(const QObject *obj) noexcept
+QString objectPathSegment(const QObject *obj, uint siblingIndex) noexcept
 {
-    //! TODO: В className() для классов, созданных в QML, автоматически устанавливается
-    //! суффикс "QMLTYPE_{число}" (это примерно то, что мы и делаем при нахождении objectPath),
-    //! но проблема в том, что это число - не постоянная величина (особенно это видно со
-    //! "специфическими" надстройками над графической оболочкой). Поэтому при запуске скриптов
-    //! могут быть проблемы. В связи с этим решено пока что убирать этот суффикс, если он есть.
-    const QString metaObjName
-        = QString(obj->metaObject()->className())
-              .remove(QRegularExpression("(?<=.)(_(QMLTYPE|QML)_\\d+)|(_QMLTYPE_\\d+_QML_\\d+)|(_"
-                                         "QML_\\d+_QMLTYPE_\\d+)$"));
-    const auto *parent = obj->parent();
-    return QString("%1_%2")
-        .arg(metaObjName)
-        .arg(parent ? metaObjectIndexInObjectList(obj, parent->children()) : 0);
+    return objectPathSegment(obj->metaObject(), obj->objectName(), siblingIndex);
 }
 
-static QString objectId(const QObject *obj) noexcept
+QString objectPathSegment(const QMetaObject *metaObject, const QString &objectName,
+                          uint siblingIndex) noexcept
 {
-    const auto objName = obj->objectName();
-    const auto *parent = obj->parent();
-    return QString("%1_%2").arg(objName).arg(
-        parent ? objectIndexInObjectList(obj, parent->children()) : 0);
+    if (objectName.isEmpty()) {
+        return QString("c=%1_%2").arg(*classNameAtom(metaObject)).arg(siblingIndex);
+    }
+    return QString("n=%1_%2").arg(objectName).arg(siblingIndex);
 }
 
 QString objectPath(const QObject *obj) noexcept
 {
     QStringList pathComponents;
     while (obj != nullptr) {
-        QString identifier = obj->objectName().isEmpty() ? QString("c=%1").arg(metaObjectId(obj))
-                                                         : QString("n=%1").arg(objectId(obj));
-        pathComponents.prepend(identifier);
-        obj = obj->parent();
+        const auto *parent = obj->parent();
+        uint siblingIndex = 0;
+        if (parent != nullptr) {
+            siblingIndex = obj->objectName().isEmpty()
+                               ? metaObjectIndexInObjectList(obj, parent->children())
+                               : objectIndexInObjectList(obj, parent->children());
+        }
+        pathComponents.prepend(objectPathSegment(obj, siblingIndex));
+        obj = parent;
     }
     assert(!pathComponents.isEmpty());
     return pathComponents.join('/');
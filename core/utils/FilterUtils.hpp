@@ -26,6 +26,17 @@ enum class ChangeType {
 }
 
 namespace QtAda::core::utils {
+// Имя класса без QML-суффиксов (_QMLTYPE_N, _QML_N). Вычисляется один раз для каждого
+// QMetaObject, а одинаковые имена хранятся в единственном экземпляре. Это только кэш имени:
+// соседи по-прежнему группируются по указателю className(), поэтому разные QML-типы с
+// одинаковым именем нумеруются независимо
+const QString *classNameAtom(const QMetaObject *metaObject) noexcept;
+// Сегмент пути объекта: "n=<objectName>_<index>" для именованных объектов и
+// "c=<className>_<index>" для остальных, где index - номер объекта среди соседей
+// с тем же именем (или с тем же указателем className())
+QString objectPathSegment(const QObject *obj, uint siblingIndex) noexcept;
+QString objectPathSegment(const QMetaObject *metaObject, const QString &objectName,
+                          uint siblingIndex) noexcept;
 QString objectPath(const QObject *obj) noexcept;
 template <typename GuiComponent> QString objectPath(const GuiComponent *component) noexcept
 {
@@ -6,6 +6,9 @@
 #include <QMetaProperty>
 #include <QMetaEnum>
 #include <QByteArray>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QQmlProperty>
 #include <optional>
 
 #include <QCursor>
@@ -55,14 +58,9 @@ static const QMetaObject *metaObjectForClass(const QByteArray &className)
     return metaObject;
 }
 
-static std::optional<QMetaEnum> getMetaEnum(const QVariant &value, const char *сanonicalTypeName,
-                                            const QMetaObject *сanonicalMetaObject = nullptr)
+static std::optional<QMetaEnum> resolveMetaEnum(const QByteArray &typeName,
+                                                const QMetaObject *сanonicalMetaObject)
 {
-    QByteArray typeName(сanonicalTypeName);
-    if (typeName.isEmpty()) {
-        typeName = value.typeName();
-    }
-
     // Нужно разделить имя класса и имя перечисления
     QByteArray className;
     QByteArray enumTypeName(typeName);
@@ -99,7 +97,7 @@ static std::optional<QMetaEnum> getMetaEnum(const QVariant &value, const char *
         const auto separatorIndex = classParentName.lastIndexOf("::");
         if (separatorIndex > 0) {
             classParentName = classParentName.left(separatorIndex + 2) + typeName;
-            return getMetaEnum(value, classParentName, nullptr);
+            return resolveMetaEnum(classParentName, nullptr);
         }
     }
 
@@ -110,6 +108,54 @@ static std::optional<QMetaEnum> getMetaEnum(const QVariant &value, const char *
     return metaObject->enumerator(enumIndex);
 }
 
+struct MetaEnumCache {
+    struct Entry {
+        const char *className = nullptr;
+        std::optional<QMetaEnum> metaEnum;
+    };
+    QReadWriteLock lock;
+    QHash<QPair<QByteArray, const QMetaObject *>, Entry> entries;
+};
+Q_GLOBAL_STATIC(MetaEnumCache, s_metaEnumCache)
+
+/*
+ * Поиск перечисления выполняется для каждого преобразуемого в строку значения, причем
+ * для большинства из них перечисление не находится, пройдя все варианты поиска. Поэтому
+ * результат (в том числе и отрицательный) кешируется по имени типа и мета-объекту.
+ */
+static std::optional<QMetaEnum> getMetaEnum(const QVariant &value, const char *сanonicalTypeName,
+                                            const QMetaObject *сanonicalMetaObject = nullptr)
+{
+    const char *typeName = сanonicalTypeName;
+    if (typeName == nullptr || *typeName == '\0') {
+        typeName = value.typeName();
+    }
+    if (typeName == nullptr) {
+        return std::nullopt;
+    }
+
+    auto *cache = s_metaEnumCache();
+    // Для QML-типов QMetaObject создается динамически и может быть удален, поэтому
+    // актуальность записи проверяем по указателю на className()
+    const auto *className
+        = сanonicalMetaObject != nullptr ? сanonicalMetaObject->className() : nullptr;
+    {
+        QReadLocker locker(&cache->lock);
+        const auto it = cache->entries.constFind(
+            qMakePair(QByteArray::fromRawData(typeName, qstrlen(typeName)), сanonicalMetaObject));
+        if (it != cache->entries.constEnd() && it->className == className) {
+            return it->metaEnum;
+        }
+    }
+
+    const QByteArray ownedTypeName(typeName);
+    auto metaEnum = resolveMetaEnum(ownedTypeName, сanonicalMetaObject);
+    QWriteLocker locker(&cache->lock);
+    cache->entries.insert(qMakePair(ownedTypeName, сanonicalMetaObject),
+                          { className, metaEnum });
+    return metaEnum;
+}
+
 static int metaEnumToInt(const QVariant &value, const QMetaEnum &metaEnum)
 {
     if (metaEnum.isFlag() && QMetaType::sizeOf(value.userType()) == sizeof(int)) {
@@ -420,7 +466,8 @@ static QString variantValueToString(const QVariant &value)
 
 QString metaPropertyValueToString(const QObject *obj, const QMetaProperty &property) noexcept
 {
-    const auto propertyValue = obj->property(property.name());
+    const auto propertyValue
+        = property.isValid() ? property.read(obj) : obj->property(property.name());
     if (property.isValid()) {
         const auto enumValue
             = metaEnumToString(propertyValue, property.typeName(), obj->metaObject());
@@ -430,4 +477,89 @@ QString metaPropertyValueToString(const QObject *obj, const QMetaProperty &prope
     }
     return variantValueToString(std::move(propertyValue));
 }
+
+struct PropertyIndexCache {
+    QReadWriteLock lock;
+    QHash<QPair<const QMetaObject *, QByteArray>, int> indexes;
+};
+Q_GLOBAL_STATIC(PropertyIndexCache, s_propertyIndexCache)
+
+int propertyIndex(const QMetaObject *metaObject, const char *name) noexcept
+{
+    assert(metaObject != nullptr);
+    auto *cache = s_propertyIndexCache();
+    const auto key = qMakePair(metaObject, QByteArray::fromRawData(name, qstrlen(name)));
+    {
+        QReadLocker locker(&cache->lock);
+        const auto it = cache->indexes.constFind(key);
+        // Мета-объекты QML-типов создаются динамически, поэтому по тому же адресу может
+        // оказаться другой мета-объект: найденный индекс проверяем по имени свойства
+        if (it != cache->indexes.constEnd()
+            && (it.value() < 0
+                || (it.value() < metaObject->propertyCount()
+                    && qstrcmp(metaObject->property(it.value()).name(), name) == 0))) {
+            return it.value();
+        }
+    }
+
+    const auto index = metaObject->indexOfProperty(name);
+    QWriteLocker locker(&cache->lock);
+    cache->indexes.insert(qMakePair(metaObject, QByteArray(name)), index);
+    return index;
+}
+
+QVariant readProperty(const QObject *obj, const char *name) noexcept
+{
+    assert(obj != nullptr);
+    const auto *metaObject = obj->metaObject();
+    const auto index = propertyIndex(metaObject, name);
+    if (index >= 0) {
+        return metaObject->property(index).read(obj);
+    }
+    // Сгруппированные (first.value) и прикрепленные свойства доступны только через QQmlProperty
+    return QQmlProperty::read(obj, QString::fromLatin1(name));
+}
+
+std::optional<QVariant> typedExpectedValue(const QMetaProperty &property,
+                                           const QString &value) noexcept
+{
+    if (!property.isValid() || property.isEnumType()) {
+        return std::nullopt;
+    }
+    switch (property.userType()) {
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+    case QMetaType::QString:
+        break;
+    default:
+        return std::nullopt;
+    }
+
+    QVariant typedValue(value);
+    if (!typedValue.convert(property.userType())) {
+        return std::nullopt;
+    }
+    // Для этих типов metaPropertyValueToString возвращает QVariant::toString(), поэтому
+    // сравнение значений эквивалентно сравнению строк, только если ожидаемое значение
+    // записано ровно в таком же виде (например, "1", а не "01" или "1.0")
+    if (typedValue.toString() != value) {
+        return std::nullopt;
+    }
+    return typedValue;
+}
+
+bool propertyValueEquals(const QObject *obj, const QMetaProperty &property,
+                         const QVariant &expectedValue) noexcept
+{
+    const auto currentValue = property.read(obj);
+    // QVariant сравнивает числа с плавающей точкой через qFuzzyCompare
+    if (expectedValue.userType() == QMetaType::Double) {
+        return currentValue.toDouble() == expectedValue.toDouble();
+    }
+    return currentValue == expectedValue;
+}
 } // namespace QtAda::core::tools
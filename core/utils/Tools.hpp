@@ -2,10 +2,13 @@
 
 #include <dlfcn.h>
 #include <vector>
+#include <optional>
 #include <QString>
+#include <QVariant>
 
 QT_BEGIN_NAMESPACE
 class QObject;
+class QMetaObject;
 class QMetaProperty;
 QT_END_NAMESPACE
 
@@ -23,4 +26,17 @@ template <typename T> QString pointerToString(T *ptr) noexcept
 }
 
 QString metaPropertyValueToString(const QObject *obj, const QMetaProperty &property) noexcept;
+
+// Индекс свойства в мета-объекте (или -1), результат поиска по имени кешируется
+int propertyIndex(const QMetaObject *metaObject, const char *name) noexcept;
+// Аналог QQmlProperty::read, который для обычных свойств не создает QQmlProperty, а
+// использует закешированный индекс свойства
+QVariant readProperty(const QObject *obj, const char *name) noexcept;
+
+// Ожидаемое значение свойства в его собственном типе, если сравнение в этом типе дает
+// тот же результат, что и сравнение строк из metaPropertyValueToString
+std::optional<QVariant> typedExpectedValue(const QMetaProperty &property,
+                                           const QString &value) noexcept;
+bool propertyValueEquals(const QObject *obj, const QMetaProperty &property,
+                         const QVariant &expectedValue) noexcept;
 } // namespace QtAda::core::tools
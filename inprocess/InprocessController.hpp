@@ -2,6 +2,8 @@
 
 #include <rep_InprocessController_source.h>
 
+#include "Common.hpp"
+
 namespace QtAda::inprocess {
 class InprocessController final : public InprocessControllerSimpleSource {
     Q_OBJECT
@@ -9,13 +11,34 @@ public:
     InprocessController(QObject *parent = nullptr) noexcept
         : InprocessControllerSimpleSource{ parent }
     {
+        // Один InprocessController обслуживает и перезапуски приложения, а MessageBatcher
+        // каждого нового зонда нумерует сообщения с нуля
+        connect(this, &InprocessControllerSimpleSource::applicationRunningChanged, this,
+                [this](bool isAppRunning) {
+                    if (isAppRunning) {
+                        nextSequence_ = 0;
+                    }
+                });
     }
 
 public Q_SLOTS:
-    // UserEventFilter -> InprocessDialog slots:
-    void sendNewScriptLine(const QString &line) override
+    // UserEventFilter -> InprocessDialog и ScriptRunner -> InprocessRunner slots:
+    void sendMessageBatch(qint64 firstSequence, const QList<int> &types,
+                          const QStringList &messages) override
     {
-        emit this->newScriptLine(line);
+        assert(types.size() == messages.size());
+        // QtRO сохраняет порядок вызовов в рамках одного соединения, поэтому пакеты выдаются
+        // сразу в порядке получения, а разрыв в номерах означает, что часть сообщений
+        // потеряна. Меньший номер возможен, только если зонд начал нумерацию заново
+        if (firstSequence > nextSequence_) {
+            emit this->scriptRunWarning(
+                QStringLiteral("%1 messages from the application were lost")
+                    .arg(firstSequence - nextSequence_));
+        }
+        for (int i = 0; i < types.size(); ++i) {
+            emitMessage(static_cast<InprocessMessageType>(types.at(i)), messages.at(i));
+        }
+        nextSequence_ = firstSequence + types.size();
     }
 
     // UserVerificationFilter -> PropertiesWatcher slots:
@@ -30,17 +53,13 @@ public Q_SLOTS:
     }
 
     // ScriptRunner -> InprocessRunner
-    void sendScriptRunError(const QString &msg) override
-    {
-        emit this->scriptRunError(msg);
-    }
-    void sendScriptRunWarning(const QString &msg) override
+    void sendSessionScriptFinished(int exitCode) override
     {
-        emit this->scriptRunWarning(msg);
+        emit this->sessionScriptFinished(exitCode);
     }
-    void sendScriptRunLog(const QString &msg) override
+    void sendHeartbeat() override
     {
-        emit this->scriptRunLog(msg);
+        emit this->heartbeat();
     }
 
 Q_SIGNALS:
@@ -55,5 +74,30 @@ Q_SIGNALS:
     void scriptRunError(const QString &msg);
     void scriptRunWarning(const QString &msg);
     void scriptRunLog(const QString &msg);
+    void sessionScriptFinished(int exitCode);
+    void heartbeat();
+
+private:
+    qint64 nextSequence_ = 0;
+
+    void emitMessage(InprocessMessageType type, const QString &msg)
+    {
+        switch (type) {
+        case InprocessMessageType::ScriptRunError:
+            emit this->scriptRunError(msg);
+            break;
+        case InprocessMessageType::ScriptRunWarning:
+            emit this->scriptRunWarning(msg);
+            break;
+        case InprocessMessageType::ScriptRunLog:
+            emit this->scriptRunLog(msg);
+            break;
+        case InprocessMessageType::NewScriptLine:
+            emit this->newScriptLine(msg);
+            break;
+        default:
+            Q_UNREACHABLE();
+        }
+    }
 };
 } // namespace QtAda::inprocess
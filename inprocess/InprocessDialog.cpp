@@ -18,9 +18,10 @@
 #include "Paths.hpp"
 
 namespace QtAda::inprocess {
-InprocessDialog::InprocessDialog(const RecordSettings &settings, QWidget *parent) noexcept
+InprocessDialog::InprocessDialog(const RecordSettings &settings, const QUrl &remoteObjectUrl,
+                                 QWidget *parent) noexcept
     : QDialog{ parent }
-    , inprocessHost_{ new QRemoteObjectHost(QUrl(paths::REMOTE_OBJECT_PATH), this) }
+    , inprocessHost_{ new QRemoteObjectHost(remoteObjectUrl, this) }
     , inprocessController_{ new InprocessController }
     , propertiesWatcher_{ new PropertiesWatcher(inprocessController_, this) }
     , scriptWriter_{ new ScriptWriter(settings, this) }
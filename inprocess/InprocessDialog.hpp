@@ -9,6 +9,7 @@ class QToolButton;
 class QLabel;
 class QTextEdit;
 class QRemoteObjectHost;
+class QUrl;
 QT_END_NAMESPACE
 
 namespace QtAda::inprocess {
@@ -19,7 +20,8 @@ class ScriptWriter;
 class InprocessDialog final : public QDialog {
     Q_OBJECT
 public:
-    explicit InprocessDialog(const RecordSettings &settings, QWidget *parent = nullptr) noexcept;
+    InprocessDialog(const RecordSettings &settings, const QUrl &remoteObjectUrl,
+                    QWidget *parent = nullptr) noexcept;
     ~InprocessDialog() noexcept;
 
     void setTextToScriptLabel(const QString &text) noexcept;
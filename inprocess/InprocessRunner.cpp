@@ -3,12 +3,11 @@
 #include <QRemoteObjectHost>
 
 #include "InprocessController.hpp"
-#include "Paths.hpp"
 
 namespace QtAda::inprocess {
-InprocessRunner::InprocessRunner(QObject *parent) noexcept
+InprocessRunner::InprocessRunner(const QUrl &remoteObjectUrl, QObject *parent) noexcept
     : QObject{ parent }
-    , inprocessHost_{ new QRemoteObjectHost(QUrl(paths::REMOTE_OBJECT_PATH), this) }
+    , inprocessHost_{ new QRemoteObjectHost(remoteObjectUrl, this) }
     , inprocessController_{ new InprocessController }
 {
     connect(inprocessController_, &InprocessController::applicationRunningChanged, this,
@@ -19,6 +18,10 @@ InprocessRunner::InprocessRunner(QObject *parent) noexcept
             &InprocessRunner::scriptRunWarning);
     connect(inprocessController_, &InprocessController::scriptRunLog, this,
             &InprocessRunner::scriptRunLog);
+    connect(inprocessController_, &InprocessController::sessionScriptFinished, this,
+            &InprocessRunner::sessionScriptFinished);
+    connect(inprocessController_, &InprocessController::heartbeat, this,
+            &InprocessRunner::heartbeat);
     inprocessHost_->enableRemoting(inprocessController_);
 }
 
@@ -30,6 +33,18 @@ InprocessRunner::~InprocessRunner() noexcept
     inprocessController_ = nullptr;
 }
 
+void InprocessRunner::startSessionScript(const QString &scriptPath, bool isLastScript) noexcept
+{
+    assert(inprocessController_ != nullptr);
+    emit inprocessController_->sessionScriptRequested(scriptPath, isLastScript);
+}
+
+void InprocessRunner::finishSession() noexcept
+{
+    assert(inprocessController_ != nullptr);
+    emit inprocessController_->sessionFinished();
+}
+
 void InprocessRunner::handleApplicationStateChanged(bool isAppRunning) noexcept
 {
     // В отличие от InprocessDialog, который используется для записи скрипта,
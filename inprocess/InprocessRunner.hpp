@@ -4,6 +4,7 @@
 
 QT_BEGIN_NAMESPACE
 class QRemoteObjectHost;
+class QUrl;
 QT_END_NAMESPACE
 
 namespace QtAda::inprocess {
@@ -12,15 +13,22 @@ class InprocessController;
 class InprocessRunner final : public QObject {
     Q_OBJECT
 public:
-    InprocessRunner(QObject *parent = nullptr) noexcept;
+    InprocessRunner(const QUrl &remoteObjectUrl, QObject *parent = nullptr) noexcept;
     ~InprocessRunner() noexcept;
 
+    // isLastScript учитывается только в режиме сессии
+    void startSessionScript(const QString &scriptPath, bool isLastScript) noexcept;
+    void finishSession() noexcept;
+
 signals:
     void applicationStarted();
 
     void scriptRunError(const QString &msg);
     void scriptRunWarning(const QString &msg);
     void scriptRunLog(const QString &msg);
+    void sessionScriptFinished(int exitCode);
+    // Периодический сигнал из GUI-потока тестируемого приложения (HEARTBEAT_INTERVAL_MSEC)
+    void heartbeat();
 
 private slots:
     void handleApplicationStateChanged(bool isAppRunning) noexcept;
@@ -2,6 +2,7 @@
 
 #include <QFileInfo>
 #include <QDir>
+#include <QRegularExpression>
 
 #include "Paths.hpp"
 
@@ -31,6 +32,20 @@ static std::vector<QString> doCutLine(const QString &line) noexcept
     return result;
 }
 
+static QSet<QString> declaredNames(const std::vector<QString> &lines) noexcept
+{
+    static const QRegularExpression s_declaration(
+        QStringLiteral("\\b(?:const|let|var|function)\\s+([A-Za-z_$][\\w$]*)"));
+    QSet<QString> names;
+    for (const auto &line : lines) {
+        auto it = s_declaration.globalMatch(line);
+        while (it.hasNext()) {
+            names.insert(it.next().captured(1));
+        }
+    }
+    return names;
+}
+
 bool ScriptWriter::LinesHandler::registerLine(const QString &line) noexcept
 {
     if (line.isEmpty()) {
@@ -87,6 +102,9 @@ ScriptWriter::ScriptWriter(const RecordSettings &settings, QObject *parent) noex
         assert(isOpen == true);
         scriptStream_.setDevice(&script_);
 
+        // Новые переменные не должны совпадать с уже объявленными в скрипте
+        bindingNames_ = declaredNames(savedLines_);
+
         // Так как нумерация при задании параметров начинается с единицы
         auto fromZeroIndex = recordSettings_.appendLineIndex - 1;
         assert(fromZeroIndex >= 0);
@@ -201,21 +219,40 @@ void ScriptWriter::handleNewMetaPropertyVerification(
     assert(!objectPath.isEmpty());
     flushSavedLines();
 
+    // Несколько свойств, подтвержденных за раз, проверяются одной командой verifyAll,
+    // которой достаточно одного обращения к GUI-потоку на все свойства
+    if (verifications.size() > 1) {
+        const auto line
+            = QStringLiteral("%1verifyAll('%2', {").arg(SCRIPT_COMMAND_PREFIX).arg(objectPath);
+        flushScriptLine(applyObjectBinding(line));
+        for (const auto &verification : verifications) {
+            flushScriptLine(
+                QStringLiteral("%1: '%2',").arg(verification.first).arg(verification.second), 2);
+        }
+        flushScriptLine(QStringLiteral("});"));
+        return;
+    }
+
     for (const auto &verification : verifications) {
         const auto line = QStringLiteral("%1verify('%2', '%3', '%4');")
                               .arg(SCRIPT_COMMAND_PREFIX)
                               .arg(objectPath)
                               .arg(verification.first)
                               .arg(verification.second);
-        flushScriptLine(std::move(line));
+        flushScriptLine(applyObjectBinding(line));
     }
 }
 
 void ScriptWriter::flushSavedLines() noexcept
 {
     if (linesHandler_.cycleReady()) {
-        flushScriptLine(linesHandler_.forStatement());
+        // Переменные объектов объявляются до цикла, поэтому строки преобразуются заранее
+        std::vector<QString> cycleLines;
         for (const auto &line : linesHandler_.cutLine) {
+            cycleLines.push_back(applyObjectBinding(line));
+        }
+        flushScriptLine(linesHandler_.forStatement());
+        for (const auto &line : cycleLines) {
             flushScriptLine(line, 2);
         }
         flushScriptLine("}");
@@ -223,13 +260,99 @@ void ScriptWriter::flushSavedLines() noexcept
     else {
         for (int i = 0; i < linesHandler_.count; i++) {
             for (const auto &line : linesHandler_.cutLine) {
-                flushScriptLine(line);
+                flushScriptLine(applyObjectBinding(line));
             }
         }
     }
     linesHandler_.clear();
 }
 
+/*
+ * Если путь объекта используется в скрипте часто, то объект привязывается к переменной:
+ *      const okButton = QtAda.find('n=MainWindow_0/n=okButton_0');
+ *      okButton.buttonClick();
+ * Такие команды при выполнении скрипта не ищут объект по пути повторно.
+ */
+QString ScriptWriter::applyObjectBinding(const QString &line, int indentMultiplier) noexcept
+{
+    const auto minimumCount = recordSettings_.objectBindingMinimumCount;
+    if (minimumCount <= 0) {
+        return line;
+    }
+
+    static const QRegularExpression s_command(
+        QStringLiteral("^\\s*%1(\\w+)\\('((?:[^'\\\\]|\\\\.)*)'(?:, )?")
+            .arg(QRegularExpression::escape(SCRIPT_COMMAND_PREFIX)));
+    const auto match = s_command.match(line);
+    if (!match.hasMatch()) {
+        return line;
+    }
+    const auto command = match.captured(1);
+    if (command == QLatin1String("find") || command == QLatin1String("waitFor")
+        || command == QLatin1String("mwaitFor")) {
+        return line;
+    }
+
+    const auto path = match.captured(2);
+    auto binding = pathBindings_.constFind(path);
+    if (binding == pathBindings_.constEnd()) {
+        if (++pathUses_[path] < minimumCount) {
+            return line;
+        }
+        pathUses_.remove(path);
+
+        const auto name = newBindingName(path);
+        flushScriptLine(QStringLiteral("const %1 = %2find('%3');")
+                            .arg(name)
+                            .arg(SCRIPT_COMMAND_PREFIX)
+                            .arg(path),
+                        indentMultiplier);
+        binding = pathBindings_.insert(path, name);
+    }
+    return QStringLiteral("%1.%2(%3").arg(*binding).arg(command).arg(line.mid(match.capturedEnd()));
+}
+
+QString ScriptWriter::newBindingName(const QString &path) noexcept
+{
+    // Кроме зарезервированных слов JavaScript нельзя использовать имена, которые уже есть
+    // в генерируемом скрипте (функция test, переменная цикла i и сам объект QtAda)
+    static const QSet<QString> s_reservedNames = {
+        "break", "case", "catch", "class", "const", "continue", "debugger", "default", "delete",
+        "do", "else", "enum", "export", "extends", "false", "finally", "for", "function", "if",
+        "import", "in", "instanceof", "let", "new", "null", "return", "super", "switch", "this",
+        "throw", "true", "try", "typeof", "var", "void", "while", "with", "yield",
+        "i", "test", "QtAda",
+    };
+
+    // Имя переменной строится из последнего сегмента пути: 'n=okButton_0' -> okButton
+    auto segment = path.mid(path.lastIndexOf('/') + 1).mid(2);
+    const auto indexSeparator = segment.lastIndexOf('_');
+    if (indexSeparator > 0) {
+        segment.truncate(indexSeparator);
+    }
+
+    QString baseName;
+    for (const auto &symbol : segment) {
+        if ((symbol.isLetterOrNumber() && symbol.unicode() < 128) || symbol == '_') {
+            baseName.append(symbol);
+        }
+    }
+    if (baseName.isEmpty() || baseName.front().isDigit()) {
+        baseName.prepend(QStringLiteral("object"));
+    }
+    baseName[0] = baseName[0].toLower();
+    if (s_reservedNames.contains(baseName)) {
+        baseName.append(QStringLiteral("Object"));
+    }
+
+    auto name = baseName;
+    for (int i = 2; bindingNames_.contains(name); i++) {
+        name = QStringLiteral("%1%2").arg(baseName).arg(i);
+    }
+    bindingNames_.insert(name);
+    return name;
+}
+
 void ScriptWriter::flushScriptLine(const QString &scriptLine, int indentMultiplier,
                                    bool trimNeed) noexcept
 {
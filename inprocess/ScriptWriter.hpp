@@ -3,6 +3,8 @@
 #include <QObject>
 #include <QFile>
 #include <QTextStream>
+#include <QHash>
+#include <QSet>
 #include <vector>
 #include <optional>
 
@@ -68,6 +70,14 @@ private:
     std::vector<QString> savedLines_;
     bool scriptFinished_ = false;
 
+    // Количество использований еще не привязанных путей и переменные привязанных
+    QHash<QString, int> pathUses_;
+    QHash<QString, QString> pathBindings_;
+    QSet<QString> bindingNames_;
+
+    QString applyObjectBinding(const QString &line, int indentMultiplier = 1) noexcept;
+    QString newBindingName(const QString &path) noexcept;
+
     void flushSavedLines() noexcept;
     void flushScriptLine(const QString &line, int indentMultiplier = 1,
                          bool trimNeed = true) noexcept;
@@ -0,0 +1,202 @@
+#include "Daemon.hpp"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QRemoteObjectHost>
+#include <QUrl>
+#include <algorithm>
+#include <unistd.h>
+
+#include "DaemonController.hpp"
+#include "Launcher.hpp"
+#include "LauncherUtils.hpp"
+
+#include "Paths.hpp"
+
+namespace QtAda::launcher {
+// Сколько заранее запущенных приложений демон держит между прогонами
+static constexpr size_t DAEMON_IDLE_WARM_APPS = 1;
+static constexpr char DAEMON_HOST_SCHEME[] = "qtadadaemon";
+
+QString daemonSocketName() noexcept
+{
+    return QStringLiteral("QTADA_DAEMON_%1").arg(::getuid());
+}
+
+// Переменные, которыми окружения разных оболочек одного пользователя отличаются всегда
+static bool isShellBookkeepingVariable(const QString &variable) noexcept
+{
+    static const QStringList s_names = { QStringLiteral("_"),        QStringLiteral("SHLVL"),
+                                         QStringLiteral("OLDPWD"),   QStringLiteral("PWD"),
+                                         QStringLiteral("COLUMNS"),  QStringLiteral("LINES"),
+                                         QStringLiteral("WINDOWID"), QStringLiteral("TMUX_PANE") };
+    static const QStringList s_prefixes
+        = { QStringLiteral("TERM_SESSION_ID"), QStringLiteral("SHELL_SESSION_ID"),
+            QStringLiteral("KONSOLE_"), QStringLiteral("GNOME_TERMINAL_"),
+            QStringLiteral("VSCODE_"), QStringLiteral("SSH_CLIENT"),
+            QStringLiteral("SSH_CONNECTION") };
+
+    const auto name = variable.left(variable.indexOf('='));
+    return s_names.contains(name)
+           || std::any_of(s_prefixes.cbegin(), s_prefixes.cend(),
+                          [&name](const QString &prefix) { return name.startsWith(prefix); });
+}
+
+/*
+ * Заранее запущенные приложения зависят от всех настроек прогона, кроме самих скриптов и
+ * служебных переменных оболочки, а также от времени изменения исполняемого файла: после
+ * пересборки приложения его старые экземпляры использовать нельзя.
+ */
+static QByteArray launcherKey(const UserLaunchOptions &options) noexcept
+{
+    assert(!options.runSettings.isEmpty());
+    auto keyOptions = options;
+    auto keySettings = options.runSettings.constFirst();
+    keySettings.scriptPath.clear();
+    keyOptions.runSettings = { keySettings };
+    keyOptions.environment.erase(std::remove_if(keyOptions.environment.begin(),
+                                                keyOptions.environment.end(),
+                                                isShellBookkeepingVariable),
+                                 keyOptions.environment.end());
+    keyOptions.environment.sort();
+
+    const QFileInfo exeInfo(
+        utils::absoluteExecutablePath(options.launchAppArguments.constFirst()));
+    return keyOptions.toJson()
+           + QByteArray::number(exeInfo.lastModified().toMSecsSinceEpoch());
+}
+
+Daemon::Daemon(QObject *parent) noexcept
+    : QObject{ parent }
+    , lockFile_{ paths::QTADA_DAEMON_LOCK }
+{
+    // Блокировка снимается только вместе с процессом демона, а не по истечении времени
+    lockFile_.setStaleLockTime(0);
+}
+
+Daemon::~Daemon() noexcept
+{
+    // Вместе с Launcher закрываются и заранее запущенные им приложения
+    launcher_.reset();
+}
+
+bool Daemon::start() noexcept
+{
+    QDir().mkpath(QFileInfo(paths::QTADA_DAEMON_LOCK).absolutePath());
+    if (!lockFile_.tryLock(0)) {
+        return false;
+    }
+    if (!startServer()) {
+        // Иначе запуск демона считался бы его работой (см. DaemonClient::isDaemonRunning)
+        lockFile_.unlock();
+        return false;
+    }
+    return true;
+}
+
+bool Daemon::startServer() noexcept
+{
+    // Демон запускает любое переданное ему приложение, поэтому сокет доступен только его
+    // пользователю. QRemoteObjectHost в Qt 5 не позволяет задать права своему QLocalServer,
+    // поэтому соединения принимает собственный сервер
+    const auto socketName = daemonSocketName();
+    QLocalServer::removeServer(socketName);
+    daemonServer_ = new QLocalServer(this);
+    daemonServer_->setSocketOptions(QLocalServer::UserAccessOption);
+    if (!daemonServer_->listen(socketName)) {
+        return false;
+    }
+
+    // Для внешних соединений QtRO принимает только схему, которую сам не обслуживает (для
+    // local: он попытался бы открыть свой сервер), поэтому адрес хоста служит лишь его
+    // именем, а клиенты подключаются к сокету по local:
+    daemonHost_ = new QRemoteObjectHost(this);
+    if (!daemonHost_->setHostUrl(QUrl(QStringLiteral("%1:%2").arg(DAEMON_HOST_SCHEME, socketName)),
+                                 QRemoteObjectHost::AllowExternalRegistration)) {
+        return false;
+    }
+    connect(daemonServer_, &QLocalServer::newConnection, this, [this] {
+        while (daemonServer_->hasPendingConnections()) {
+            daemonHost_->addHostSideConnection(daemonServer_->nextPendingConnection());
+        }
+    });
+    daemonController_ = new DaemonController(this);
+    connect(daemonController_, &DaemonController::jobSubmitted, this, &Daemon::enqueueJob);
+    connect(daemonController_, &DaemonController::stopRequested, this, &Daemon::daemonFinished);
+    return daemonHost_->enableRemoting(daemonController_);
+}
+
+void Daemon::enqueueJob(const QString &jobId, const QByteArray &options) noexcept
+{
+    auto jobOptions = UserLaunchOptions::fromJson(options);
+    if (jobOptions.launchAppArguments.isEmpty() || jobOptions.runSettings.isEmpty()) {
+        emit daemonController_->jobMessage(jobId, static_cast<int>(DaemonMessageType::LauncherErr),
+                                           QStringLiteral("Invalid job for the QtAda daemon."));
+        emit daemonController_->jobFinished(jobId, 1);
+        return;
+    }
+
+    jobs_.push_back({ jobId, std::move(jobOptions) });
+    startNextJob();
+}
+
+void Daemon::startNextJob() noexcept
+{
+    if (!runningJobId_.isEmpty() || jobs_.empty()) {
+        return;
+    }
+    auto job = std::move(jobs_.front());
+    jobs_.pop_front();
+    runningJobId_ = job.id;
+
+    const auto key = launcherKey(job.options);
+    if (launcher_ == nullptr || key != launcherKey_) {
+        // Приложения, запущенные с другими настройками, следующим прогонам не подойдут
+        auto launcherOptions = job.options;
+        launcherOptions.runSettings.clear();
+        launcher_ = std::make_unique<Launcher>(launcherOptions, LauncherMode::Daemon);
+        launcherKey_ = key;
+
+        const auto forward = [this](auto signal, DaemonMessageType type) {
+            connect(launcher_.get(), signal, this,
+                    [this, type](const QString &msg) { sendMessage(type, msg); });
+        };
+        forward(&Launcher::stdMessage, DaemonMessageType::StdMessage);
+        forward(&Launcher::launcherOutMessage, DaemonMessageType::LauncherOut);
+        forward(&Launcher::launcherErrMessage, DaemonMessageType::LauncherErr);
+        forward(&Launcher::scriptRunService, DaemonMessageType::ScriptRunService);
+        forward(&Launcher::scriptRunResult, DaemonMessageType::ScriptRunResult);
+        forward(&Launcher::scriptRunError, DaemonMessageType::ScriptRunError);
+        forward(&Launcher::scriptRunWarning, DaemonMessageType::ScriptRunWarning);
+        forward(&Launcher::scriptRunLog, DaemonMessageType::ScriptRunLog);
+        // Прогон может завершиться и внутри runScripts (например, если не найден зонд)
+        connect(
+            launcher_.get(), &Launcher::launcherFinished, this,
+            [this] { finishJob(launcher_->exitCode()); }, Qt::QueuedConnection);
+    }
+
+    launcher_->runScripts(job.options.runSettings);
+}
+
+void Daemon::finishJob(int exitCode) noexcept
+{
+    assert(!runningJobId_.isEmpty());
+    emit daemonController_->jobFinished(runningJobId_, exitCode);
+    runningJobId_.clear();
+    // Остальные заранее запущенные приложения нужны только во время прогона
+    launcher_->trimWarmPool(DAEMON_IDLE_WARM_APPS);
+    QMetaObject::invokeMethod(this, &Daemon::startNextJob, Qt::QueuedConnection);
+}
+
+void Daemon::sendMessage(DaemonMessageType type, const QString &msg) noexcept
+{
+    if (runningJobId_.isEmpty()) {
+        // Вывод заранее запущенных приложений между прогонами никому не нужен
+        return;
+    }
+    emit daemonController_->jobMessage(runningJobId_, static_cast<int>(type), msg);
+}
+} // namespace QtAda::launcher
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QLockFile>
+#include <QObject>
+#include <deque>
+#include <memory>
+
+#include "LaunchOptions.hpp"
+
+QT_BEGIN_NAMESPACE
+class QLocalServer;
+class QRemoteObjectHost;
+QT_END_NAMESPACE
+
+namespace QtAda::launcher {
+class DaemonController;
+class Launcher;
+
+// Тип сообщения Launcher, которое демон пересылает клиенту
+enum class DaemonMessageType {
+    StdMessage = 0,
+    LauncherOut = 1,
+    LauncherErr = 2,
+    ScriptRunService = 3,
+    ScriptRunResult = 4,
+    ScriptRunError = 5,
+    ScriptRunWarning = 6,
+    ScriptRunLog = 7,
+};
+
+// Имя локального сокета демона, которое зависит от uid пользователя
+QString daemonSocketName() noexcept;
+
+/*
+ * Фоновый процесс (qtada --daemon), который выполняет прогоны, переданные клиентами
+ * (DaemonClient), по одному за раз. Launcher и заранее запущенные им тестируемые
+ * приложения, как и кэш ABI, сохраняются между прогонами, поэтому следующий прогон с теми
+ * же настройками начинается в уже запущенном приложении. Прогон с другими настройками
+ * (приложение, его аргументы, окружение или настройки прогона) заменяет Launcher.
+ */
+class Daemon final : public QObject {
+    Q_OBJECT
+public:
+    explicit Daemon(QObject *parent = nullptr) noexcept;
+    ~Daemon() noexcept override;
+
+    // Возвращает false, если демон уже запущен или не удалось открыть его сокет
+    bool start() noexcept;
+
+signals:
+    void daemonFinished();
+
+private slots:
+    void enqueueJob(const QString &jobId, const QByteArray &options) noexcept;
+    void startNextJob() noexcept;
+
+private:
+    struct Job final {
+        QString id;
+        UserLaunchOptions options;
+    };
+    std::deque<Job> jobs_;
+    QString runningJobId_;
+
+    std::unique_ptr<Launcher> launcher_;
+    QByteArray launcherKey_;
+
+    QLockFile lockFile_;
+    QLocalServer *daemonServer_ = nullptr;
+    QRemoteObjectHost *daemonHost_ = nullptr;
+    DaemonController *daemonController_ = nullptr;
+
+    bool startServer() noexcept;
+    void finishJob(int exitCode) noexcept;
+    void sendMessage(DaemonMessageType type, const QString &msg) noexcept;
+};
+} // namespace QtAda::launcher
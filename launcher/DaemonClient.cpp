@@ -0,0 +1,179 @@
+#include "DaemonClient.hpp"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QProcessEnvironment>
+#include <QRemoteObjectNode>
+#include <QTimer>
+#include <QUrl>
+#include <algorithm>
+
+#include <rep_DaemonController_replica.h>
+
+#include "Daemon.hpp"
+#include "LauncherUtils.hpp"
+
+#include "Common.hpp"
+#include "Paths.hpp"
+
+namespace QtAda::launcher {
+static constexpr int DAEMON_CONNECTION_TIMEOUT_MSEC = 3000;
+
+static UserLaunchOptions optionsForDaemon(UserLaunchOptions options) noexcept
+{
+    assert(!options.launchAppArguments.isEmpty());
+    options.workingDirectory = QFileInfo(options.workingDirectory.isEmpty()
+                                             ? QDir::currentPath()
+                                             : options.workingDirectory)
+                                   .absoluteFilePath();
+    auto &exePath = options.launchAppArguments.first();
+    const auto absoluteExePath = utils::absoluteExecutablePath(exePath);
+    if (!absoluteExePath.isEmpty()) {
+        exePath = absoluteExePath;
+    }
+    for (auto &settings : options.runSettings) {
+        settings.scriptPath = QFileInfo(settings.scriptPath).absoluteFilePath();
+    }
+    options.environment = QProcessEnvironment::systemEnvironment().toStringList();
+    // Демон держит запущенным хотя бы одно приложение для следующего прогона
+    options.warmPoolSize = std::max(options.warmPoolSize, 1);
+    return options;
+}
+
+DaemonClient::DaemonClient(const UserLaunchOptions &options, QObject *parent) noexcept
+    : QObject{ parent }
+    , options_{ optionsForDaemon(options) }
+    , jobId_{ QStringLiteral("%1_%2")
+                  .arg(QCoreApplication::applicationPid())
+                  .arg(QDateTime::currentMSecsSinceEpoch()) }
+    , daemonNode_{ new QRemoteObjectNode(this) }
+{
+}
+
+DaemonClient::~DaemonClient() noexcept = default;
+
+bool DaemonClient::isDaemonRunning() noexcept
+{
+    // Файл блокировки держит сам демон, поэтому проверка не требует подключения к нему
+    QLockFile lockFile(paths::QTADA_DAEMON_LOCK);
+    lockFile.setStaleLockTime(0);
+    if (lockFile.tryLock(0)) {
+        lockFile.unlock();
+        return false;
+    }
+    return lockFile.error() == QLockFile::LockFailedError;
+}
+
+bool DaemonClient::canRunInDaemon(const UserLaunchOptions &options) noexcept
+{
+    return options.type == LaunchType::Run && options.useDaemon && options.jobs == 1
+           && !options.runSettings.isEmpty() && !options.runSettings.constFirst().session;
+}
+
+bool DaemonClient::stopDaemon() noexcept
+{
+    QRemoteObjectNode daemonNode;
+    daemonNode.connectToNode(QUrl(QStringLiteral("local:%1").arg(daemonSocketName())));
+    std::unique_ptr<DaemonControllerReplica> daemonController(
+        daemonNode.acquire<DaemonControllerReplica>());
+    if (!daemonController->waitForSource(DAEMON_CONNECTION_TIMEOUT_MSEC)) {
+        return false;
+    }
+
+    // Запрос считается выполненным, когда демон закрыл соединение
+    QEventLoop loop;
+    QTimer::singleShot(DAEMON_CONNECTION_TIMEOUT_MSEC, &loop, &QEventLoop::quit);
+    connect(daemonController.get(), &QRemoteObjectReplica::stateChanged, &loop,
+            [&loop](QRemoteObjectReplica::State state) {
+                if (state != QRemoteObjectReplica::Valid) {
+                    loop.quit();
+                }
+            });
+    daemonController->sendStopRequest();
+    loop.exec();
+    return daemonController->state() != QRemoteObjectReplica::Valid;
+}
+
+bool DaemonClient::connectToDaemon() noexcept
+{
+    daemonNode_->connectToNode(QUrl(QStringLiteral("local:%1").arg(daemonSocketName())));
+    daemonController_.reset(daemonNode_->acquire<DaemonControllerReplica>());
+    return daemonController_->waitForSource(DAEMON_CONNECTION_TIMEOUT_MSEC);
+}
+
+bool DaemonClient::submit() noexcept
+{
+    if (!connectToDaemon()) {
+        return false;
+    }
+
+    connect(daemonController_.get(), &DaemonControllerReplica::jobMessage, this,
+            &DaemonClient::handleJobMessage);
+    connect(daemonController_.get(), &DaemonControllerReplica::jobFinished, this,
+            &DaemonClient::handleJobFinished);
+    connect(daemonController_.get(), &QRemoteObjectReplica::stateChanged, this,
+            [this](QRemoteObjectReplica::State state) {
+                if (isFinished_ || state == QRemoteObjectReplica::Valid) {
+                    return;
+                }
+                printQtAdaErrorMessage(
+                    QStringLiteral("The connection to the QtAda daemon was lost."));
+                isFinished_ = true;
+                exitCode_ = 1;
+                emit jobFinished();
+            });
+    daemonController_->sendJob(jobId_, options_.toJson());
+    return true;
+}
+
+void DaemonClient::handleJobMessage(const QString &jobId, int messageType,
+                                    const QString &msg) noexcept
+{
+    if (jobId != jobId_) {
+        return;
+    }
+
+    // Сообщения выводятся так же, как их выводит Launcher в LauncherMode::Console
+    const auto showAppLog = options_.showAppLogForTestRun;
+    switch (static_cast<DaemonMessageType>(messageType)) {
+    case DaemonMessageType::StdMessage:
+        if (showAppLog) {
+            printStdMessage(msg);
+        }
+        break;
+    case DaemonMessageType::LauncherOut:
+        printQtAdaOutMessage(msg);
+        break;
+    case DaemonMessageType::LauncherErr:
+        printQtAdaErrorMessage(msg);
+        break;
+    case DaemonMessageType::ScriptRunError:
+        showAppLog ? printQtAdaErrorMessage(msg) : printScriptErrorMessage(msg);
+        break;
+    case DaemonMessageType::ScriptRunWarning:
+        showAppLog ? printQtAdaWarningMessage(msg) : printScriptWarningMessage(msg);
+        break;
+    case DaemonMessageType::ScriptRunService:
+    case DaemonMessageType::ScriptRunResult:
+    case DaemonMessageType::ScriptRunLog:
+        showAppLog ? printQtAdaServiceMessage(msg) : printScriptOutMessage(msg);
+        break;
+    default:
+        Q_UNREACHABLE();
+    }
+}
+
+void DaemonClient::handleJobFinished(const QString &jobId, int exitCode) noexcept
+{
+    if (jobId != jobId_ || isFinished_) {
+        return;
+    }
+    isFinished_ = true;
+    exitCode_ = exitCode;
+    emit jobFinished();
+}
+} // namespace QtAda::launcher
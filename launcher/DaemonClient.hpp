@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QObject>
+#include <memory>
+
+#include "LaunchOptions.hpp"
+
+QT_BEGIN_NAMESPACE
+class QRemoteObjectNode;
+QT_END_NAMESPACE
+
+class DaemonControllerReplica;
+
+namespace QtAda::launcher {
+/*
+ * Передает прогон запущенному демону (см. Daemon) и выводит в консоль его сообщения так же,
+ * как их вывел бы Launcher. Пути в настройках прогона заменяются на абсолютные, а вместе с
+ * прогоном передается и окружение, так как у демона свой рабочий каталог и окружение.
+ */
+class DaemonClient final : public QObject {
+    Q_OBJECT
+public:
+    explicit DaemonClient(const UserLaunchOptions &options, QObject *parent = nullptr) noexcept;
+    ~DaemonClient() noexcept override;
+
+    static bool isDaemonRunning() noexcept;
+    // Демону передаются только обычные прогоны: без -j, --session и записи сценария
+    static bool canRunInDaemon(const UserLaunchOptions &options) noexcept;
+    static bool stopDaemon() noexcept;
+
+    // Возвращает false, если к демону не удалось подключиться
+    bool submit() noexcept;
+    int exitCode() const noexcept
+    {
+        return exitCode_;
+    }
+
+signals:
+    void jobFinished();
+
+private slots:
+    void handleJobMessage(const QString &jobId, int messageType, const QString &msg) noexcept;
+    void handleJobFinished(const QString &jobId, int exitCode) noexcept;
+
+private:
+    UserLaunchOptions options_;
+    const QString jobId_;
+
+    QRemoteObjectNode *daemonNode_ = nullptr;
+    std::unique_ptr<DaemonControllerReplica> daemonController_;
+
+    int exitCode_ = 0;
+    bool isFinished_ = false;
+
+    bool connectToDaemon() noexcept;
+};
+} // namespace QtAda::launcher
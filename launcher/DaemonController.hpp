@@ -0,0 +1,30 @@
+#pragma once
+
+#include <rep_DaemonController_source.h>
+
+namespace QtAda::launcher {
+class DaemonController final : public DaemonControllerSimpleSource {
+    Q_OBJECT
+public:
+    DaemonController(QObject *parent = nullptr) noexcept
+        : DaemonControllerSimpleSource{ parent }
+    {
+    }
+
+public Q_SLOTS:
+    // DaemonClient -> Daemon slots:
+    void sendJob(const QString &jobId, const QByteArray &options) override
+    {
+        emit this->jobSubmitted(jobId, options);
+    }
+    void sendStopRequest() override
+    {
+        emit this->stopRequested();
+    }
+
+Q_SIGNALS:
+    // DaemonClient -> Daemon signals:
+    void jobSubmitted(const QString &jobId, const QByteArray &options);
+    void stopRequested();
+};
+} // namespace QtAda::launcher
@@ -0,0 +1,466 @@
+#include "ElfReader.hpp"
+
+#include <config.h>
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#ifdef HAVE_ELF_H
+#include <elf.h>
+#endif
+#if defined(HAVE_SYS_ELF_H) && !defined(HAVE_ELF_H)
+#include <sys/elf.h>
+#endif
+
+namespace QtAda::launcher::elf {
+namespace {
+// Файл, отображенный в память на время своего существования
+class MappedFile final {
+public:
+    explicit MappedFile(const QString &path) noexcept
+        : file_{ path }
+    {
+        if (file_.open(QFile::ReadOnly) && file_.size() > 0) {
+            data_ = file_.map(0, file_.size());
+            size_ = data_ != nullptr ? static_cast<quint64>(file_.size()) : 0;
+        }
+    }
+
+    const uchar *data() const noexcept
+    {
+        return data_;
+    }
+    quint64 size() const noexcept
+    {
+        return size_;
+    }
+
+private:
+    QFile file_;
+    const uchar *data_ = nullptr;
+    quint64 size_ = 0;
+};
+
+template <typename T> T readValue(const uchar *data) noexcept
+{
+    // Данные в файле могут быть не выровнены, поэтому не обращаемся к ним по указателю
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+std::optional<int> readNumber(const QByteArray &content, int &index) noexcept
+{
+    const auto start = index;
+    while (index < content.size() && index - start < 4 && content.at(index) >= '0'
+           && content.at(index) <= '9') {
+        index++;
+    }
+    if (index == start) {
+        return std::nullopt;
+    }
+    return content.mid(start, index - start).toInt();
+}
+} // namespace
+
+#ifdef HAVE_ELF
+namespace {
+struct ElfObject final {
+    QString path;
+    unsigned char elfClass = ELFCLASSNONE;
+    quint16 machine = EM_NONE;
+    QVector<QByteArray> needed;
+    std::optional<QByteArray> rpath;
+    std::optional<QByteArray> runpath;
+};
+
+template <typename Ehdr, typename Phdr, typename Dyn>
+bool readDynamicSection(const uchar *data, quint64 size, ElfObject &object) noexcept
+{
+    if (size < sizeof(Ehdr)) {
+        return false;
+    }
+    const auto header = readValue<Ehdr>(data);
+    object.machine = header.e_machine;
+
+    const quint64 segmentsOffset = header.e_phoff;
+    if (header.e_phentsize != sizeof(Phdr) || segmentsOffset > size
+        || header.e_phnum > (size - segmentsOffset) / sizeof(Phdr)) {
+        return false;
+    }
+    std::vector<Phdr> segments;
+    segments.reserve(header.e_phnum);
+    for (quint64 i = 0; i < header.e_phnum; i++) {
+        segments.push_back(readValue<Phdr>(data + segmentsOffset + i * sizeof(Phdr)));
+    }
+
+    const auto dynamic = std::find_if(segments.begin(), segments.end(), [](const Phdr &segment) {
+        return segment.p_type == PT_DYNAMIC;
+    });
+    if (dynamic == segments.end()) {
+        // У статически собранного файла зависимостей нет
+        return true;
+    }
+    if (dynamic->p_offset > size || dynamic->p_filesz > size - dynamic->p_offset) {
+        return false;
+    }
+
+    std::optional<quint64> stringTable;
+    std::vector<quint64> needed;
+    std::optional<quint64> rpath;
+    std::optional<quint64> runpath;
+    const quint64 entriesCount = dynamic->p_filesz / sizeof(Dyn);
+    for (quint64 i = 0; i < entriesCount; i++) {
+        const auto entry = readValue<Dyn>(data + dynamic->p_offset + i * sizeof(Dyn));
+        if (entry.d_tag == DT_NULL) {
+            break;
+        }
+        switch (entry.d_tag) {
+        case DT_STRTAB:
+            stringTable = entry.d_un.d_ptr;
+            break;
+        case DT_NEEDED:
+            needed.push_back(entry.d_un.d_val);
+            break;
+        case DT_RPATH:
+            rpath = entry.d_un.d_val;
+            break;
+        case DT_RUNPATH:
+            runpath = entry.d_un.d_val;
+            break;
+        default:
+            break;
+        }
+    }
+    if (needed.empty() && !rpath.has_value() && !runpath.has_value()) {
+        return true;
+    }
+    if (!stringTable.has_value()) {
+        return false;
+    }
+
+    // DT_STRTAB содержит виртуальный адрес, который переводится в смещение в файле через
+    // сегмент PT_LOAD, в который этот адрес попадает
+    std::optional<quint64> stringTableOffset;
+    for (const auto &segment : segments) {
+        if (segment.p_type == PT_LOAD && *stringTable >= segment.p_vaddr
+            && *stringTable - segment.p_vaddr < segment.p_filesz) {
+            stringTableOffset = *stringTable - segment.p_vaddr + segment.p_offset;
+            break;
+        }
+    }
+    if (!stringTableOffset.has_value() || *stringTableOffset >= size) {
+        return false;
+    }
+
+    const auto readString = [&](quint64 offset) {
+        if (offset >= size - *stringTableOffset) {
+            return QByteArray();
+        }
+        const auto start = *stringTableOffset + offset;
+        const auto *str = reinterpret_cast<const char *>(data + start);
+        return QByteArray(str, static_cast<int>(qstrnlen(str, size - start)));
+    };
+    for (const auto offset : needed) {
+        object.needed.push_back(readString(offset));
+    }
+    if (rpath.has_value()) {
+        object.rpath = readString(*rpath);
+    }
+    if (runpath.has_value()) {
+        object.runpath = readString(*runpath);
+    }
+    return true;
+}
+
+std::optional<ElfObject> readElfObject(const QString &path) noexcept
+{
+    const MappedFile file(path);
+    const auto *data = file.data();
+    if (data == nullptr || file.size() < EI_NIDENT
+        || qstrncmp(reinterpret_cast<const char *>(data), ELFMAG, SELFMAG) != 0) {
+        return std::nullopt;
+    }
+    // Заголовки читаются как есть, поэтому порядок байтов должен совпадать с текущей машиной
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    if (data[EI_DATA] != ELFDATA2LSB) {
+        return std::nullopt;
+    }
+#else
+    if (data[EI_DATA] != ELFDATA2MSB) {
+        return std::nullopt;
+    }
+#endif
+
+    ElfObject object;
+    object.path = path;
+    object.elfClass = data[EI_CLASS];
+    bool isRead = false;
+    switch (object.elfClass) {
+    case ELFCLASS32:
+        isRead = readDynamicSection<Elf32_Ehdr, Elf32_Phdr, Elf32_Dyn>(data, file.size(), object);
+        break;
+    case ELFCLASS64:
+        isRead = readDynamicSection<Elf64_Ehdr, Elf64_Phdr, Elf64_Dyn>(data, file.size(), object);
+        break;
+    default:
+        break;
+    }
+    return isRead ? std::make_optional(std::move(object)) : std::nullopt;
+}
+
+constexpr char LD_CACHE_PATH[] = "/etc/ld.so.cache";
+constexpr char LD_CACHE_OLD_MAGIC[] = "ld.so-1.7.0";
+constexpr char LD_CACHE_NEW_MAGIC[] = "glibc-ld.so.cache1.1";
+// Размеры заголовков и записей старого и нового форматов ld.so.cache (см. glibc dl-cache.h)
+constexpr quint64 LD_CACHE_OLD_HEADER_SIZE = 16;
+constexpr quint64 LD_CACHE_OLD_ENTRY_SIZE = 12;
+constexpr quint64 LD_CACHE_NEW_HEADER_SIZE = 48;
+constexpr quint64 LD_CACHE_NEW_ENTRY_SIZE = 24;
+
+/*
+ * Таблица библиотек из /etc/ld.so.cache в новом формате glibc. Одному имени может
+ * соответствовать несколько путей (для разных архитектур), поэтому подходящий из них
+ * выбирается уже при поиске, в том же порядке, что и в файле.
+ */
+QHash<QByteArray, QVector<QByteArray>> readLdCache() noexcept
+{
+    QHash<QByteArray, QVector<QByteArray>> libs;
+    const MappedFile file(QString::fromLatin1(LD_CACHE_PATH));
+    const auto *data = file.data();
+    const auto size = file.size();
+    if (data == nullptr) {
+        return libs;
+    }
+
+    // Старые версии ldconfig записывают перед новым форматом еще и старый
+    quint64 offset = 0;
+    if (size >= LD_CACHE_OLD_HEADER_SIZE
+        && std::memcmp(data, LD_CACHE_OLD_MAGIC, sizeof(LD_CACHE_OLD_MAGIC) - 1) == 0) {
+        const auto oldCount = readValue<quint32>(data + LD_CACHE_OLD_HEADER_SIZE - 4);
+        offset = LD_CACHE_OLD_HEADER_SIZE + oldCount * LD_CACHE_OLD_ENTRY_SIZE;
+        offset = (offset + alignof(quint64) - 1) & ~quint64(alignof(quint64) - 1);
+    }
+    if (offset > size || size - offset < LD_CACHE_NEW_HEADER_SIZE
+        || std::memcmp(data + offset, LD_CACHE_NEW_MAGIC, sizeof(LD_CACHE_NEW_MAGIC) - 1)
+               != 0) {
+        return libs;
+    }
+
+    // Смещения строк в новом формате отсчитываются от начала его заголовка
+    const auto *cache = data + offset;
+    const auto cacheSize = size - offset;
+    const quint64 count = readValue<quint32>(cache + 20);
+    if (count > (cacheSize - LD_CACHE_NEW_HEADER_SIZE) / LD_CACHE_NEW_ENTRY_SIZE) {
+        return libs;
+    }
+    const auto readString = [cache, cacheSize](quint32 stringOffset) {
+        if (stringOffset >= cacheSize) {
+            return QByteArray();
+        }
+        const auto *str = reinterpret_cast<const char *>(cache + stringOffset);
+        return QByteArray(str, static_cast<int>(qstrnlen(str, cacheSize - stringOffset)));
+    };
+    for (quint64 i = 0; i < count; i++) {
+        const auto *entry = cache + LD_CACHE_NEW_HEADER_SIZE + i * LD_CACHE_NEW_ENTRY_SIZE;
+        const auto name = readString(readValue<quint32>(entry + 4));
+        const auto path = readString(readValue<quint32>(entry + 8));
+        if (!name.isEmpty() && !path.isEmpty()) {
+            libs[name].push_back(path);
+        }
+    }
+    return libs;
+}
+
+/*
+ * ldconfig может обновить /etc/ld.so.cache, пока работает демон, поэтому таблица читается
+ * заново при изменении файла.
+ */
+const QHash<QByteArray, QVector<QByteArray>> &ldCache() noexcept
+{
+    static QHash<QByteArray, QVector<QByteArray>> s_ldCache;
+    static qint64 s_ldCacheModified = -1;
+    const auto modified = ldCacheModified();
+    if (modified != s_ldCacheModified) {
+        s_ldCache = readLdCache();
+        s_ldCacheModified = modified;
+    }
+    return s_ldCache;
+}
+
+QStringList searchDirs(const std::optional<QByteArray> &paths, const QString &origin) noexcept
+{
+    QStringList dirs;
+    if (!paths.has_value()) {
+        return dirs;
+    }
+    for (const auto &dir : paths->split(':')) {
+        if (dir.isEmpty()) {
+            continue;
+        }
+        auto expandedDir = QString::fromLocal8Bit(dir);
+        expandedDir.replace(QLatin1String("${ORIGIN}"), origin);
+        expandedDir.replace(QLatin1String("$ORIGIN"), origin);
+        dirs.push_back(expandedDir);
+    }
+    return dirs;
+}
+} // namespace
+
+qint64 ldCacheModified() noexcept
+{
+    const QFileInfo ldCacheInfo(QString::fromLatin1(LD_CACHE_PATH));
+    return ldCacheInfo.exists() ? ldCacheInfo.lastModified().toMSecsSinceEpoch() : 0;
+}
+
+/*
+ * Порядок поиска библиотеки повторяет ld.so: DT_RPATH (если у загружающего объекта нет
+ * DT_RUNPATH), LD_LIBRARY_PATH, DT_RUNPATH, /etc/ld.so.cache и стандартные каталоги.
+ * Из DT_RPATH цепочки загрузивших объектов учитываются только сам объект и исполняемый
+ * файл, а подходящей считается только библиотека той же архитектуры.
+ */
+std::optional<QVector<QByteArray>> resolveDependencies(const QString &elfPath,
+                                                       const QByteArray &ldLibraryPath) noexcept
+{
+    auto executable = readElfObject(QFileInfo(elfPath).canonicalFilePath());
+    if (!executable.has_value()) {
+        return std::nullopt;
+    }
+
+    const auto &ldCacheLibs = ldCache();
+    const auto libraryPath = searchDirs(ldLibraryPath, QString());
+    const auto defaultDirs = executable->elfClass == ELFCLASS64
+                                 ? QStringList{ "/lib64", "/usr/lib64", "/lib", "/usr/lib" }
+                                 : QStringList{ "/lib", "/usr/lib", "/lib32", "/usr/lib32" };
+
+    const auto readCompatible = [&executable](const QString &path) -> std::optional<ElfObject> {
+        if (!QFileInfo::exists(path)) {
+            return std::nullopt;
+        }
+        auto library = readElfObject(path);
+        if (!library.has_value() || library->elfClass != executable->elfClass
+            || library->machine != executable->machine) {
+            return std::nullopt;
+        }
+        return library;
+    };
+    const auto findInDirs = [&readCompatible](const QByteArray &name, const QStringList &dirs) {
+        for (const auto &dir : dirs) {
+            auto library = readCompatible(QDir(dir).filePath(QString::fromLocal8Bit(name)));
+            if (library.has_value()) {
+                return library;
+            }
+        }
+        return std::optional<ElfObject>();
+    };
+
+    QVector<QByteArray> dependencies;
+    QSet<QByteArray> loadedNames;
+    std::deque<ElfObject> queue{ *executable };
+    while (!queue.empty()) {
+        const auto object = std::move(queue.front());
+        queue.pop_front();
+        const auto origin = QFileInfo(object.path).absolutePath();
+
+        for (const auto &name : object.needed) {
+            if (name.isEmpty() || loadedNames.contains(name)) {
+                continue;
+            }
+
+            std::optional<ElfObject> library;
+            if (name.contains('/')) {
+                library = readCompatible(QString::fromLocal8Bit(name));
+            }
+            else {
+                if (!object.runpath.has_value()) {
+                    library = findInDirs(name, searchDirs(object.rpath, origin));
+                    if (!library.has_value() && !executable->runpath.has_value()) {
+                        const auto executableOrigin = QFileInfo(executable->path).absolutePath();
+                        library = findInDirs(name, searchDirs(executable->rpath, executableOrigin));
+                    }
+                }
+                if (!library.has_value()) {
+                    library = findInDirs(name, libraryPath);
+                }
+                if (!library.has_value()) {
+                    library = findInDirs(name, searchDirs(object.runpath, origin));
+                }
+                if (!library.has_value()) {
+                    for (const auto &path : ldCacheLibs.value(name)) {
+                        library = readCompatible(QString::fromLocal8Bit(path));
+                        if (library.has_value()) {
+                            break;
+                        }
+                    }
+                }
+                if (!library.has_value()) {
+                    library = findInDirs(name, defaultDirs);
+                }
+            }
+
+            if (!library.has_value()) {
+                return std::nullopt;
+            }
+            loadedNames.insert(name);
+            dependencies.push_back(library->path.toLocal8Bit());
+            queue.push_back(std::move(*library));
+        }
+    }
+    return dependencies;
+}
+#else
+qint64 ldCacheModified() noexcept
+{
+    return 0;
+}
+
+std::optional<QVector<QByteArray>> resolveDependencies(const QString &elfPath,
+                                                       const QByteArray &ldLibraryPath) noexcept
+{
+    Q_UNUSED(elfPath);
+    Q_UNUSED(ldLibraryPath);
+    return std::nullopt;
+}
+#endif
+
+std::optional<std::pair<int, int>> qtVersionFromLibrary(const QString &libPath) noexcept
+{
+    const MappedFile file(libPath);
+    if (file.data() == nullptr || file.size() > static_cast<quint64>(INT_MAX)) {
+        return std::nullopt;
+    }
+    // Файл не копируется, поиск идет прямо по отображенной памяти
+    const auto content = QByteArray::fromRawData(reinterpret_cast<const char *>(file.data()),
+                                                 static_cast<int>(file.size()));
+
+    // Сначала ищем строку сборки QtCore ("This is the QtCore library version Qt 5.15.2 ..."),
+    // а если ее нет - любую строку вида "Qt x.y"
+    for (const auto &marker : { QByteArray("library version Qt "), QByteArray("Qt ") }) {
+        for (auto pos = content.indexOf(marker); pos != -1;
+             pos = content.indexOf(marker, pos + 1)) {
+            auto index = pos + marker.size();
+            const auto major = readNumber(content, index);
+            if (!major.has_value() || index >= content.size() || content.at(index) != '.') {
+                continue;
+            }
+            index++;
+            const auto minor = readNumber(content, index);
+            if (minor.has_value()) {
+                return std::make_pair(*major, *minor);
+            }
+        }
+    }
+    return std::nullopt;
+}
+} // namespace QtAda::launcher::elf
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QVector>
+#include <optional>
+
+QT_BEGIN_NAMESPACE
+class QByteArray;
+class QString;
+QT_END_NAMESPACE
+
+/*
+ * Чтение ELF файлов без запуска вспомогательных процессов (ldd, strings): зависимости
+ * находятся так же, как их ищет загрузчик ld.so, по DT_NEEDED, DT_RPATH и DT_RUNPATH.
+ */
+
+namespace QtAda::launcher::elf {
+// Возвращает пути ко всем библиотекам, которые загрузит ld.so для elfPath с заданным
+// LD_LIBRARY_PATH, или std::nullopt, если файл не удалось разобрать или какую-то из
+// библиотек не удалось найти
+std::optional<QVector<QByteArray>> resolveDependencies(const QString &elfPath,
+                                                       const QByteArray &ldLibraryPath) noexcept;
+// Время изменения /etc/ld.so.cache (0, если его нет)
+qint64 ldCacheModified() noexcept;
+// Ищет в библиотеке QtCore строку "Qt x.y.z", которую Qt встраивает в свою сборку
+std::optional<std::pair<int, int>> qtVersionFromLibrary(const QString &libPath) noexcept;
+} // namespace QtAda::launcher::elf
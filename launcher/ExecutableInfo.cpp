@@ -0,0 +1,140 @@
+#include "ExecutableInfo.hpp"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <optional>
+
+#include "ElfReader.hpp"
+#include "LauncherUtils.hpp"
+#include "ProbeDetector.hpp"
+
+#include "Paths.hpp"
+
+namespace QtAda::launcher {
+static QJsonObject loadAbiCache() noexcept
+{
+    QFile cacheFile(paths::QTADA_ABI_CACHE);
+    if (!cacheFile.open(QFile::ReadOnly)) {
+        return QJsonObject();
+    }
+    return QJsonDocument::fromJson(cacheFile.readAll()).object();
+}
+
+static void saveAbiCache(const QJsonObject &cache) noexcept
+{
+    if (!QDir().mkpath(QFileInfo(paths::QTADA_ABI_CACHE).absolutePath())) {
+        return;
+    }
+    // Файл заменяется целиком, поэтому одновременно работающие лаунчеры не испортят его
+    QSaveFile cacheFile(paths::QTADA_ABI_CACHE);
+    if (!cacheFile.open(QFile::WriteOnly)) {
+        return;
+    }
+    cacheFile.write(QJsonDocument(cache).toJson(QJsonDocument::Compact));
+    cacheFile.commit();
+}
+
+// Кэш загружается с диска при первом обращении, дальше используется его копия в памяти
+static QJsonObject &abiCache() noexcept
+{
+    static QJsonObject s_abiCache = loadAbiCache();
+    return s_abiCache;
+}
+
+static bool isFileUnchanged(const QJsonObject &entry, const QString &pathKey,
+                            const QString &sizeKey, const QString &modifiedKey) noexcept
+{
+    const QFileInfo fileInfo(entry[pathKey].toString());
+    return fileInfo.exists() && entry[sizeKey].toVariant().toLongLong() == fileInfo.size()
+           && entry[modifiedKey].toVariant().toLongLong()
+                  == fileInfo.lastModified().toMSecsSinceEpoch();
+}
+
+static QString cacheKey(const QString &exePath, const QProcessEnvironment &env) noexcept
+{
+    return QStringLiteral("%1\n%2").arg(exePath, env.value(QStringLiteral("LD_LIBRARY_PATH")));
+}
+
+static std::optional<ExecutableInfo> readCacheEntry(const QString &key) noexcept
+{
+    const auto entry = abiCache().value(key).toObject();
+    if (entry.isEmpty()
+        || entry["ldCacheModified"].toVariant().toLongLong() != elf::ldCacheModified()
+        || !isFileUnchanged(entry, QStringLiteral("path"), QStringLiteral("size"),
+                            QStringLiteral("modified"))
+        || !isFileUnchanged(entry, QStringLiteral("qtCore"), QStringLiteral("qtCoreSize"),
+                            QStringLiteral("qtCoreModified"))) {
+        return std::nullopt;
+    }
+
+    ExecutableInfo info;
+    info.probe.setQtVersion(entry["qtMajorVersion"].toInt(), entry["qtMinorVersion"].toInt());
+    info.probe.setArchitecture(entry["architecture"].toString());
+    for (const auto &lib : entry["preloadLibs"].toArray()) {
+        info.preloadLibs.push_back(lib.toString());
+    }
+    if (!info.probe.isValid()) {
+        return std::nullopt;
+    }
+    return info;
+}
+
+static void writeCacheEntry(const QString &key, const QString &exePath,
+                            const QString &qtCorePath, const ExecutableInfo &info) noexcept
+{
+    const QFileInfo exeInfo(exePath);
+    const QFileInfo qtCoreInfo(qtCorePath);
+
+    QJsonObject entry;
+    // Размеры и время изменения хранятся как double, точности которого для них достаточно
+    entry["path"] = exePath;
+    entry["size"] = static_cast<double>(exeInfo.size());
+    entry["modified"] = static_cast<double>(exeInfo.lastModified().toMSecsSinceEpoch());
+    entry["qtCore"] = qtCorePath;
+    entry["qtCoreSize"] = static_cast<double>(qtCoreInfo.size());
+    entry["qtCoreModified"] = static_cast<double>(qtCoreInfo.lastModified().toMSecsSinceEpoch());
+    entry["ldCacheModified"] = static_cast<double>(elf::ldCacheModified());
+    entry["qtMajorVersion"] = info.probe.majorQtVersion();
+    entry["qtMinorVersion"] = info.probe.minorQtVersion();
+    entry["architecture"] = info.probe.architecture();
+    entry["preloadLibs"] = QJsonArray::fromStringList(info.preloadLibs);
+
+    auto &cache = abiCache();
+    cache[key] = entry;
+    saveAbiCache(cache);
+}
+
+ExecutableInfo executableInfo(const QString &exePath, const QProcessEnvironment &env) noexcept
+{
+    const auto absoluteExePath = QFileInfo(exePath).absoluteFilePath();
+    const auto key = cacheKey(absoluteExePath, env);
+    const auto cachedInfo = readCacheEntry(key);
+    if (cachedInfo.has_value()) {
+        return *cachedInfo;
+    }
+
+    ExecutableInfo info;
+    const auto dependencies = utils::getDependenciesForExecutable(absoluteExePath, env);
+    // AddressSanitizer необходимо загрузить перед всеми остальными библиотеками
+    for (const auto &lib : dependencies) {
+        if (lib.contains("libasan.so") || lib.contains("libclang_rt.asan")) {
+            info.preloadLibs.push_back(QString::fromLocal8Bit(lib));
+            break;
+        }
+    }
+
+    const auto qtCorePath = probe::findQtCoreLibrary(dependencies);
+    info.probe = probe::detectProbeAbi(absoluteExePath, qtCorePath);
+    // Неудачный результат не кэшируется, чтобы не мешать повторной попытке
+    if (info.probe.isValid()) {
+        writeCacheEntry(key, absoluteExePath, qtCorePath, info);
+    }
+    return info;
+}
+} // namespace QtAda::launcher
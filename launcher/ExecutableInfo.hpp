@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QProcessEnvironment>
+#include <QStringList>
+
+#include "ProbeABI.hpp"
+
+namespace QtAda::launcher {
+struct ExecutableInfo final {
+    probe::ProbeABI probe;
+    // Библиотеки, которые нужно загрузить раньше зонда (например, AddressSanitizer)
+    QStringList preloadLibs;
+};
+
+/*
+ * Сведения об исполняемом файле кэшируются в памяти и на диске (paths::QTADA_ABI_CACHE) по
+ * пути к нему и LD_LIBRARY_PATH окружения запуска, от которого зависит, какие QtCore и
+ * AddressSanitizer найдет загрузчик. Запись проверяется по размеру и времени изменения файла,
+ * QtCore и /etc/ld.so.cache, так что зависимости разбираются заново только после пересборки
+ * файла, обновления QtCore или ldconfig, а не при каждом запуске.
+ */
+ExecutableInfo
+executableInfo(const QString &exePath,
+               const QProcessEnvironment &env = QProcessEnvironment::systemEnvironment()) noexcept;
+} // namespace QtAda::launcher
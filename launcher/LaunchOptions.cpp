@@ -1,5 +1,9 @@
 #include "LaunchOptions.hpp"
 
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
 #include "LauncherUtils.hpp"
 #include "ProbeDetector.hpp"
 #include "Common.hpp"
@@ -57,6 +61,11 @@ std::optional<int> UserLaunchOptions::initFromArgs(const char *appPath, QStringL
                         .arg(DEFAULT_WAITING_TIMER_VALUE));
             }
         }
+        else if (arg == QLatin1String("--hang-heartbeats")) {
+            if (!argToInt(missedHeartbeatsLimit, args.takeFirst(), arg)) {
+                return 1;
+            }
+        }
         else if (arg == QLatin1String("--no-highlight")) {
             setMsgHighlight(false);
         }
@@ -84,6 +93,25 @@ std::optional<int> UserLaunchOptions::initFromArgs(const char *appPath, QStringL
         else if ((arg == QLatin1String("-s")) || (arg == QLatin1String("--show-log"))) {
             showAppLogForTestRun = true;
         }
+        else if ((arg == QLatin1String("-j")) || (arg == QLatin1String("--jobs"))) {
+            if (!argToInt(jobs, args.takeFirst(), arg)) {
+                return 1;
+            }
+        }
+        else if (arg == QLatin1String("--daemon")) {
+            daemonCommand = DaemonCommand::Start;
+        }
+        else if (arg == QLatin1String("--daemon-stop")) {
+            daemonCommand = DaemonCommand::Stop;
+        }
+        else if (arg == QLatin1String("--no-daemon")) {
+            useDaemon = false;
+        }
+        else if (arg == QLatin1String("--warm-pool")) {
+            if (!argToInt(warmPoolSize, args.takeFirst(), arg)) {
+                return 1;
+            }
+        }
         else if (arg == QLatin1String("--indent-width")) {
             if (!argToInt(recordSettings.indentWidth, args.takeFirst(), arg)) {
                 return 1;
@@ -123,6 +151,11 @@ std::optional<int> UserLaunchOptions::initFromArgs(const char *appPath, QStringL
                 return 1;
             }
         }
+        else if (arg == QLatin1String("--bind-objects")) {
+            if (!argToInt(recordSettings.objectBindingMinimumCount, args.takeFirst(), arg)) {
+                return 1;
+            }
+        }
         else if (arg == QLatin1String("--retrieval-attempts")) {
             if (!argToInt(standartRunSettings.retrievalAttempts, args.takeFirst(), arg)) {
                 return 1;
@@ -143,9 +176,26 @@ std::optional<int> UserLaunchOptions::initFromArgs(const char *appPath, QStringL
                 return 1;
             }
         }
+        else if (arg == QLatin1String("--event-settle-time")) {
+            if (!argToInt(standartRunSettings.eventSettleTime, args.takeFirst(), arg)) {
+                return 1;
+            }
+        }
+        else if (arg == QLatin1String("--on-demand-paths")) {
+            standartRunSettings.pathResolution = PathResolution::OnDemand;
+        }
         else if (arg == QLatin1String("--show-elapsed")) {
             standartRunSettings.showElapsed = true;
         }
+        else if (arg == QLatin1String("--session")) {
+            standartRunSettings.session = true;
+        }
+        else if (arg == QLatin1String("--session-close-windows")) {
+            standartRunSettings.sessionCloseWindows = true;
+        }
+        else if (arg == QLatin1String("--session-reset")) {
+            standartRunSettings.sessionResetScript = std::move(args.takeFirst());
+        }
         // Нужен только для разработчиков QtAda, так как используется только для внутренних
         // автотестов.
         else if (arg == QLatin1String("--auto-record")) {
@@ -157,6 +207,15 @@ std::optional<int> UserLaunchOptions::initFromArgs(const char *appPath, QStringL
         }
     }
 
+    if (daemonCommand != DaemonCommand::None) {
+        if (type != LaunchType::None || !args.isEmpty()) {
+            printQtAdaErrorMessage(
+                QStringLiteral("Daemon commands do not take a launch type or an application."));
+            return 1;
+        }
+        return std::nullopt;
+    }
+
     switch (type) {
     case LaunchType::Record: {
         const auto errors = recordSettings.findErrors();
@@ -177,6 +236,18 @@ std::optional<int> UserLaunchOptions::initFromArgs(const char *appPath, QStringL
         if (autoRecord) {
             errors.push_back("Mode 'Auto Record' is only for Launch Type == Record.");
         }
+        if (jobs < 1) {
+            errors.push_back("The number of jobs must be at least 1.");
+        }
+        if (missedHeartbeatsLimit < 0) {
+            errors.push_back("The number of missed heartbeats cannot be negative.");
+        }
+        if (warmPoolSize < 0) {
+            errors.push_back("The warm pool size cannot be negative.");
+        }
+        else if (warmPoolSize > 0 && !runSettings.isEmpty() && runSettings.constFirst().session) {
+            errors.push_back("The warm pool is not for the session mode.");
+        }
         if (!errors.empty()) {
             printErrors(std::move(errors));
             return 1;
@@ -200,13 +271,68 @@ std::optional<int> UserLaunchOptions::initFromArgs(const char *appPath, QStringL
     return std::nullopt;
 }
 
+const QByteArray UserLaunchOptions::toJson() const noexcept
+{
+    assert(type == LaunchType::Run);
+    QJsonObject obj;
+    obj["launchAppArguments"] = QJsonArray::fromStringList(launchAppArguments);
+    obj["workingDirectory"] = this->workingDirectory;
+    obj["timeoutValue"] = this->timeoutValue;
+    obj["missedHeartbeatsLimit"] = this->missedHeartbeatsLimit;
+    obj["showAppLogForTestRun"] = this->showAppLogForTestRun;
+    obj["warmPoolSize"] = this->warmPoolSize;
+    obj["environment"] = QJsonArray::fromStringList(environment);
+    QJsonArray runSettingsArray;
+    for (const auto &settings : runSettings) {
+        runSettingsArray.push_back(QJsonDocument::fromJson(settings.toJson()).object());
+    }
+    obj["runSettings"] = runSettingsArray;
+    const auto document = QJsonDocument(obj);
+    return document.toJson(QJsonDocument::Compact);
+}
+
+const UserLaunchOptions UserLaunchOptions::fromJson(const QByteArray &data) noexcept
+{
+    QJsonDocument readDoc = QJsonDocument::fromJson(data);
+    QJsonObject obj = readDoc.object();
+    UserLaunchOptions options;
+    options.type = LaunchType::Run;
+    for (const auto &arg : obj["launchAppArguments"].toArray()) {
+        options.launchAppArguments.push_back(arg.toString());
+    }
+    options.workingDirectory = obj["workingDirectory"].toString();
+    options.timeoutValue = obj["timeoutValue"].toInt(DEFAULT_WAITING_TIMER_VALUE);
+    options.missedHeartbeatsLimit
+        = obj["missedHeartbeatsLimit"].toInt(DEFAULT_MISSED_HEARTBEATS_LIMIT);
+    options.showAppLogForTestRun = obj["showAppLogForTestRun"].toBool();
+    options.warmPoolSize = obj["warmPoolSize"].toInt();
+    for (const auto &variable : obj["environment"].toArray()) {
+        options.environment.push_back(variable.toString());
+    }
+    for (const auto &settings : obj["runSettings"].toArray()) {
+        options.runSettings.push_back(
+            RunSettings::fromJson(QJsonDocument(settings.toObject()).toJson()));
+    }
+    return options;
+}
+
 LaunchOptions::LaunchOptions(const UserLaunchOptions &options) noexcept
     : userOptions(std::move(options))
     , env(QProcessEnvironment::systemEnvironment())
 {
     assert(!options.launchAppArguments.isEmpty());
 
+    if (!options.environment.isEmpty()) {
+        env.clear();
+        for (const auto &variable : options.environment) {
+            const auto separatorIndex = variable.indexOf('=');
+            if (separatorIndex > 0) {
+                env.insert(variable.left(separatorIndex), variable.mid(separatorIndex + 1));
+            }
+        }
+    }
+
     absoluteExecutablePath = utils::absoluteExecutablePath(options.launchAppArguments.constFirst());
-    probe = probe::detectProbeAbiForExecutable(absoluteExecutablePath);
+    probe = probe::detectProbeAbiForExecutable(absoluteExecutablePath, env);
 }
 } // namespace QtAda::launcher
@@ -14,13 +14,36 @@ enum class LauncherState {
     InjectorFailed = 2,
 };
 
+enum class DaemonCommand {
+    None = 0,
+    // Запустить демон, который держит тестируемые приложения запущенными между прогонами
+    Start = 1,
+    Stop = 2,
+};
+
 struct UserLaunchOptions final {
     QStringList launchAppArguments;
     QString workingDirectory;
     int timeoutValue = DEFAULT_WAITING_TIMER_VALUE;
+    // Число пропущенных подряд сигналов из GUI-потока тестируемого приложения (каждые
+    // HEARTBEAT_INTERVAL_MSEC), после которого оно считается зависшим и закрывается
+    // (используется только в режиме прогона, 0 - без проверки)
+    int missedHeartbeatsLimit = DEFAULT_MISSED_HEARTBEATS_LIMIT;
 
     // Используется только в режиме прогона тестового сценария
     bool showAppLogForTestRun = false;
+    // Число одновременно запущенных тестируемых приложений, между которыми распределяются
+    // скрипты (используется только в режиме прогона тестового сценария)
+    int jobs = 1;
+    // Число заранее запущенных тестируемых приложений, которые ждут своего скрипта, пока
+    // выполняется текущий (используется только в режиме прогона тестового сценария)
+    int warmPoolSize = 0;
+    // Прогон передается демону, если он запущен (используется только в режиме прогона)
+    bool useDaemon = true;
+    DaemonCommand daemonCommand = DaemonCommand::None;
+    // Окружение тестируемого приложения в виде "NAME=value", которое передается демону
+    // клиентом (если не задано, то используется окружение лаунчера)
+    QStringList environment;
     // Используется только для автоматического записи сценария (--auto-record)
     bool autoRecord = false;
 
@@ -29,6 +52,9 @@ struct UserLaunchOptions final {
     QList<RunSettings> runSettings;
 
     std::optional<int> initFromArgs(const char *appPath, QStringList args) noexcept;
+    // Используются для передачи прогона демону, поэтому сохраняются только настройки прогона
+    const QByteArray toJson() const noexcept;
+    static const UserLaunchOptions fromJson(const QByteArray &data) noexcept;
 };
 
 struct LaunchOptions final {
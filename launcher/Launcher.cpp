@@ -2,42 +2,56 @@
 
 #include <QApplication>
 #include <QFile>
+#include <QUrl>
+#include <algorithm>
+#include <utility>
 
 #include "injector/PreloadInjector.hpp"
 #include "InprocessDialog.hpp"
 #include "InprocessRunner.hpp"
 
+#include "ThreadStacksCollector.hpp"
+
 #include "Common.hpp"
+#include "Paths.hpp"
 
 namespace QtAda::launcher {
-Launcher::Launcher(const UserLaunchOptions &userOptions, bool fromGui, QObject *parent) noexcept
-    : options_{ userOptions }
-    , initFromGui_{ fromGui }
+static QString uniqueRemoteObjectUrl() noexcept
+{
+    static int s_launcherCount = 0;
+    return QStringLiteral("%1_%2_%3")
+        .arg(paths::REMOTE_OBJECT_PATH)
+        .arg(QCoreApplication::applicationPid())
+        .arg(s_launcherCount++);
+}
+
+Launcher::Launcher(const UserLaunchOptions &userOptions, LauncherMode mode,
+                   QObject *parent) noexcept
+    : QObject{ parent }
+    , mode_{ mode }
+    , remoteObjectUrl_{ uniqueRemoteObjectUrl() }
+    , options_{ userOptions }
 {
     const auto type = options_.userOptions.type;
 
     waitingTimer_.setInterval(options_.userOptions.timeoutValue * 1000);
     waitingTimer_.setSingleShot(true);
     connect(&waitingTimer_, &QTimer::timeout, this, &Launcher::timeout);
+    hangTimer_.setInterval(options_.userOptions.missedHeartbeatsLimit * HEARTBEAT_INTERVAL_MSEC);
+    hangTimer_.setSingleShot(true);
+    connect(&hangTimer_, &QTimer::timeout, this, &Launcher::applicationHung);
 
     injector_ = std::make_unique<injector::PreloadInjector>();
-    connect(injector_.get(), &injector::AbstractInjector::started, this, &Launcher::restartTimer);
-    connect(injector_.get(), &injector::AbstractInjector::finished, this,
-            &Launcher::injectorFinished, Qt::QueuedConnection);
+    connectInjectorState();
+    connectInjectorOutput(injector_.get());
 
-    if (initFromGui_) {
-        connect(injector_.get(), &injector::AbstractInjector::stdMessage, this,
-                &Launcher::stdMessage);
-    }
-    else {
+    if (mode_ == LauncherMode::Console) {
         switch (type) {
         case LaunchType::Record: {
-            connect(injector_.get(), &injector::AbstractInjector::stdMessage, printStdMessage);
             break;
         }
         case LaunchType::Run: {
             if (options_.userOptions.showAppLogForTestRun) {
-                connect(injector_.get(), &injector::AbstractInjector::stdMessage, printStdMessage);
                 connect(this, &Launcher::scriptRunError, printQtAdaErrorMessage);
                 connect(this, &Launcher::scriptRunWarning, printQtAdaWarningMessage);
                 connect(this, &Launcher::scriptRunLog, printQtAdaServiceMessage);
@@ -62,32 +76,15 @@ Launcher::Launcher(const UserLaunchOptions &userOptions, bool fromGui, QObject *
 
     if (type == LaunchType::Run) {
         connect(this, &Launcher::launcherReadyForNextTest, this, [this] {
-            const auto testedScript = options_.runningScript;
-            assert(!testedScript.isEmpty());
-            const auto code = exitCode();
-            emit scriptFinished(code);
-            if (code == 0) {
-                scriptsRunData_.testsPassed++;
-                emit scriptRunService(QStringLiteral("[       OK ] %1").arg(testedScript));
-            }
-            else {
-                scriptsRunData_.testsFailed++;
-                emit scriptRunService(QStringLiteral("[     FAIL ] %1").arg(testedScript));
+            // В режиме сессии приложение закрывается и после того, как результат последнего
+            // скрипта уже учтен, а во время выполнения скрипта - только при его падении
+            // или по запросу скрипта
+            if (!options_.runningScript.isEmpty()) {
+                handleScriptFinished(exitCode());
             }
 
             if (options_.userOptions.runSettings.isEmpty()) {
-                emit scriptRunResult("[==========]");
-                if (scriptsRunData_.testsFailed > 0) {
-                    options_.exitCode = 1;
-                    emit scriptRunResult(QStringLiteral("[  FAILED  ] Passed: %1 | Failed: %2")
-                                             .arg(scriptsRunData_.testsPassed)
-                                             .arg(scriptsRunData_.testsFailed));
-                }
-                else {
-                    emit scriptRunResult(
-                        QStringLiteral("[  PASSED  ] %1 tests").arg(scriptsRunData_.testsPassed));
-                }
-                emit launcherFinished();
+                finishRun();
             }
             else {
                 emit nextScriptStarted();
@@ -102,6 +99,74 @@ Launcher::~Launcher() noexcept
     if (injector_ != nullptr) {
         injector_->stop();
     }
+    // Заранее запущенные приложения, до которых так и не дошла очередь, тоже закрываются
+    for (auto &instance : warmPool_) {
+        instance->injector->stop();
+    }
+}
+
+void Launcher::connectInjectorState() noexcept
+{
+    assert(injector_ != nullptr);
+    connect(injector_.get(), &injector::AbstractInjector::started, this, &Launcher::restartTimer);
+    connect(injector_.get(), &injector::AbstractInjector::finished, this,
+            &Launcher::injectorFinished, Qt::QueuedConnection);
+}
+
+void Launcher::connectInjectorOutput(injector::AbstractInjector *injector) noexcept
+{
+    assert(injector != nullptr);
+    if (mode_ != LauncherMode::Console) {
+        connect(injector, &injector::AbstractInjector::stdMessage, this, &Launcher::stdMessage);
+    }
+    else if (options_.userOptions.type == LaunchType::Record
+             || options_.userOptions.showAppLogForTestRun) {
+        connect(injector, &injector::AbstractInjector::stdMessage, printStdMessage);
+    }
+}
+
+void Launcher::connectInprocessRunner() noexcept
+{
+    assert(inprocessRunner_ != nullptr);
+    connect(inprocessRunner_, &inprocess::InprocessRunner::applicationStarted, this,
+            &Launcher::applicationStarted);
+    connect(inprocessRunner_, &inprocess::InprocessRunner::heartbeat, this,
+            &Launcher::handleHeartbeat);
+    connect(inprocessRunner_, &inprocess::InprocessRunner::scriptRunError, this,
+            &Launcher::scriptRunError);
+    connect(inprocessRunner_, &inprocess::InprocessRunner::scriptRunWarning, this,
+            &Launcher::scriptRunWarning);
+    connect(inprocessRunner_, &inprocess::InprocessRunner::scriptRunLog, this,
+            &Launcher::scriptRunLog);
+    connect(inprocessRunner_, &inprocess::InprocessRunner::sessionScriptFinished, this,
+            &Launcher::handleSessionScriptFinished);
+}
+
+QStringList Launcher::launchArgumentsFor(const RunSettings &runSettings) const noexcept
+{
+    auto launchAppArguments = options_.userOptions.launchAppArguments;
+    assert(launchAppArguments.size() > 0);
+    // Пока только в GUI у нас есть возможность задать для каждого скрипта
+    // свои аргументы запуска тестируемого приложения
+    if (mode_ == LauncherMode::Gui) {
+        launchAppArguments.erase(launchAppArguments.begin() + 1, launchAppArguments.end());
+        launchAppArguments.append(
+            runSettings.executeArgs.split(QRegExp("\\s+"), Qt::SkipEmptyParts));
+    }
+    return launchAppArguments;
+}
+
+QString Launcher::launchErrorMessage(const QStringList &launchArguments,
+                                     injector::AbstractInjector *injector) const noexcept
+{
+    assert(injector != nullptr);
+    QString errorMsg = QStringLiteral("Failed to launch target '%1'.")
+                           .arg(launchArguments.join(QStringLiteral(" ")));
+    const auto injectorErrorMsg = injector->errorMessage();
+    if (!injectorErrorMsg.isEmpty()) {
+        errorMsg.append(QStringLiteral("\nError: %1").arg(injectorErrorMsg));
+    }
+    return errorMsg;
 }
 
 void Launcher::timeout() noexcept
@@ -117,6 +182,56 @@ void Launcher::applicationStarted() noexcept
 {
     assert(waitingTimer_.isActive());
     waitingTimer_.stop();
+    startHangDetection();
+}
+
+void Launcher::startHangDetection() noexcept
+{
+    if (options_.userOptions.type == LaunchType::Run
+        && options_.userOptions.missedHeartbeatsLimit > 0) {
+        hangTimer_.start();
+    }
+}
+
+void Launcher::handleHeartbeat() noexcept
+{
+    if (hangTimer_.isActive()) {
+        hangTimer_.start();
+    }
+}
+
+/*
+ * GUI-поток тестируемого приложения пропустил missedHeartbeatsLimit сигналов подряд: скрипт,
+ * который ждет его (BlockingQueuedConnection), уже не завершится сам. Поэтому перед закрытием
+ * приложения сохраняем стеки его потоков, а сам скрипт считается проваленным. Стеки собираются
+ * асинхронно, чтобы не останавливать остальные приложения ParallelLauncher и демона.
+ */
+void Launcher::applicationHung() noexcept
+{
+    assert(injector_ != nullptr);
+    assert(stacksCollector_ == nullptr);
+    hangErrorMessage_
+        = QStringLiteral("Target has missed %1 heartbeats in a row (%2 ms) and was killed. "
+                         "Try setting a bigger number of missed heartbeats (use --help).")
+              .arg(options_.userOptions.missedHeartbeatsLimit)
+              .arg(hangTimer_.interval());
+
+    stacksCollector_ = new ThreadStacksCollector(injector_->processId(), this);
+    connect(stacksCollector_, &ThreadStacksCollector::finished, this,
+            [this](const QString &stacks) {
+                stacksCollector_->deleteLater();
+                stacksCollector_ = nullptr;
+                // Приложение могло завершиться само, пока собирались стеки
+                if (hangErrorMessage_.isEmpty()) {
+                    return;
+                }
+                if (!stacks.isEmpty()) {
+                    hangErrorMessage_.append(QStringLiteral("\nThread stacks:\n%1").arg(stacks));
+                }
+                // Ошибка выводится после завершения приложения (injectorFinished)
+                injector_->stop();
+            });
+    stacksCollector_->start();
 }
 
 void Launcher::restartTimer() noexcept
@@ -128,6 +243,17 @@ void Launcher::restartTimer() noexcept
 void Launcher::injectorFinished() noexcept
 {
     assert(injector_ != nullptr);
+    hangTimer_.stop();
+    if (stacksCollector_ != nullptr) {
+        stacksCollector_->disconnect(this);
+        stacksCollector_->deleteLater();
+        stacksCollector_ = nullptr;
+    }
+    if (!hangErrorMessage_.isEmpty()) {
+        handleLauncherFailure(1, std::exchange(hangErrorMessage_, QString()));
+        return;
+    }
+
     const auto errorMsg = injector_->errorMessage();
     if (!errorMsg.isEmpty()) {
         handleLauncherFailure(injector_->exitCode(), errorMsg);
@@ -168,11 +294,14 @@ bool Launcher::launch() noexcept
 
     options_.env.insert(ENV_LAUNCH_TYPE,
                         QString::number(static_cast<int>(options_.userOptions.type)));
+    options_.env.insert(ENV_REMOTE_OBJECT_URL, remoteObjectUrl_);
+    auto launchAppArguments = options_.userOptions.launchAppArguments;
     switch (options_.userOptions.type) {
     case LaunchType::Record: {
         options_.env.insert(ENV_LAUNCH_SETTINGS, options_.userOptions.recordSettings.toJson());
 
-        inprocessDialog_ = new inprocess::InprocessDialog(options_.userOptions.recordSettings);
+        inprocessDialog_ = new inprocess::InprocessDialog(options_.userOptions.recordSettings,
+                                                          QUrl(remoteObjectUrl_));
         if (options_.userOptions.autoRecord) {
             inprocessDialog_->setEnabled(false);
         }
@@ -183,34 +312,22 @@ bool Launcher::launch() noexcept
         break;
     }
     case LaunchType::Run: {
-        const auto runSettings = options_.userOptions.runSettings.takeFirst();
-        options_.runningScript = runSettings.scriptPath;
-
-        // Пока только в GUI у нас есть возможность задать для каждого скрипта
-        // свои аргументы запуска тестируемого приложения
-        auto &launchAppArguments = options_.userOptions.launchAppArguments;
-        assert(launchAppArguments.size() > 0);
-        if (initFromGui_) {
-            if (launchAppArguments.size() > 1) {
-                launchAppArguments.erase(launchAppArguments.begin() + 1, launchAppArguments.end());
-            }
-            launchAppArguments.append(
-                runSettings.executeArgs.split(QRegExp("\\s+"), Qt::SkipEmptyParts));
+        if (options_.userOptions.warmPoolSize > 0) {
+            return launchFromWarmPool(probeDll);
         }
 
+        auto runSettings = options_.userOptions.runSettings.takeFirst();
+        runSettings.sessionLastScript
+            = runSettings.session && options_.userOptions.runSettings.isEmpty();
+        options_.runningScript = runSettings.scriptPath;
+        launchAppArguments = launchArgumentsFor(runSettings);
+
         emit scriptRunService(QStringLiteral("[ RUN      ] %1").arg(options_.runningScript));
         options_.env.insert(ENV_LAUNCH_SETTINGS, runSettings.toJson());
 
         if (inprocessRunner_ == nullptr) {
-            inprocessRunner_ = new inprocess::InprocessRunner(this);
-            connect(inprocessRunner_, &inprocess::InprocessRunner::applicationStarted, this,
-                    &Launcher::applicationStarted);
-            connect(inprocessRunner_, &inprocess::InprocessRunner::scriptRunError, this,
-                    &Launcher::scriptRunError);
-            connect(inprocessRunner_, &inprocess::InprocessRunner::scriptRunWarning, this,
-                    &Launcher::scriptRunWarning);
-            connect(inprocessRunner_, &inprocess::InprocessRunner::scriptRunLog, this,
-                    &Launcher::scriptRunLog);
+            inprocessRunner_ = new inprocess::InprocessRunner(QUrl(remoteObjectUrl_), this);
+            connectInprocessRunner();
         }
         break;
     }
@@ -219,22 +336,193 @@ bool Launcher::launch() noexcept
         break;
     }
 
-    if (!injector_->launch(options_.userOptions.launchAppArguments, probeDll, options_.env)) {
-        QString errorMsg
-            = QStringLiteral("Failed to launch target '%1'.")
-                  .arg(options_.userOptions.launchAppArguments.join(QStringLiteral(" ")));
-        const auto injectorErrorMsg = injector_->errorMessage();
+    if (!injector_->launch(launchAppArguments, probeDll, options_.env)) {
         const auto injectorErrorCode = injector_->exitCode();
-        if (!injectorErrorMsg.isEmpty()) {
-            errorMsg.append(QStringLiteral("\nError: %1").arg(injectorErrorMsg));
+        handleLauncherFailure(injectorErrorCode ? injectorErrorCode : 1,
+                              launchErrorMessage(launchAppArguments, injector_.get()));
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * Пока выполняется скрипт, следующие warmPoolSize приложений уже запущены и ждут своих
+ * скриптов, поэтому время их запуска не добавляется ко времени прогона. Скрипт передается
+ * приложению только после того, как оно подключилось к лаунчеру (InprocessRunner::
+ * applicationStarted), так как до этого сигнал до него бы не дошел.
+ */
+bool Launcher::launchFromWarmPool(const QString &probeDll) noexcept
+{
+    // Аргументы запуска в GUI задаются для каждого скрипта, поэтому там пул не используется
+    assert(mode_ != LauncherMode::Gui);
+    fillWarmPool(probeDll);
+    assert(!warmPool_.empty());
+    auto instance = std::move(warmPool_.front());
+    warmPool_.pop_front();
+
+    options_.runningScript = options_.userOptions.runSettings.takeFirst().scriptPath;
+    emit scriptRunService(QStringLiteral("[ RUN      ] %1").arg(options_.runningScript));
+
+    // Предыдущее приложение уже завершено, а с ним и его InprocessRunner
+    if (inprocessRunner_ != nullptr) {
+        inprocessRunner_->deleteLater();
+    }
+    inprocessRunner_ = instance->inprocessRunner.release();
+    inprocessRunner_->setParent(this);
+    disconnect(inprocessRunner_, &inprocess::InprocessRunner::applicationStarted, nullptr,
+               nullptr);
+    connectInprocessRunner();
+
+    // Приложение из пула обслуживается так же, как и запущенное обычным образом
+    injector_ = std::move(instance->injector);
+    connectInjectorState();
+
+    if (!injector_->isLaunched()) {
+        // Приложение не запустилось или закрылось, так и не дождавшись своего скрипта
+        auto errorMsg = instance->launchError;
+        if (errorMsg.isEmpty()) {
+            errorMsg = injector_->errorMessage();
+        }
+        if (errorMsg.isEmpty()) {
+            errorMsg = QStringLiteral("The application under test closed before the script "
+                                      "started (exit code: %1).")
+                           .arg(injector_->exitCode());
         }
-        handleLauncherFailure(injectorErrorCode ? injectorErrorCode : 1, errorMsg);
+        const auto injectorErrorCode = injector_->exitCode();
+        handleLauncherFailure(injectorErrorCode > 0 ? injectorErrorCode : 1, errorMsg);
         return false;
     }
 
+    if (instance->isReady) {
+        inprocessRunner_->startSessionScript(options_.runningScript, false);
+        startHangDetection();
+    }
+    else {
+        connect(inprocessRunner_, &inprocess::InprocessRunner::applicationStarted, this,
+                [this] { inprocessRunner_->startSessionScript(options_.runningScript, false); });
+        // Процесс уже мог быть запущен до подключения сигнала started, поэтому время ожидания
+        // отсчитывается с момента, когда приложению передан скрипт
+        restartTimer();
+    }
     return true;
 }
 
+void Launcher::fillWarmPool(const QString &probeDll) noexcept
+{
+    const auto &runSettings = options_.userOptions.runSettings;
+    assert(!runSettings.isEmpty());
+    // Кроме приложения для текущего скрипта, заранее запускается еще warmPoolSize, но не
+    // больше, чем осталось скриптов. Демон же держит их запущенными и для следующих прогонов
+    auto poolSize = static_cast<size_t>(options_.userOptions.warmPoolSize) + 1;
+    if (mode_ != LauncherMode::Daemon) {
+        poolSize = std::min(poolSize, static_cast<size_t>(runSettings.size()));
+    }
+    while (warmPool_.size() < poolSize) {
+        // Скрипт передается приложению только при его активации, а настройки скриптов
+        // одного прогона отличаются только путем к скрипту
+        auto settings = runSettings.constFirst();
+        settings.scriptPath.clear();
+        settings.deferredStart = true;
+
+        auto instance = std::make_unique<WarmInstance>();
+        const auto remoteObjectUrl = uniqueRemoteObjectUrl();
+        instance->injector = std::make_unique<injector::PreloadInjector>();
+        instance->injector->setWorkingDirectory(options_.userOptions.workingDirectory);
+        connectInjectorOutput(instance->injector.get());
+        instance->inprocessRunner
+            = std::make_unique<inprocess::InprocessRunner>(QUrl(remoteObjectUrl));
+        auto *rawInstance = instance.get();
+        connect(instance->inprocessRunner.get(), &inprocess::InprocessRunner::applicationStarted,
+                this, [rawInstance] { rawInstance->isReady = true; });
+
+        auto env = options_.env;
+        env.insert(ENV_LAUNCH_SETTINGS, settings.toJson());
+        env.insert(ENV_REMOTE_OBJECT_URL, remoteObjectUrl);
+        const auto launchAppArguments = launchArgumentsFor(settings);
+        if (!instance->injector->launch(launchAppArguments, probeDll, env)) {
+            // Об ошибке сообщается, когда до приложения дойдет очередь
+            instance->launchError
+                = launchErrorMessage(launchAppArguments, instance->injector.get());
+        }
+        warmPool_.push_back(std::move(instance));
+    }
+}
+
+bool Launcher::runScripts(const QList<RunSettings> &runSettings) noexcept
+{
+    assert(mode_ == LauncherMode::Daemon);
+    assert(options_.userOptions.runSettings.isEmpty());
+    assert(!runSettings.isEmpty());
+
+    scriptsRunData_ = {};
+    options_.state = LauncherState::Initial;
+    options_.exitCode = 0;
+    options_.userOptions.runSettings = runSettings;
+    return launch();
+}
+
+void Launcher::trimWarmPool(size_t size) noexcept
+{
+    assert(mode_ == LauncherMode::Daemon);
+    while (warmPool_.size() > size) {
+        warmPool_.back()->injector->stop();
+        warmPool_.pop_back();
+    }
+}
+
+void Launcher::handleScriptFinished(int exitCode) noexcept
+{
+    const auto testedScript = options_.runningScript;
+    assert(!testedScript.isEmpty());
+    options_.runningScript.clear();
+
+    if (exitCode == 0) {
+        scriptsRunData_.testsPassed++;
+        emit scriptRunService(QStringLiteral("[       OK ] %1").arg(testedScript));
+    }
+    else {
+        scriptsRunData_.testsFailed++;
+        emit scriptRunService(QStringLiteral("[     FAIL ] %1").arg(testedScript));
+    }
+    // Сигнал испускается последним: им заканчиваются все сообщения, относящиеся к скрипту
+    emit scriptFinished(exitCode);
+}
+
+void Launcher::handleSessionScriptFinished(int exitCode) noexcept
+{
+    assert(inprocessRunner_ != nullptr);
+    handleScriptFinished(exitCode);
+
+    auto &runSettings = options_.userOptions.runSettings;
+    if (runSettings.isEmpty()) {
+        // Итоги будут выведены после закрытия приложения
+        inprocessRunner_->finishSession();
+        return;
+    }
+
+    emit nextScriptStarted();
+    options_.runningScript = runSettings.takeFirst().scriptPath;
+    emit scriptRunService(QStringLiteral("[ RUN      ] %1").arg(options_.runningScript));
+    inprocessRunner_->startSessionScript(options_.runningScript, runSettings.isEmpty());
+}
+
+void Launcher::finishRun() noexcept
+{
+    emit scriptRunResult("[==========]");
+    if (scriptsRunData_.testsFailed > 0) {
+        options_.exitCode = 1;
+        emit scriptRunResult(QStringLiteral("[  FAILED  ] Passed: %1 | Failed: %2")
+                                 .arg(scriptsRunData_.testsPassed)
+                                 .arg(scriptsRunData_.testsFailed));
+    }
+    else {
+        emit scriptRunResult(
+            QStringLiteral("[  PASSED  ] %1 tests").arg(scriptsRunData_.testsPassed));
+    }
+    emit launcherFinished();
+}
+
 void Launcher::handleLauncherFailure(int exitCode, const QString &errorMessage) noexcept
 {
     options_.exitCode = exitCode;
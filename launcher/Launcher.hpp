@@ -2,6 +2,7 @@
 
 #include <QObject>
 #include <QTimer>
+#include <deque>
 #include <memory>
 
 #include "LaunchOptions.hpp"
@@ -16,14 +17,33 @@ class InprocessRunner;
 } // namespace QtAda::inprocess
 
 namespace QtAda::launcher {
+class ThreadStacksCollector;
+
+enum class LauncherMode {
+    // Сообщения выводятся в консоль
+    Console = 0,
+    // Сообщения передаются только через сигналы, а аргументы запуска тестируемого приложения
+    // задаются для каждого скрипта отдельно
+    Gui = 1,
+    // Сообщения передаются только через сигналы (один из исполнителей ParallelLauncher)
+    Worker = 2,
+    // Сообщения передаются только через сигналы, а Launcher переиспользуется для следующих
+    // прогонов и держит заранее запущенные приложения и между ними (см. Daemon)
+    Daemon = 3,
+};
+
 class Launcher final : public QObject {
     Q_OBJECT
 public:
-    explicit Launcher(const UserLaunchOptions &options, bool fromGui = false,
+    explicit Launcher(const UserLaunchOptions &options, LauncherMode mode = LauncherMode::Console,
                       QObject *parent = nullptr) noexcept;
     ~Launcher() noexcept override;
 
     bool launch() noexcept;
+    // Запускает следующий прогон в уже использованном Launcher (только LauncherMode::Daemon)
+    bool runScripts(const QList<RunSettings> &runSettings) noexcept;
+    // Закрывает лишние заранее запущенные приложения (только LauncherMode::Daemon)
+    void trimWarmPool(size_t size) noexcept;
     int exitCode() const noexcept
     {
         return options_.exitCode;
@@ -49,7 +69,10 @@ private slots:
     void restartTimer() noexcept;
     void timeout() noexcept;
     void applicationStarted() noexcept;
+    void applicationHung() noexcept;
+    void handleHeartbeat() noexcept;
     void injectorFinished() noexcept;
+    void handleSessionScriptFinished(int exitCode) noexcept;
 
 private:
     struct ScriptsRunData final {
@@ -57,7 +80,9 @@ private:
         int testsFailed = 0;
     } scriptsRunData_;
 
-    const bool initFromGui_;
+    const LauncherMode mode_;
+    // Уникальный адрес QtRO позволяет одновременно запускать несколько тестируемых приложений
+    const QString remoteObjectUrl_;
 
     LaunchOptions options_;
     std::unique_ptr<injector::AbstractInjector> injector_;
@@ -65,9 +90,35 @@ private:
     inprocess::InprocessDialog *inprocessDialog_ = nullptr;
     inprocess::InprocessRunner *inprocessRunner_ = nullptr;
 
-    QTimer waitingTimer_;
+    // Тестируемое приложение, запущенное заранее (--warm-pool), которое ждет своего скрипта
+    struct WarmInstance final {
+        std::unique_ptr<injector::AbstractInjector> injector;
+        std::unique_ptr<inprocess::InprocessRunner> inprocessRunner;
+        QString launchError;
+        // Приложение уже подключилось к лаунчеру и готово выполнить скрипт
+        bool isReady = false;
+    };
+    std::deque<std::unique_ptr<WarmInstance>> warmPool_;
 
+    QTimer waitingTimer_;
+    // Перезапускается каждым сигналом из GUI-потока тестируемого приложения, пока выполняется
+    // скрипт. Если он все-таки сработал, то приложение считается зависшим
+    QTimer hangTimer_;
+    QString hangErrorMessage_;
+    ThreadStacksCollector *stacksCollector_ = nullptr;
+
+    void connectInjectorState() noexcept;
+    void connectInjectorOutput(injector::AbstractInjector *injector) noexcept;
+    void connectInprocessRunner() noexcept;
+    QStringList launchArgumentsFor(const RunSettings &runSettings) const noexcept;
+    QString launchErrorMessage(const QStringList &launchArguments,
+                               injector::AbstractInjector *injector) const noexcept;
+    void startHangDetection() noexcept;
+    bool launchFromWarmPool(const QString &probeDll) noexcept;
+    void fillWarmPool(const QString &probeDll) noexcept;
     void checkIfLauncherIsFinished() noexcept;
+    void handleScriptFinished(int exitCode) noexcept;
+    void finishRun() noexcept;
     void handleLauncherFailure(int exitCode, const QString &errorMessage) noexcept;
     void destroyInprocessDialog() noexcept;
 };
@@ -1,14 +1,19 @@
 #include "LauncherUtils.hpp"
 
+#include "ElfReader.hpp"
+
 #include <QFileInfo>
 #include <QProcess>
 #include <QRegularExpression>
 #include <QStandardPaths>
 
 namespace QtAda::launcher::utils {
-static QVector<QByteArray> internalDependenciesGetter(const QString &elfPath, bool isRetry = false)
+static QVector<QByteArray> internalDependenciesGetter(const QString &elfPath,
+                                                      const QProcessEnvironment &env,
+                                                      bool isRetry = false)
 {
     QProcess ldProc;
+    ldProc.setProcessEnvironment(env);
     ldProc.setProcessChannelMode(QProcess::SeparateChannels);
     ldProc.setReadChannel(QProcess::StandardOutput);
 
@@ -16,7 +21,7 @@ static QVector<QByteArray> internalDependenciesGetter(const QString &elfPath, bo
         // Сначала пробуем использовать ldd
         ldProc.start(QStringLiteral("ldd"), QStringList(elfPath));
         if (!ldProc.waitForStarted()) {
-            return internalDependenciesGetter(elfPath, true);
+            return internalDependenciesGetter(elfPath, env, true);
         }
     }
     else {
@@ -47,9 +52,16 @@ static QVector<QByteArray> internalDependenciesGetter(const QString &elfPath, bo
     return deps;
 }
 
-QVector<QByteArray> getDependenciesForExecutable(const QString &elfPath) noexcept
+QVector<QByteArray> getDependenciesForExecutable(const QString &elfPath,
+                                                 const QProcessEnvironment &env) noexcept
 {
-    return internalDependenciesGetter(elfPath);
+    // ldd запускается, только если исполняемый файл не удалось разобрать самостоятельно
+    const auto dependencies = elf::resolveDependencies(
+        elfPath, env.value(QStringLiteral("LD_LIBRARY_PATH")).toLocal8Bit());
+    if (dependencies.has_value()) {
+        return *dependencies;
+    }
+    return internalDependenciesGetter(elfPath, env);
 }
 
 QString absoluteExecutablePath(const QString &path) noexcept
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QProcessEnvironment>
 #include <QVector>
 
 QT_BEGIN_NAMESPACE
@@ -8,6 +9,9 @@ class QString;
 QT_END_NAMESPACE
 
 namespace QtAda::launcher::utils {
-QVector<QByteArray> getDependenciesForExecutable(const QString &elfPath) noexcept;
+// Зависимости ищутся с LD_LIBRARY_PATH окружения, в котором будет запущено приложение
+QVector<QByteArray> getDependenciesForExecutable(
+    const QString &elfPath,
+    const QProcessEnvironment &env = QProcessEnvironment::systemEnvironment()) noexcept;
 QString absoluteExecutablePath(const QString &path) noexcept;
 } // namespace QtAda::launcher::utils
@@ -0,0 +1,126 @@
+#include "ParallelLauncher.hpp"
+
+#include <algorithm>
+
+#include "Launcher.hpp"
+#include "Common.hpp"
+
+namespace QtAda::launcher {
+ParallelLauncher::ParallelLauncher(const UserLaunchOptions &options, QObject *parent) noexcept
+    : QObject{ parent }
+    , showAppLog_{ options.showAppLogForTestRun }
+    , scriptsCount_{ options.runSettings.size() }
+{
+    assert(options.type == LaunchType::Run);
+    assert(options.jobs > 1);
+    assert(!options.runSettings.isEmpty());
+
+    // Скрипты распределяются по очереди, поэтому соседние в списке скрипты (обычно похожие
+    // по длительности) выполняются разными исполнителями
+    const auto workersCount = std::min(options.jobs, scriptsCount_);
+    std::vector<UserLaunchOptions> shards(workersCount, options);
+    for (auto &shard : shards) {
+        shard.jobs = 1;
+        shard.runSettings.clear();
+    }
+    for (int i = 0; i < scriptsCount_; i++) {
+        shards[i % workersCount].runSettings.push_back(options.runSettings[i]);
+    }
+
+    // Размер workers_ больше не меняется, поэтому ссылки на исполнителей остаются валидными
+    workers_.resize(workersCount);
+    for (int i = 0; i < workersCount; i++) {
+        auto &worker = workers_[i];
+        worker.launcher = new Launcher(shards[i], LauncherMode::Worker, this);
+
+        const auto buffered = [&worker](Printer printer) {
+            return [&worker, printer](const QString &msg) {
+                worker.pendingMessages.emplace_back(printer, msg);
+            };
+        };
+        auto *launcher = worker.launcher;
+        if (showAppLog_) {
+            connect(launcher, &Launcher::stdMessage, this, buffered(printStdMessage));
+            connect(launcher, &Launcher::scriptRunError, this, buffered(printQtAdaErrorMessage));
+            connect(launcher, &Launcher::scriptRunWarning, this,
+                    buffered(printQtAdaWarningMessage));
+            connect(launcher, &Launcher::scriptRunLog, this, buffered(printQtAdaServiceMessage));
+            connect(launcher, &Launcher::scriptRunService, this,
+                    buffered(printQtAdaServiceMessage));
+        }
+        else {
+            connect(launcher, &Launcher::scriptRunError, this, buffered(printScriptErrorMessage));
+            connect(launcher, &Launcher::scriptRunWarning, this,
+                    buffered(printScriptWarningMessage));
+            connect(launcher, &Launcher::scriptRunLog, this, buffered(printScriptOutMessage));
+            connect(launcher, &Launcher::scriptRunService, this, buffered(printScriptOutMessage));
+        }
+        connect(launcher, &Launcher::launcherErrMessage, this, buffered(printQtAdaErrorMessage));
+        connect(launcher, &Launcher::launcherOutMessage, this, buffered(printQtAdaOutMessage));
+
+        connect(launcher, &Launcher::scriptFinished, this, [this, &worker](int exitCode) {
+            if (exitCode == 0) {
+                testsPassed_++;
+            }
+            else {
+                testsFailed_++;
+            }
+            flushMessages(worker);
+        });
+        connect(launcher, &Launcher::launcherFinished, this,
+                [this, &worker] { handleWorkerFinished(worker); });
+    }
+}
+
+bool ParallelLauncher::launch() noexcept
+{
+    printQtAdaOutMessage(QStringLiteral("Running %1 scripts in %2 application instances.")
+                             .arg(scriptsCount_)
+                             .arg(workers_.size()));
+
+    bool isLaunched = false;
+    for (auto &worker : workers_) {
+        if (worker.launcher->launch()) {
+            isLaunched = true;
+        }
+    }
+    return isLaunched;
+}
+
+void ParallelLauncher::flushMessages(Worker &worker) noexcept
+{
+    for (const auto &[printer, msg] : worker.pendingMessages) {
+        printer(msg);
+    }
+    worker.pendingMessages.clear();
+}
+
+void ParallelLauncher::handleWorkerFinished(Worker &worker) noexcept
+{
+    assert(!worker.isFinished);
+    worker.isFinished = true;
+    flushMessages(worker);
+    if (worker.launcher->exitCode() != 0) {
+        exitCode_ = 1;
+    }
+
+    const auto allFinished = std::all_of(workers_.begin(), workers_.end(),
+                                         [](const auto &other) { return other.isFinished; });
+    if (!allFinished) {
+        return;
+    }
+
+    const Printer printResult = showAppLog_ ? printQtAdaServiceMessage : printScriptOutMessage;
+    printResult("[==========]");
+    if (testsFailed_ > 0) {
+        exitCode_ = 1;
+        printResult(QStringLiteral("[  FAILED  ] Passed: %1 | Failed: %2")
+                        .arg(testsPassed_)
+                        .arg(testsFailed_));
+    }
+    else {
+        printResult(QStringLiteral("[  PASSED  ] %1 tests").arg(testsPassed_));
+    }
+    emit launcherFinished();
+}
+} // namespace QtAda::launcher
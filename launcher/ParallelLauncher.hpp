@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QObject>
+#include <vector>
+
+#include "LaunchOptions.hpp"
+
+namespace QtAda::launcher {
+class Launcher;
+
+/*
+ * Распределяет скрипты между несколькими одновременно запущенными экземплярами тестируемого
+ * приложения (по одному Launcher на экземпляр). Чтобы сообщения разных скриптов не
+ * перемешивались, сообщения каждого скрипта выводятся одним блоком после его завершения,
+ * а итоги всех исполнителей объединяются в один.
+ */
+class ParallelLauncher final : public QObject {
+    Q_OBJECT
+public:
+    explicit ParallelLauncher(const UserLaunchOptions &options, QObject *parent = nullptr) noexcept;
+
+    bool launch() noexcept;
+    int exitCode() const noexcept
+    {
+        return exitCode_;
+    }
+
+signals:
+    void launcherFinished();
+
+private:
+    using Printer = void (*)(const QString &msg);
+
+    struct Worker final {
+        Launcher *launcher = nullptr;
+        std::vector<std::pair<Printer, QString>> pendingMessages;
+        bool isFinished = false;
+    };
+    std::vector<Worker> workers_;
+
+    const bool showAppLog_;
+    int scriptsCount_ = 0;
+    int testsPassed_ = 0;
+    int testsFailed_ = 0;
+    int exitCode_ = 0;
+
+    void flushMessages(Worker &worker) noexcept;
+    void handleWorkerFinished(Worker &worker) noexcept;
+};
+} // namespace QtAda::launcher
@@ -9,6 +9,19 @@ public:
     void setQtVersion(std::pair<int, int> version) noexcept;
     void setArchitecture(const QString architecture) noexcept;
 
+    int majorQtVersion() const noexcept
+    {
+        return info_.majorVersion;
+    }
+    int minorQtVersion() const noexcept
+    {
+        return info_.minorQtVersion;
+    }
+    QString architecture() const noexcept
+    {
+        return info_.architecture;
+    }
+
     bool hasQtVersion() const noexcept;
     bool hasArchitecture() const noexcept;
     bool isValid() const noexcept;
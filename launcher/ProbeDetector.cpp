@@ -1,12 +1,13 @@
 #include "ProbeDetector.hpp"
 
+#include "ElfReader.hpp"
+#include "ExecutableInfo.hpp"
 #include "LauncherLog.hpp"
-#include "LauncherUtils.hpp"
 #include <config.h>
 
 #include <QDebug>
+#include <QFile>
 #include <QFileInfo>
-#include <QProcess>
 #include <QRegularExpression>
 #include <optional>
 
@@ -27,17 +28,6 @@ static bool libIsQtCore(const QByteArray &line)
     return match.hasMatch();
 }
 
-static QString getQtCoreLibFromLdd(const QString &elfPath)
-{
-    const auto depLibs = QtAda::launcher::utils::getDependenciesForExecutable(elfPath);
-    for (const auto &lib : depLibs) {
-        if (libIsQtCore(lib)) {
-            return QString::fromUtf8(lib);
-        }
-    }
-    return QString();
-}
-
 static std::optional<std::pair<int, int>> qtVersionFromLibName(const QString &libPath)
 {
     QRegularExpression regex("^(.*)\\.so\\.(\\d+)\\.(\\d+)(?:\\.(\\d+))?$");
@@ -52,56 +42,6 @@ static std::optional<std::pair<int, int>> qtVersionFromLibName(const QString &li
     return std::make_pair(major, minor);
 }
 
-static std::optional<std::pair<int, int>> qtVersionFromLibExec(const QString &libPath)
-{
-    /*!
-     * TODO: По идее библиотеку .so можно запустить как обычный исполняемый файл,
-     * но почему-то на моих машинах выдает ошибку `segmentation fault (core dumped)`
-     *
-     *  Код для запуска библиотеки как исполняемый файл:
-     *
-        QProcess proc;
-        proc.setProcessChannelMode(QProcess::SeparateChannels);
-        proc.setReadChannel(QProcess::StandardOutput);
-        proc.start(libPath, {}, QProcess::ReadOnly);
-        proc.waitForFinished();
-
-        const QByteArray line = proc.readLine();
-        const int pos = line.indexOf("Qt ");
-        const QList<QByteArray> version = line.mid(pos + 2).split('.');
-        if (version.size() < 3)
-            return std::nullopt;
-
-        return std::make_pair(version.at(0).toInt(), version.at(1).toInt());
-    */
-
-    // Если ldd не доступен, то на текущий момент надеемся, что доступна
-    //  команда strings, возвращающая текстовые строки из исполняемого файла
-    QProcess proc;
-    proc.setProcessChannelMode(QProcess::SeparateChannels);
-    proc.setReadChannel(QProcess::StandardOutput);
-    proc.start(QStringLiteral("strings"),
-               QStringList() << libPath << QStringLiteral("| grep -E \"Qt [0-9]+\\.[0-9]+\""),
-               QProcess::ReadOnly);
-    proc.waitForFinished();
-
-    while (proc.canReadLine()) {
-        const auto line = proc.readLine();
-        if (line.isEmpty()) {
-            break;
-        }
-
-        QRegularExpression regex("^Qt (\\d+)\\.(\\d+)");
-        QRegularExpressionMatch match = regex.match(line);
-        if (match.hasMatch()) {
-            const auto major = match.captured(1).toInt();
-            const auto minor = match.captured(2).toInt();
-            return std::make_pair(major, minor);
-        }
-    }
-    return std::nullopt;
-}
-
 #ifdef HAVE_ELF
 template <typename ElfHeader>
 static QString getArchitectureFromElfHeader(const uchar *elfData, quint64 size)
@@ -158,19 +98,24 @@ static QString getArchitectureFromElf(const QString &elfPath)
     return QString();
 }
 
-ProbeABI detectProbeAbiForExecutable(const QString &elfPath) noexcept
+QString findQtCoreLibrary(const QVector<QByteArray> &dependencies) noexcept
 {
-    ProbeABI probe;
-    if (elfPath.isEmpty()) {
-        return probe;
+    for (const auto &lib : dependencies) {
+        if (libIsQtCore(lib)) {
+            return QString::fromUtf8(lib);
+        }
     }
+    return QString();
+}
 
-    const auto corePath = getQtCoreLibFromLdd(elfPath);
-    if (corePath.isEmpty()) {
+ProbeABI detectProbeAbi(const QString &elfPath, const QString &qtCorePath) noexcept
+{
+    ProbeABI probe;
+    if (elfPath.isEmpty() || qtCorePath.isEmpty()) {
         return probe;
     }
 
-    const QFileInfo coreFileInfo(corePath);
+    const QFileInfo coreFileInfo(qtCorePath);
     if (!coreFileInfo.exists()) {
         return probe;
     }
@@ -178,7 +123,7 @@ ProbeABI detectProbeAbiForExecutable(const QString &elfPath) noexcept
     const auto canonicalCorePath = coreFileInfo.canonicalFilePath();
     auto qtVersion = qtVersionFromLibName(canonicalCorePath);
     if (!qtVersion.has_value()) {
-        qtVersion = qtVersionFromLibExec(canonicalCorePath);
+        qtVersion = elf::qtVersionFromLibrary(canonicalCorePath);
     }
 
     if (!qtVersion.has_value()) {
@@ -190,4 +135,13 @@ ProbeABI detectProbeAbiForExecutable(const QString &elfPath) noexcept
     probe.setArchitecture(getArchitectureFromElf(elfPath));
     return probe;
 }
+
+ProbeABI detectProbeAbiForExecutable(const QString &elfPath,
+                                     const QProcessEnvironment &env) noexcept
+{
+    if (elfPath.isEmpty()) {
+        return ProbeABI();
+    }
+    return executableInfo(elfPath, env).probe;
+}
 } // namespace QtAda::launcher::probe
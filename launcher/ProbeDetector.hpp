@@ -1,11 +1,21 @@
 #pragma once
 
+#include <QProcessEnvironment>
+#include <QVector>
+
 #include "ProbeABI.hpp"
 
 QT_BEGIN_NAMESPACE
+class QByteArray;
 class QString;
 QT_END_NAMESPACE
 
 namespace QtAda::launcher::probe {
-ProbeABI detectProbeAbiForExecutable(const QString &elfPath) noexcept;
-}
+QString findQtCoreLibrary(const QVector<QByteArray> &dependencies) noexcept;
+// Определяет ABI зонда без кэша, по уже найденной библиотеке QtCore
+ProbeABI detectProbeAbi(const QString &elfPath, const QString &qtCorePath) noexcept;
+// Результат кэшируется (см. executableInfo)
+ProbeABI detectProbeAbiForExecutable(
+    const QString &elfPath,
+    const QProcessEnvironment &env = QProcessEnvironment::systemEnvironment()) noexcept;
+} // namespace QtAda::launcher::probe
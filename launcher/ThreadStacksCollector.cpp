@@ -0,0 +1,113 @@
+#include "ThreadStacksCollector.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+namespace QtAda::launcher {
+static constexpr int STACK_TOOL_TIMEOUT_MSEC = 10000;
+
+static QString readProcFile(const QString &path) noexcept
+{
+    QFile procFile(path);
+    if (!procFile.open(QFile::ReadOnly)) {
+        return QString();
+    }
+    return QString::fromLocal8Bit(procFile.readAll()).trimmed();
+}
+
+ThreadStacksCollector::ThreadStacksCollector(qint64 pid, QObject *parent) noexcept
+    : QObject{ parent }
+    , pid_{ pid }
+{
+    const auto pidArg = QString::number(pid_);
+    // eu-stack работает заметно быстрее gdb, поэтому пробуем его первым
+    tools_.push_back({ QStringLiteral("eu-stack"), { QStringLiteral("-p"), pidArg } });
+    tools_.push_back({ QStringLiteral("gdb"),
+                       { QStringLiteral("-p"), pidArg, QStringLiteral("-batch"),
+                         QStringLiteral("-nx"), QStringLiteral("-ex"),
+                         QStringLiteral("thread apply all bt") } });
+
+    toolProcess_.setProcessChannelMode(QProcess::MergedChannels);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    connect(&toolProcess_, &QProcess::finished, this, &ThreadStacksCollector::handleToolFinished);
+#else
+    connect(&toolProcess_,
+            static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this,
+            &ThreadStacksCollector::handleToolFinished);
+#endif
+    connect(&toolProcess_, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            startNextTool();
+        }
+    });
+
+    toolTimer_.setSingleShot(true);
+    toolTimer_.setInterval(STACK_TOOL_TIMEOUT_MSEC);
+    connect(&toolTimer_, &QTimer::timeout, this, &ThreadStacksCollector::handleToolTimeout);
+}
+
+void ThreadStacksCollector::start() noexcept
+{
+    if (pid_ <= 0) {
+        emit finished(QString());
+        return;
+    }
+    startNextTool();
+}
+
+void ThreadStacksCollector::startNextTool() noexcept
+{
+    toolTimer_.stop();
+    while (!tools_.isEmpty()) {
+        const auto tool = tools_.takeFirst();
+        const auto programPath = QStandardPaths::findExecutable(tool.program);
+        if (programPath.isEmpty()) {
+            continue;
+        }
+        toolTimer_.start();
+        toolProcess_.start(programPath, tool.args, QProcess::ReadOnly);
+        return;
+    }
+    emit finished(procThreadStates());
+}
+
+void ThreadStacksCollector::handleToolFinished() noexcept
+{
+    toolTimer_.stop();
+    const auto stacks = QString::fromLocal8Bit(toolProcess_.readAll()).trimmed();
+    if (toolProcess_.exitStatus() == QProcess::NormalExit && toolProcess_.exitCode() == 0
+        && !stacks.isEmpty()) {
+        tools_.clear();
+        emit finished(stacks);
+        return;
+    }
+    startNextTool();
+}
+
+void ThreadStacksCollector::handleToolTimeout() noexcept
+{
+    // Завершение процесса приведет к handleToolFinished с ненулевым кодом возврата
+    toolProcess_.kill();
+}
+
+QString ThreadStacksCollector::procThreadStates() const noexcept
+{
+    // Без отладчика остаются только состояние потоков и стеки ядра (последние обычно
+    // доступны только root)
+    QString stacks;
+    const QDir taskDir(QStringLiteral("/proc/%1/task").arg(pid_));
+    for (const auto &tid : taskDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        const auto threadPath = taskDir.filePath(tid);
+        stacks.append(QStringLiteral("Thread %1 (%2), wchan: %3\n")
+                          .arg(tid)
+                          .arg(readProcFile(threadPath + QStringLiteral("/comm")))
+                          .arg(readProcFile(threadPath + QStringLiteral("/wchan"))));
+        const auto kernelStack = readProcFile(threadPath + QStringLiteral("/stack"));
+        if (!kernelStack.isEmpty()) {
+            stacks.append(kernelStack).append('\n');
+        }
+    }
+    return stacks.trimmed();
+}
+} // namespace QtAda::launcher
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+#include <QTimer>
+
+namespace QtAda::launcher {
+/*
+ * Асинхронно собирает стеки всех потоков процесса: сначала через eu-stack, затем через gdb.
+ * Если ни один из них не справился, то используются состояние потоков и стеки ядра из
+ * /proc/<pid>/task. Цикл событий лаунчера при этом не блокируется, что важно для -j и демона.
+ */
+class ThreadStacksCollector final : public QObject {
+    Q_OBJECT
+public:
+    explicit ThreadStacksCollector(qint64 pid, QObject *parent = nullptr) noexcept;
+
+    void start() noexcept;
+
+signals:
+    void finished(const QString &stacks);
+
+private slots:
+    void handleToolFinished() noexcept;
+    void handleToolTimeout() noexcept;
+
+private:
+    struct StackTool final {
+        QString program;
+        QStringList args;
+    };
+
+    const qint64 pid_;
+    QList<StackTool> tools_;
+    QProcess toolProcess_;
+    QTimer toolTimer_;
+
+    void startNextTool() noexcept;
+    QString procThreadStates() const noexcept;
+};
+} // namespace QtAda::launcher
@@ -24,6 +24,7 @@ public:
     virtual QProcess::ProcessError processError() = 0;
     virtual QString errorMessage() = 0;
     virtual bool isLaunched() = 0;
+    virtual qint64 processId() = 0;
 
     void setWorkingDirectory(const QString &dirPath) noexcept;
     QString workingDirectory() const noexcept;
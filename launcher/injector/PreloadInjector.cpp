@@ -1,5 +1,6 @@
 #include "PreloadInjector.hpp"
 
+#include "ExecutableInfo.hpp"
 #include "LauncherUtils.hpp"
 #include "Common.hpp"
 
@@ -10,16 +11,9 @@ bool PreloadInjector::launch(const QStringList &launchArgs, const QString &probe
     assert(!launchArgs.isEmpty());
     assert(!probeDllPath.isEmpty());
 
-    QStringList preloadLibs;
-    const auto exePath = launchArgs.constFirst();
-
-    // AddressSanitizer необходимо загрузить перед всеми остальными библиотеками
-    for (const auto &lib : utils::getDependenciesForExecutable(exePath)) {
-        if (lib.contains("libasan.so") || lib.contains("libclang_rt.asan")) {
-            preloadLibs.push_back(QString::fromLocal8Bit(lib));
-            break;
-        }
-    }
+    // Библиотеки берутся из кэша, поэтому зависимости не разбираются при каждом запуске
+    const auto exePath = utils::absoluteExecutablePath(launchArgs.constFirst());
+    auto preloadLibs = executableInfo(exePath, env).preloadLibs;
     preloadLibs.push_back(probeDllPath);
 
     QProcessEnvironment _env(env);
@@ -30,6 +30,10 @@ public:
     {
         return process_.state() != QProcess::NotRunning;
     }
+    qint64 processId() noexcept override
+    {
+        return process_.processId();
+    }
 
 protected:
     bool injectAndLaunch(const QStringList &launchArgs, const QProcessEnvironment &env);
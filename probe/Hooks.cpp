@@ -22,7 +22,7 @@ extern "C" Q_DECL_EXPORT void startupHook()
 
 extern "C" Q_DECL_EXPORT void objectAddedHook(QObject *obj)
 {
-    QtAda::core::Probe::addObject(obj);
+    QtAda::core::Probe::addObjectFromHook(obj);
     if (next_objectAddedHook != nullptr) {
         next_objectAddedHook(obj);
     }
@@ -30,7 +30,7 @@ extern "C" Q_DECL_EXPORT void objectAddedHook(QObject *obj)
 
 extern "C" Q_DECL_EXPORT void objectRemovedHook(QObject *obj)
 {
-    QtAda::core::Probe::removeObject(obj);
+    QtAda::core::Probe::removeObjectFromHook(obj);
     if (next_objectRemovedHook != nullptr) {
         next_objectRemovedHook(obj);
     }
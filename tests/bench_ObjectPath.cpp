@@ -0,0 +1,94 @@
+#include <QtTest>
+#include <QObject>
+#include <QQmlEngine>
+#include <QQmlComponent>
+#include <QTemporaryDir>
+#include <QFile>
+#include <memory>
+
+#include "utils/FilterUtils.hpp"
+
+using namespace QtAda::core;
+
+static constexpr int NESTING_DEPTH = 8;
+static constexpr int NESTED_INSTANCES_COUNT = 3;
+
+/*
+ * Пути объектов QML-сцены с глубокой вложенностью компонентов: каждый уровень - отдельный
+ * QML-тип (LevelN.qml), содержащий несколько экземпляров следующего уровня, поэтому имена
+ * классов объектов получают QML-суффиксы, а у объектов много соседей того же класса.
+ */
+class ObjectPathBenchmark final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void objectPaths();
+
+private:
+    QTemporaryDir componentsDir_;
+    std::unique_ptr<QQmlEngine> engine_;
+    std::unique_ptr<QObject> root_;
+    QList<QObject *> objects_;
+
+    bool writeComponent(int level) const noexcept;
+};
+
+bool ObjectPathBenchmark::writeComponent(int level) const noexcept
+{
+    QString content = QStringLiteral("import QtQuick 2.15\n\nItem {\n");
+    if (level + 1 < NESTING_DEPTH) {
+        for (int i = 0; i < NESTED_INSTANCES_COUNT; ++i) {
+            content += QStringLiteral("    Level%1 {}\n").arg(level + 1);
+        }
+    }
+    content += QStringLiteral("    Item {}\n"
+                              "    Rectangle { objectName: \"background\" }\n"
+                              "    Text { text: \"level %1\" }\n"
+                              "}\n")
+                   .arg(level);
+
+    QFile file(componentsDir_.filePath(QStringLiteral("Level%1.qml").arg(level)));
+    return file.open(QIODevice::WriteOnly | QIODevice::Text)
+           && file.write(content.toUtf8()) == content.toUtf8().size();
+}
+
+void ObjectPathBenchmark::initTestCase()
+{
+    QVERIFY(componentsDir_.isValid());
+    for (int level = 0; level < NESTING_DEPTH; ++level) {
+        QVERIFY(writeComponent(level));
+    }
+
+    engine_ = std::make_unique<QQmlEngine>();
+    QQmlComponent component(engine_.get(),
+                            QUrl::fromLocalFile(componentsDir_.filePath("Level0.qml")));
+    root_.reset(component.create());
+    QVERIFY2(root_ != nullptr, qPrintable(component.errorString()));
+
+    objects_ = root_->findChildren<QObject *>();
+    objects_.prepend(root_.get());
+    qInfo("%d objects in the scene", objects_.size());
+}
+
+void ObjectPathBenchmark::cleanupTestCase()
+{
+    objects_.clear();
+    root_.reset();
+    engine_.reset();
+}
+
+void ObjectPathBenchmark::objectPaths()
+{
+    const auto &objects = objects_;
+    QBENCHMARK {
+        for (const auto *obj : objects) {
+            const auto path = utils::objectPath(obj);
+            Q_UNUSED(path);
+        }
+    }
+}
+
+QTEST_MAIN(ObjectPathBenchmark)
+#include "bench_ObjectPath.moc"
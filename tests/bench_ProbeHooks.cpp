@@ -0,0 +1,121 @@
+#include <QtTest>
+#include <QObject>
+#include <memory>
+#include <vector>
+
+#include "Probe.hpp"
+#include "Common.hpp"
+
+using namespace QtAda;
+using namespace QtAda::core;
+
+static constexpr int LIVE_GROUP_COUNT = 200;
+static constexpr int LIVE_GROUP_SIZE = 1000;
+static constexpr int CHURN_OBJECT_COUNT = 1000;
+
+/*
+ * Хуки создания и удаления объектов до инициализации Probe, то есть во время запуска
+ * приложения: объекты попадают в список ожидающих инициализации и удаляются из него в
+ * порядке создания. Хуки вызываются напрямую, поэтому измеряется только их учет объектов.
+ *
+ * После инициализации (Probe инициализируется один раз, поэтому этот случай идет последним)
+ * измеряется создание и удаление объектов в приложении, где уже живут 200k объектов: хуки,
+ * обработка очереди создания и регистрация путей в ScriptRunner. Лаунчера нет, поэтому
+ * приложение запускается как из --warm-pool и скрипт не начинает выполняться.
+ */
+class ProbeHooksBenchmark final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void startupHooks_data();
+    void startupHooks();
+    void hooksWithLiveObjects();
+
+private:
+    static void handleObjectsQueue() noexcept
+    {
+        QVERIFY(QMetaObject::invokeMethod(Probe::probeInstance(), "handleObjectsQueue",
+                                          Qt::DirectConnection));
+    }
+};
+
+void ProbeHooksBenchmark::startupHooks_data()
+{
+    QTest::addColumn<int>("objectCount");
+    QTest::newRow("1k objects") << 1000;
+    QTest::newRow("10k objects") << 10000;
+    QTest::newRow("50k objects") << 50000;
+}
+
+void ProbeHooksBenchmark::startupHooks()
+{
+    QFETCH(int, objectCount);
+    QVERIFY(!Probe::initialized());
+
+    std::vector<std::unique_ptr<QObject>> objects;
+    objects.reserve(static_cast<size_t>(objectCount));
+    for (int i = 0; i < objectCount; ++i) {
+        objects.push_back(std::make_unique<QObject>());
+    }
+
+    QBENCHMARK {
+        for (const auto &obj : objects) {
+            Probe::addObject(obj.get());
+        }
+        for (const auto &obj : objects) {
+            Probe::removeObject(obj.get());
+        }
+    }
+}
+
+void ProbeHooksBenchmark::hooksWithLiveObjects()
+{
+    QVERIFY(!Probe::initialized());
+
+    // Живые объекты сгруппированы по родителям, как потомки окон и виджетов
+    auto root = std::make_unique<QObject>();
+    std::vector<QObject *> liveObjects = { root.get() };
+    liveObjects.reserve(LIVE_GROUP_COUNT * (LIVE_GROUP_SIZE + 1) + 1);
+    for (int i = 0; i < LIVE_GROUP_COUNT; ++i) {
+        auto *group = new QObject(root.get());
+        liveObjects.push_back(group);
+        for (int j = 0; j < LIVE_GROUP_SIZE; ++j) {
+            liveObjects.push_back(new QObject(group));
+        }
+    }
+    auto *churnParent = liveObjects[1];
+    std::vector<QObject *> churnObjects;
+    churnObjects.reserve(CHURN_OBJECT_COUNT);
+    for (int i = 0; i < CHURN_OBJECT_COUNT; ++i) {
+        churnObjects.push_back(new QObject(churnParent));
+    }
+
+    for (auto *obj : liveObjects) {
+        Probe::addObject(obj);
+    }
+    qputenv(ENV_REMOTE_OBJECT_URL, "local:qtada-bench-probe-hooks");
+    RunSettings runSettings;
+    runSettings.deferredStart = true;
+    Probe::initProbe(LaunchType::Run, std::nullopt, runSettings);
+    QVERIFY(Probe::initialized());
+    handleObjectsQueue();
+    QVERIFY(Probe::probeInstance()->isKnownObject(liveObjects.back()));
+
+    QBENCHMARK {
+        for (auto *obj : churnObjects) {
+            Probe::addObjectFromHook(obj);
+        }
+        handleObjectsQueue();
+        for (auto *obj : churnObjects) {
+            Probe::removeObjectFromHook(obj);
+        }
+    }
+
+    // Хуки удаления не установлены, поэтому объекты убираются из Probe до их удаления
+    for (auto it = liveObjects.rbegin(); it != liveObjects.rend(); ++it) {
+        Probe::removeObjectFromHook(*it);
+    }
+}
+
+QTEST_GUILESS_MAIN(ProbeHooksBenchmark)
+#include "bench_ProbeHooks.moc"
@@ -0,0 +1,99 @@
+#include <QtTest>
+#include <QObject>
+#include <QQmlProperty>
+#include <QQuickItem>
+#include <QMetaProperty>
+
+#include "utils/Tools.hpp"
+
+using namespace QtAda::core;
+
+static constexpr int ACCESS_ITERATIONS = 10000;
+
+/*
+ * Доступ к свойствам объекта при выполнении скрипта: проверка доступности объекта перед
+ * действием (enabled, visible и размеры) и сравнение значения свойства в verify. Строка
+ * "QQmlProperty" повторяет прежнюю реализацию (чтение через QQmlProperty::read и сравнение
+ * строк), строка "cached" - текущую (закешированные индексы свойств и сравнение значений).
+ */
+class PropertyAccessBenchmark final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void readProperties_data();
+    void readProperties();
+    void compareValue_data();
+    void compareValue();
+
+private:
+    void addRows() const noexcept;
+};
+
+void PropertyAccessBenchmark::addRows() const noexcept
+{
+    QTest::addColumn<bool>("isCached");
+    QTest::newRow("QQmlProperty") << false;
+    QTest::newRow("cached") << true;
+}
+
+void PropertyAccessBenchmark::readProperties_data()
+{
+    addRows();
+}
+
+void PropertyAccessBenchmark::readProperties()
+{
+    QFETCH(bool, isCached);
+    QQuickItem item;
+    item.setSize(QSizeF(120.0, 40.0));
+
+    const auto read = [isCached, &item](const char *name) {
+        return isCached ? tools::readProperty(&item, name) : QQmlProperty::read(&item, name);
+    };
+    double area = 0.0;
+    QBENCHMARK {
+        for (int i = 0; i < ACCESS_ITERATIONS; ++i) {
+            if (read("enabled").toBool() && read("visible").toBool()) {
+                area += read("width").toDouble() * read("height").toDouble();
+            }
+        }
+    }
+    QVERIFY(area > 0.0);
+}
+
+void PropertyAccessBenchmark::compareValue_data()
+{
+    addRows();
+}
+
+void PropertyAccessBenchmark::compareValue()
+{
+    QFETCH(bool, isCached);
+    QQuickItem item;
+    item.setWidth(120.0);
+    const auto expected = QStringLiteral("120");
+
+    // Как и в verify, свойство и ожидаемое значение определяются один раз, а сравнение
+    // выполняется на каждой попытке
+    const auto *metaObject = item.metaObject();
+    const auto index = isCached ? tools::propertyIndex(metaObject, "width")
+                                : metaObject->indexOfProperty("width");
+    QVERIFY(index != -1);
+    const auto metaProperty = metaObject->property(index);
+    const auto expectedValue = tools::typedExpectedValue(metaProperty, expected);
+    QVERIFY(expectedValue.has_value());
+
+    int matches = 0;
+    QBENCHMARK {
+        for (int i = 0; i < ACCESS_ITERATIONS; ++i) {
+            const bool isEqual
+                = isCached ? tools::propertyValueEquals(&item, metaProperty, *expectedValue)
+                           : tools::metaPropertyValueToString(&item, metaProperty) == expected;
+            matches += isEqual ? 1 : 0;
+        }
+    }
+    QVERIFY(matches > 0);
+}
+
+QTEST_MAIN(PropertyAccessBenchmark)
+#include "bench_PropertyAccess.moc"
@@ -0,0 +1,85 @@
+#include <QtTest>
+#include <QObject>
+#include <QMetaProperty>
+#include <QWidget>
+#include <QPushButton>
+#include <QLabel>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QSlider>
+#include <memory>
+
+#include "utils/Tools.hpp"
+
+using namespace QtAda::core;
+
+static constexpr int WIDGETS_COUNT = 10000;
+
+/*
+ * Преобразование в строку всех свойств виджетов, как при выводе таблицы свойств объекта,
+ * выбранного для проверки. Метаданные перечисления ищутся для каждого значения, а среди
+ * свойств виджетов есть и перечисления, и флаги (focusPolicy, layoutDirection, alignment).
+ */
+class PropertyToStringBenchmark final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void allProperties();
+
+private:
+    std::unique_ptr<QWidget> root_;
+    QList<QWidget *> widgets_;
+};
+
+void PropertyToStringBenchmark::initTestCase()
+{
+    root_ = std::make_unique<QWidget>();
+    for (int i = 0; i < WIDGETS_COUNT; ++i) {
+        switch (i % 5) {
+        case 0:
+            widgets_.push_back(new QPushButton(QStringLiteral("Button %1").arg(i), root_.get()));
+            break;
+        case 1:
+            widgets_.push_back(new QLabel(QStringLiteral("Label %1").arg(i), root_.get()));
+            break;
+        case 2:
+            widgets_.push_back(new QLineEdit(QStringLiteral("Text %1").arg(i), root_.get()));
+            break;
+        case 3:
+            widgets_.push_back(new QCheckBox(QStringLiteral("Check %1").arg(i), root_.get()));
+            break;
+        case 4:
+            widgets_.push_back(new QSlider(Qt::Horizontal, root_.get()));
+            break;
+        default:
+            Q_UNREACHABLE();
+        }
+    }
+}
+
+void PropertyToStringBenchmark::cleanupTestCase()
+{
+    widgets_.clear();
+    root_.reset();
+}
+
+void PropertyToStringBenchmark::allProperties()
+{
+    const auto &widgets = widgets_;
+    qsizetype totalLength = 0;
+    QBENCHMARK {
+        for (const auto *widget : widgets) {
+            const auto *metaObject = widget->metaObject();
+            for (int i = 0; i < metaObject->propertyCount(); ++i) {
+                totalLength
+                    += tools::metaPropertyValueToString(widget, metaObject->property(i)).size();
+            }
+        }
+    }
+    QVERIFY(totalLength > 0);
+}
+
+QTEST_MAIN(PropertyToStringBenchmark)
+#include "bench_PropertyToString.moc"
@@ -0,0 +1,92 @@
+#include <QtTest>
+#include <QObject>
+#include <QRemoteObjectNode>
+#include <memory>
+
+#include <launcher/rep_DaemonController_replica.h>
+
+#include "Daemon.hpp"
+#include "DaemonClient.hpp"
+
+using namespace QtAda;
+using namespace QtAda::launcher;
+
+static constexpr int CONNECT_TIMEOUT_MSEC = 5000;
+static constexpr char JOB_ID[] = "tst_Daemon";
+
+/*
+ * Клиент подключается к демону так же, как DaemonClient: по local: к сокету, который
+ * слушает сам демон. Демон один на пользователя, поэтому тест не запускается, если он уже
+ * работает.
+ */
+class DaemonTest final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void acceptsClientConnection();
+    void rejectsInvalidJob();
+    void stopsOnRequest();
+
+private:
+    std::unique_ptr<Daemon> daemon_;
+    std::unique_ptr<QRemoteObjectNode> node_;
+    std::unique_ptr<DaemonControllerReplica> replica_;
+};
+
+void DaemonTest::initTestCase()
+{
+    if (DaemonClient::isDaemonRunning()) {
+        QSKIP("QtAda daemon of this user is already running");
+    }
+}
+
+void DaemonTest::init()
+{
+    daemon_ = std::make_unique<Daemon>();
+    QVERIFY(daemon_->start());
+
+    node_ = std::make_unique<QRemoteObjectNode>();
+    QVERIFY(node_->connectToNode(QUrl(QStringLiteral("local:%1").arg(daemonSocketName()))));
+    replica_.reset(node_->acquire<DaemonControllerReplica>());
+    QVERIFY(replica_->waitForSource(CONNECT_TIMEOUT_MSEC));
+}
+
+void DaemonTest::cleanup()
+{
+    replica_.reset();
+    node_.reset();
+    daemon_.reset();
+}
+
+void DaemonTest::acceptsClientConnection()
+{
+    QCOMPARE(replica_->state(), QRemoteObjectReplica::Valid);
+    QVERIFY(DaemonClient::isDaemonRunning());
+
+    // Второй демон того же пользователя не запускается
+    Daemon other;
+    QVERIFY(!other.start());
+}
+
+void DaemonTest::rejectsInvalidJob()
+{
+    QSignalSpy finished(replica_.get(), &DaemonControllerReplica::jobFinished);
+    replica_->sendJob(JOB_ID, QByteArray());
+
+    QTRY_COMPARE(finished.count(), 1);
+    QCOMPARE(finished.front().at(0).toString(), QString(JOB_ID));
+    QCOMPARE(finished.front().at(1).toInt(), 1);
+}
+
+void DaemonTest::stopsOnRequest()
+{
+    QSignalSpy finished(daemon_.get(), &Daemon::daemonFinished);
+    replica_->sendStopRequest();
+    QTRY_COMPARE(finished.count(), 1);
+}
+
+QTEST_GUILESS_MAIN(DaemonTest)
+#include "tst_Daemon.moc"
@@ -0,0 +1,102 @@
+#include <QtTest>
+#include <QObject>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QTemporaryFile>
+
+#include <config.h>
+
+#include "ElfReader.hpp"
+
+using namespace QtAda::launcher;
+
+/*
+ * Зависимости, найденные чтением ELF, сравниваются с библиотеками, которые ld.so на самом
+ * деле загрузил в процесс теста (по /proc/self/maps).
+ */
+class ElfReaderTest final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void resolvesLoadedLibraries();
+    void readsQtVersion();
+    void rejectsNonElfFile();
+
+private:
+    QVector<QByteArray> dependencies_;
+
+    static QSet<QString> loadedLibraries() noexcept;
+};
+
+QSet<QString> ElfReaderTest::loadedLibraries() noexcept
+{
+    QSet<QString> libraries;
+    QFile maps(QStringLiteral("/proc/self/maps"));
+    if (!maps.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return libraries;
+    }
+    for (const auto &line : maps.readAll().split('\n')) {
+        const auto pathStart = line.indexOf('/');
+        if (pathStart != -1) {
+            libraries.insert(
+                QFileInfo(QString::fromLocal8Bit(line.mid(pathStart))).canonicalFilePath());
+        }
+    }
+    return libraries;
+}
+
+void ElfReaderTest::initTestCase()
+{
+#ifndef HAVE_ELF
+    QSKIP("ELF headers are not available");
+#endif
+    const auto dependencies = elf::resolveDependencies(QCoreApplication::applicationFilePath(),
+                                                       qgetenv("LD_LIBRARY_PATH"));
+    QVERIFY(dependencies.has_value());
+    QVERIFY(!dependencies->isEmpty());
+    dependencies_ = *dependencies;
+}
+
+void ElfReaderTest::resolvesLoadedLibraries()
+{
+    const auto loaded = loadedLibraries();
+    QVERIFY(!loaded.isEmpty());
+    for (const auto &dependency : qAsConst(dependencies_)) {
+        const auto path = QFileInfo(QString::fromLocal8Bit(dependency)).canonicalFilePath();
+        QVERIFY2(loaded.contains(path), dependency.constData());
+    }
+}
+
+void ElfReaderTest::readsQtVersion()
+{
+    QString qtCorePath;
+    for (const auto &dependency : qAsConst(dependencies_)) {
+        if (QFileInfo(QString::fromLocal8Bit(dependency)).fileName().startsWith("libQt5Core.so")) {
+            qtCorePath = QString::fromLocal8Bit(dependency);
+            break;
+        }
+    }
+    QVERIFY(!qtCorePath.isEmpty());
+
+    const auto version = elf::qtVersionFromLibrary(qtCorePath);
+    QVERIFY(version.has_value());
+    const auto runtimeVersion = QString::fromLatin1(qVersion()).split('.');
+    QCOMPARE(version->first, runtimeVersion.at(0).toInt());
+    QCOMPARE(version->second, runtimeVersion.at(1).toInt());
+}
+
+void ElfReaderTest::rejectsNonElfFile()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write("#!/bin/sh\nexit 0\n");
+    file.close();
+
+    QVERIFY(!elf::resolveDependencies(file.fileName(), QByteArray()).has_value());
+    QVERIFY(!elf::resolveDependencies(file.fileName() + ".missing", QByteArray()).has_value());
+}
+
+QTEST_GUILESS_MAIN(ElfReaderTest)
+#include "tst_ElfReader.moc"
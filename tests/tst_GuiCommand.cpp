@@ -0,0 +1,152 @@
+#include <QtTest>
+#include <QObject>
+#include <QThread>
+#include <QEventLoop>
+#include <memory>
+#include <vector>
+
+#include "GuiCommand.hpp"
+
+using namespace QtAda::core;
+
+static constexpr int BLOCK_TIMEOUT_MSEC = 5000;
+static constexpr int SHORT_TIMEOUT_MSEC = 50;
+static constexpr int STUCK_STEP_MSEC = 300;
+
+/*
+ * Главный поток теста играет роль GUI-потока: он выполняет цикл событий, пока команды
+ * отправляются из отдельного потока, как из потока скрипта.
+ */
+class GuiCommandTest final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void runsStepsInOneBlock();
+    void startsFromGivenStep();
+    void stopsAfterPostedEvents();
+    void stopsAtUnavailableObject();
+    void stopsAtFailedStep();
+    void abortsBlockOnTimeout();
+
+private:
+    using Steps = std::vector<GuiCommandStep>;
+    using Results = std::vector<GuiCommandResult>;
+
+    // Номера выполненных команд (-1 - команда выполнялась не в GUI-потоке)
+    std::vector<int> executed_;
+
+    GuiCommandStep step(int index) noexcept;
+    Results runFromScriptThread(const Steps &steps, size_t first = 0,
+                                int timeoutMsec = BLOCK_TIMEOUT_MSEC) noexcept;
+};
+
+GuiCommandStep GuiCommandTest::step(int index) noexcept
+{
+    return { [] { return QCoreApplication::instance(); },
+             [this, index](QObject *, GuiCommandContext &) {
+                 const auto isGuiThread
+                     = QThread::currentThread() == QCoreApplication::instance()->thread();
+                 executed_.push_back(isGuiThread ? index : -1);
+             } };
+}
+
+GuiCommandTest::Results GuiCommandTest::runFromScriptThread(const Steps &steps, size_t first,
+                                                            int timeoutMsec) noexcept
+{
+    executed_.clear();
+    Results results;
+    std::unique_ptr<QThread> scriptThread(QThread::create([&] {
+        results = executeStepsInGuiThread(steps, first, timeoutMsec);
+    }));
+
+    // Сигнал завершения потока доставляется через цикл событий, поэтому он не теряется,
+    // даже если поток завершится раньше запуска цикла
+    QEventLoop loop;
+    connect(scriptThread.get(), &QThread::finished, &loop, &QEventLoop::quit);
+    scriptThread->start();
+    loop.exec();
+    scriptThread->wait();
+    return results;
+}
+
+void GuiCommandTest::runsStepsInOneBlock()
+{
+    const auto results = runFromScriptThread({ step(0), step(1), step(2) });
+    QCOMPARE(results.size(), size_t(3));
+    for (const auto &result : results) {
+        QVERIFY(result.status == GuiCommandResult::Status::Done);
+        QCOMPARE(result.object.data(), static_cast<QObject *>(QCoreApplication::instance()));
+    }
+    QCOMPARE(executed_, (std::vector<int>{ 0, 1, 2 }));
+}
+
+void GuiCommandTest::startsFromGivenStep()
+{
+    const auto results = runFromScriptThread({ step(0), step(1), step(2) }, 1);
+    QCOMPARE(results.size(), size_t(2));
+    QCOMPARE(executed_, (std::vector<int>{ 1, 2 }));
+}
+
+void GuiCommandTest::stopsAfterPostedEvents()
+{
+    auto posting = step(1);
+    posting.command = [this](QObject *object, GuiCommandContext &context) {
+        executed_.push_back(1);
+        context.postEvents(object, { new QEvent(QEvent::User) });
+    };
+
+    const auto results = runFromScriptThread({ step(0), posting, step(2) });
+    QCOMPARE(results.size(), size_t(2));
+    QVERIFY(results.back().status == GuiCommandResult::Status::Done);
+    QVERIFY(results.back().eventsPosted);
+    QCOMPARE(executed_, (std::vector<int>{ 0, 1 }));
+}
+
+void GuiCommandTest::stopsAtUnavailableObject()
+{
+    auto destroyed = step(1);
+    destroyed.getObject = []() -> QObject * { return nullptr; };
+
+    const auto results = runFromScriptThread({ step(0), destroyed, step(2) });
+    QCOMPARE(results.size(), size_t(2));
+    QVERIFY(results.back().status == GuiCommandResult::Status::Unavailable);
+    QCOMPARE(results.back().message, QStringLiteral("destruction"));
+    QCOMPARE(executed_, (std::vector<int>{ 0 }));
+}
+
+void GuiCommandTest::stopsAtFailedStep()
+{
+    auto failing = step(1);
+    failing.command = [](QObject *, GuiCommandContext &context) {
+        context.fail(QStringLiteral("failed"));
+    };
+
+    const auto results = runFromScriptThread({ failing, step(2) });
+    QCOMPARE(results.size(), size_t(1));
+    QVERIFY(results.front().status == GuiCommandResult::Status::Failed);
+    QCOMPARE(results.front().message, QStringLiteral("failed"));
+    QVERIFY(executed_.empty());
+}
+
+void GuiCommandTest::abortsBlockOnTimeout()
+{
+    auto stuck = step(1);
+    stuck.command = [this](QObject *, GuiCommandContext &) {
+        QThread::msleep(STUCK_STEP_MSEC);
+        executed_.push_back(1);
+    };
+
+    const auto results = runFromScriptThread({ step(0), stuck, step(2) }, 0, SHORT_TIMEOUT_MSEC);
+    QCOMPARE(results.size(), size_t(2));
+    QVERIFY(results.front().status == GuiCommandResult::Status::Done);
+    QVERIFY(results.back().status == GuiCommandResult::Status::TimedOut);
+    QCOMPARE(results.back().message, QStringLiteral("still running"));
+
+    // Зависшая команда завершается сама, а следующие за ней уже не начинаются
+    QTRY_COMPARE(executed_, (std::vector<int>{ 0, 1 }));
+    QTest::qWait(SHORT_TIMEOUT_MSEC);
+    QCOMPARE(executed_, (std::vector<int>{ 0, 1 }));
+}
+
+QTEST_GUILESS_MAIN(GuiCommandTest)
+#include "tst_GuiCommand.moc"
@@ -0,0 +1,111 @@
+#include <QtTest>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QFile>
+
+#include "LaunchOptions.hpp"
+
+using namespace QtAda;
+using namespace QtAda::launcher;
+
+static constexpr char APP_PATH[] = "qtada";
+
+/*
+ * Разбор аргументов командной строки и передача прогона демону: клиент сохраняет параметры
+ * прогона в JSON, а демон восстанавливает их и запускает приложение так же, как это сделал
+ * бы сам клиент.
+ */
+class LaunchOptionsTest final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void parsesDaemonCommands();
+    void rejectsDaemonCommandWithLaunch();
+    void roundTripsRunForDaemon();
+    void parsesMissedHeartbeatsLimit();
+
+private:
+    QTemporaryDir scriptsDir_;
+    QString scriptPath_;
+
+    static std::optional<int> parse(UserLaunchOptions &options, const QStringList &args) noexcept
+    {
+        return options.initFromArgs(APP_PATH, args);
+    }
+};
+
+void LaunchOptionsTest::initTestCase()
+{
+    QVERIFY(scriptsDir_.isValid());
+    scriptPath_ = scriptsDir_.filePath(QStringLiteral("script.js"));
+    QFile script(scriptPath_);
+    QVERIFY(script.open(QIODevice::WriteOnly | QIODevice::Text));
+    QVERIFY(script.write("// script\n") > 0);
+}
+
+void LaunchOptionsTest::parsesDaemonCommands()
+{
+    UserLaunchOptions start;
+    QVERIFY(!parse(start, { "--daemon" }).has_value());
+    QCOMPARE(start.daemonCommand, DaemonCommand::Start);
+
+    UserLaunchOptions stop;
+    QVERIFY(!parse(stop, { "--daemon-stop" }).has_value());
+    QCOMPARE(stop.daemonCommand, DaemonCommand::Stop);
+
+    UserLaunchOptions run;
+    QVERIFY(!parse(run, { "--no-daemon", "-R", scriptPath_, "app" }).has_value());
+    QCOMPARE(run.daemonCommand, DaemonCommand::None);
+    QCOMPARE(run.useDaemon, false);
+}
+
+void LaunchOptionsTest::rejectsDaemonCommandWithLaunch()
+{
+    UserLaunchOptions options;
+    QCOMPARE(parse(options, { "--daemon", "-R", scriptPath_, "app" }), std::make_optional(1));
+
+    UserLaunchOptions withApp;
+    QCOMPARE(parse(withApp, { "--daemon", "app" }), std::make_optional(1));
+}
+
+void LaunchOptionsTest::roundTripsRunForDaemon()
+{
+    UserLaunchOptions options;
+    QVERIFY(!parse(options, { "-w", scriptsDir_.path(), "-s", "--warm-pool", "2",
+                              "--verify-attempts", "7", "-R", scriptPath_, "app", "--arg" })
+                 .has_value());
+    options.environment = QStringList{ "DISPLAY=:1", "EMPTY=" };
+
+    const auto restored = UserLaunchOptions::fromJson(options.toJson());
+    QCOMPARE(restored.type, LaunchType::Run);
+    QCOMPARE(restored.launchAppArguments, (QStringList{ "app", "--arg" }));
+    QCOMPARE(restored.workingDirectory, scriptsDir_.path());
+    QCOMPARE(restored.timeoutValue, options.timeoutValue);
+    QCOMPARE(restored.showAppLogForTestRun, true);
+    QCOMPARE(restored.warmPoolSize, 2);
+    QCOMPARE(restored.environment, options.environment);
+    QCOMPARE(restored.runSettings.size(), 1);
+    QCOMPARE(restored.runSettings.constFirst().scriptPath, scriptPath_);
+    QCOMPARE(restored.runSettings.constFirst().verifyAttempts, 7);
+}
+
+void LaunchOptionsTest::parsesMissedHeartbeatsLimit()
+{
+    // По умолчанию проверка зависания отключена
+    UserLaunchOptions defaults;
+    QVERIFY(!parse(defaults, { "-R", scriptPath_, "app" }).has_value());
+    QCOMPARE(defaults.missedHeartbeatsLimit, 0);
+
+    UserLaunchOptions negative;
+    QCOMPARE(parse(negative, { "--hang-heartbeats", "-1", "-R", scriptPath_, "app" }),
+             std::make_optional(1));
+
+    UserLaunchOptions custom;
+    QVERIFY(!parse(custom, { "--hang-heartbeats", "20", "-R", scriptPath_, "app" }).has_value());
+    QCOMPARE(custom.missedHeartbeatsLimit, 20);
+    QCOMPARE(UserLaunchOptions::fromJson(custom.toJson()).missedHeartbeatsLimit, 20);
+}
+
+QTEST_GUILESS_MAIN(LaunchOptionsTest)
+#include "tst_LaunchOptions.moc"
@@ -0,0 +1,168 @@
+#include <QtTest>
+#include <QObject>
+#include <QRemoteObjectHost>
+#include <QRemoteObjectNode>
+#include <memory>
+#include <vector>
+
+#include <inprocess/rep_InprocessController_source.h>
+#include <inprocess/rep_InprocessController_replica.h>
+
+#include "InprocessController.hpp"
+#include "MessageBatcher.hpp"
+
+using namespace QtAda;
+using namespace QtAda::core;
+
+// Как в MessageBatcher.cpp
+static constexpr int MAX_BATCH_SIZE = 256;
+static constexpr int CONNECT_TIMEOUT_MSEC = 5000;
+
+namespace {
+// Записывает вызовы, пришедшие через QtRO, в порядке получения
+class RecordingController final : public InprocessControllerSimpleSource {
+public:
+    struct Batch final {
+        qint64 firstSequence = 0;
+        QList<int> types;
+        QStringList messages;
+    };
+    std::vector<Batch> batches;
+    int heartbeatsAfterBatches = -1;
+
+    void sendMessageBatch(qint64 firstSequence, const QList<int> &types,
+                          const QStringList &messages) override
+    {
+        batches.push_back({ firstSequence, types, messages });
+    }
+    void sendHeartbeat() override
+    {
+        heartbeatsAfterBatches = static_cast<int>(batches.size());
+    }
+    void sendNewFramedRootObjectData(const QVariantMap &, const QList<QVariantMap> &) override {}
+    void sendNewMetaPropertyData(const QList<QVariantMap> &) override {}
+    void sendSessionScriptFinished(int) override {}
+};
+} // namespace
+
+class MessageBatcherTest final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void batchesMessagesOfOneIteration();
+    void numbersMessagesAcrossBatches();
+    void sendsFullBatchImmediately();
+    void flushesBeforeDirectCalls();
+    void warnsAboutLostMessages();
+
+private:
+    int connectionIndex_ = 0;
+    std::unique_ptr<RecordingController> controller_;
+    std::unique_ptr<QRemoteObjectHost> host_;
+    std::unique_ptr<QRemoteObjectNode> node_;
+    std::shared_ptr<InprocessControllerReplica> replica_;
+    std::unique_ptr<MessageBatcher> batcher_;
+};
+
+void MessageBatcherTest::init()
+{
+    const QUrl url(QStringLiteral("local:qtada_tst_MessageBatcher_%1_%2")
+                       .arg(QCoreApplication::applicationPid())
+                       .arg(connectionIndex_++));
+    controller_ = std::make_unique<RecordingController>();
+    host_ = std::make_unique<QRemoteObjectHost>(url);
+    QVERIFY(host_->enableRemoting(controller_.get()));
+
+    node_ = std::make_unique<QRemoteObjectNode>();
+    QVERIFY(node_->connectToNode(url));
+    replica_.reset(node_->acquire<InprocessControllerReplica>());
+    QVERIFY(replica_->waitForSource(CONNECT_TIMEOUT_MSEC));
+    batcher_ = std::make_unique<MessageBatcher>(replica_);
+}
+
+void MessageBatcherTest::cleanup()
+{
+    batcher_.reset();
+    replica_.reset();
+    node_.reset();
+    host_.reset();
+    controller_.reset();
+}
+
+void MessageBatcherTest::batchesMessagesOfOneIteration()
+{
+    batcher_->addScriptRunLog(QStringLiteral("log"));
+    batcher_->addScriptRunWarning(QStringLiteral("warning"));
+    batcher_->addNewScriptLine(QStringLiteral("line"));
+    batcher_->addScriptRunError(QStringLiteral("error"));
+
+    QTRY_COMPARE(controller_->batches.size(), size_t(1));
+    const auto &batch = controller_->batches.front();
+    QCOMPARE(batch.firstSequence, qint64(0));
+    QCOMPARE(batch.types, (QList<int>{ static_cast<int>(InprocessMessageType::ScriptRunLog),
+                                       static_cast<int>(InprocessMessageType::ScriptRunWarning),
+                                       static_cast<int>(InprocessMessageType::NewScriptLine),
+                                       static_cast<int>(InprocessMessageType::ScriptRunError) }));
+    QCOMPARE(batch.messages, (QStringList{ "log", "warning", "line", "error" }));
+}
+
+void MessageBatcherTest::numbersMessagesAcrossBatches()
+{
+    batcher_->addScriptRunLog(QStringLiteral("first"));
+    batcher_->addScriptRunLog(QStringLiteral("second"));
+    QTRY_COMPARE(controller_->batches.size(), size_t(1));
+
+    batcher_->addScriptRunLog(QStringLiteral("third"));
+    QTRY_COMPARE(controller_->batches.size(), size_t(2));
+    QCOMPARE(controller_->batches.back().firstSequence, qint64(2));
+    QCOMPARE(controller_->batches.back().messages, QStringList{ "third" });
+}
+
+void MessageBatcherTest::sendsFullBatchImmediately()
+{
+    // События во время цикла не обрабатываются, поэтому первые MAX_BATCH_SIZE сообщений
+    // уходят без таймера, а по таймеру - только остаток
+    for (int i = 0; i <= MAX_BATCH_SIZE; ++i) {
+        batcher_->addScriptRunLog(QString::number(i));
+    }
+
+    QTRY_COMPARE(controller_->batches.size(), size_t(2));
+    QCOMPARE(controller_->batches.front().messages.size(), MAX_BATCH_SIZE);
+    QCOMPARE(controller_->batches.back().firstSequence, qint64(MAX_BATCH_SIZE));
+    QCOMPARE(controller_->batches.back().messages, QStringList{ QString::number(MAX_BATCH_SIZE) });
+}
+
+void MessageBatcherTest::flushesBeforeDirectCalls()
+{
+    batcher_->addScriptRunLog(QStringLiteral("before heartbeat"));
+    batcher_->flush();
+    replica_->sendHeartbeat();
+
+    QTRY_COMPARE(controller_->heartbeatsAfterBatches, 1);
+    QCOMPARE(controller_->batches.size(), size_t(1));
+}
+
+void MessageBatcherTest::warnsAboutLostMessages()
+{
+    // Номера проверяет сам InprocessController, поэтому QtRO здесь не нужен
+    inprocess::InprocessController controller;
+    QSignalSpy logs(&controller, &inprocess::InprocessController::scriptRunLog);
+    QSignalSpy warnings(&controller, &inprocess::InprocessController::scriptRunWarning);
+    const QList<int> types{ static_cast<int>(InprocessMessageType::ScriptRunLog) };
+
+    controller.sendMessageBatch(0, types, { "first" });
+    controller.sendMessageBatch(3, types, { "fourth" });
+    QCOMPARE(logs.count(), 2);
+    QCOMPARE(warnings.count(), 1);
+    QVERIFY(warnings.front().front().toString().startsWith(QStringLiteral("2 ")));
+
+    // Новый зонд нумерует сообщения с нуля
+    controller.sendMessageBatch(0, types, { "restarted" });
+    QCOMPARE(logs.count(), 3);
+    QCOMPARE(warnings.count(), 1);
+}
+
+QTEST_GUILESS_MAIN(MessageBatcherTest)
+#include "tst_MessageBatcher.moc"
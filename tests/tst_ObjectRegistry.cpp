@@ -0,0 +1,215 @@
+#include <QtTest>
+#include <QObject>
+#include <QThread>
+#include <QElapsedTimer>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "ObjectRegistry.hpp"
+
+using namespace QtAda::core;
+
+static constexpr int STRESS_DURATION_MSEC = 2000;
+static constexpr int STRESS_READERS_COUNT = 4;
+static constexpr int STRESS_CHILDREN_COUNT = 64;
+static constexpr int WAIT_TIMEOUT_MSEC = 5000;
+
+/*
+ * Поток, который в тестах регистрирует объекты, играет роль GUI-потока: запись в реестр
+ * всегда выполняется из одного потока, а чтение - из любых.
+ */
+class ObjectRegistryTest final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void findsRegisteredPaths();
+    void movesSubtreeWithObject();
+    void keepsDisplacedSubtreeReachable();
+    void wakesWaiterOnRegistration();
+    void wakesConcurrentWaiters();
+    void stressRegisterAndFind();
+};
+
+void ObjectRegistryTest::findsRegisteredPaths()
+{
+    ObjectRegistry registry;
+    QObject root;
+    QObject child(&root);
+    registry.registerObject(&root, nullptr, QStringLiteral("n=root_0"));
+    registry.registerObject(&child, &root, QStringLiteral("c=QObject_0"));
+
+    QCOMPARE(registry.find(QStringLiteral("n=root_0")), &root);
+    QCOMPARE(registry.find(QStringLiteral("n=root_0/c=QObject_0")), &child);
+    QCOMPARE(registry.find(QStringLiteral("n=root_0/c=QObject_1")), nullptr);
+    QCOMPARE(registry.find(QStringLiteral("c=QObject_0")), nullptr);
+    QCOMPARE(registry.objectCount(), size_t(2));
+
+    registry.unregisterObject(&child);
+    QCOMPARE(registry.find(QStringLiteral("n=root_0/c=QObject_0")), nullptr);
+    QCOMPARE(registry.objectCount(), size_t(1));
+}
+
+void ObjectRegistryTest::movesSubtreeWithObject()
+{
+    ObjectRegistry registry;
+    QObject root;
+    QObject parent(&root);
+    QObject child(&parent);
+    registry.registerObject(&root, nullptr, QStringLiteral("n=root_0"));
+    registry.registerObject(&parent, &root, QStringLiteral("n=old_0"));
+    registry.registerObject(&child, &parent, QStringLiteral("n=child_0"));
+
+    registry.registerObject(&parent, &root, QStringLiteral("n=new_0"));
+    QCOMPARE(registry.find(QStringLiteral("n=root_0/n=old_0/n=child_0")), nullptr);
+    QCOMPARE(registry.find(QStringLiteral("n=root_0/n=new_0/n=child_0")), &child);
+}
+
+void ObjectRegistryTest::keepsDisplacedSubtreeReachable()
+{
+    ObjectRegistry registry;
+    QObject first;
+    QObject firstChild(&first);
+    QObject second;
+    registry.registerObject(&first, nullptr, QStringLiteral("n=window_0"));
+    registry.registerObject(&firstChild, &first, QStringLiteral("n=child_0"));
+    registry.registerObject(&second, nullptr, QStringLiteral("n=window_0"));
+
+    // Путь занимает последний зарегистрированный объект, но потомки первого остаются доступны
+    QCOMPARE(registry.find(QStringLiteral("n=window_0")), &second);
+    QCOMPARE(registry.find(QStringLiteral("n=window_0/n=child_0")), &firstChild);
+
+    registry.unregisterObject(&second);
+    QCOMPARE(registry.find(QStringLiteral("n=window_0")), &first);
+}
+
+void ObjectRegistryTest::wakesWaiterOnRegistration()
+{
+    ObjectRegistry registry;
+    QObject root;
+    QObject child(&root);
+    registry.registerObject(&root, nullptr, QStringLiteral("n=root_0"));
+
+    std::unique_ptr<QThread> writer(QThread::create([&registry, &root, &child] {
+        QThread::msleep(50);
+        // Изменения других путей не должны мешать ожиданию
+        QObject unrelated;
+        registry.registerObject(&unrelated, nullptr, QStringLiteral("n=unrelated_0"));
+        registry.unregisterObject(&unrelated);
+        registry.registerObject(&child, &root, QStringLiteral("n=child_0"));
+    }));
+
+    QElapsedTimer timer;
+    timer.start();
+    writer->start();
+    auto *found = registry.waitFor(QStringLiteral("n=root_0/n=child_0"),
+                                   QDeadlineTimer(WAIT_TIMEOUT_MSEC));
+    const auto elapsed = timer.elapsed();
+    writer->wait();
+
+    QCOMPARE(found, &child);
+    QVERIFY2(elapsed < WAIT_TIMEOUT_MSEC / 2, qPrintable(QString::number(elapsed)));
+}
+
+void ObjectRegistryTest::wakesConcurrentWaiters()
+{
+    ObjectRegistry registry;
+    QObject first;
+    QObject second;
+
+    // Каждый поток ждет свой путь, и ожидание одного не должно мешать ожиданию другого
+    QObject *foundFirst = nullptr;
+    QObject *foundSecond = nullptr;
+    std::unique_ptr<QThread> firstWaiter(QThread::create([&registry, &foundFirst] {
+        foundFirst
+            = registry.waitFor(QStringLiteral("n=first_0"), QDeadlineTimer(WAIT_TIMEOUT_MSEC));
+    }));
+    std::unique_ptr<QThread> secondWaiter(QThread::create([&registry, &foundSecond] {
+        foundSecond
+            = registry.waitFor(QStringLiteral("n=second_0"), QDeadlineTimer(WAIT_TIMEOUT_MSEC));
+    }));
+
+    QElapsedTimer timer;
+    timer.start();
+    firstWaiter->start();
+    secondWaiter->start();
+    QThread::msleep(50);
+    registry.registerObject(&first, nullptr, QStringLiteral("n=first_0"));
+    registry.registerObject(&second, nullptr, QStringLiteral("n=second_0"));
+    firstWaiter->wait();
+    secondWaiter->wait();
+    const auto elapsed = timer.elapsed();
+
+    QCOMPARE(foundFirst, &first);
+    QCOMPARE(foundSecond, &second);
+    QVERIFY2(elapsed < WAIT_TIMEOUT_MSEC / 2, qPrintable(QString::number(elapsed)));
+}
+
+void ObjectRegistryTest::stressRegisterAndFind()
+{
+    ObjectRegistry registry;
+    QObject stableRoot;
+    QObject stableChild(&stableRoot);
+    registry.registerObject(&stableRoot, nullptr, QStringLiteral("n=stable_0"));
+    registry.registerObject(&stableChild, &stableRoot, QStringLiteral("n=child_0"));
+
+    std::atomic<bool> isRunning = true;
+    std::atomic<uint64_t> lookupCount = 0;
+    std::atomic<uint64_t> failureCount = 0;
+
+    // Пишущий поток постоянно создает и удаляет поддерево объектов, в том числе с путями,
+    // совпадающими с путями стабильных объектов
+    std::unique_ptr<QThread> writer(QThread::create([&] {
+        while (isRunning.load()) {
+            auto churnRoot = std::make_unique<QObject>();
+            registry.registerObject(churnRoot.get(), nullptr, QStringLiteral("n=churn_0"));
+            std::vector<QObject *> children;
+            for (int i = 0; i < STRESS_CHILDREN_COUNT; ++i) {
+                auto *child = new QObject(churnRoot.get());
+                registry.registerObject(child, churnRoot.get(),
+                                        QStringLiteral("c=QObject_%1").arg(i));
+                children.push_back(child);
+            }
+            registry.registerObject(children.front(), &stableRoot, QStringLiteral("n=child_1"));
+            for (auto *child : children) {
+                registry.unregisterObject(child);
+            }
+            registry.unregisterObject(churnRoot.get());
+        }
+    }));
+
+    std::vector<std::unique_ptr<QThread>> readers;
+    for (int i = 0; i < STRESS_READERS_COUNT; ++i) {
+        readers.emplace_back(QThread::create([&] {
+            while (isRunning.load()) {
+                if (registry.find(QStringLiteral("n=stable_0/n=child_0")) != &stableChild) {
+                    failureCount.fetch_add(1);
+                }
+                // Объекты удаляются пишущим потоком, поэтому результат только сравнивается
+                registry.find(QStringLiteral("n=churn_0/c=QObject_17"));
+                registry.waitFor(QStringLiteral("n=stable_0/n=child_1"), QDeadlineTimer(1));
+                lookupCount.fetch_add(3);
+            }
+        }));
+    }
+
+    writer->start();
+    for (auto &reader : readers) {
+        reader->start();
+    }
+    QThread::msleep(STRESS_DURATION_MSEC);
+    isRunning.store(false);
+    writer->wait();
+    for (auto &reader : readers) {
+        reader->wait();
+    }
+
+    QCOMPARE(failureCount.load(), uint64_t(0));
+    QVERIFY(lookupCount.load() > 0);
+    QCOMPARE(registry.objectCount(), size_t(2));
+    qInfo("%llu lookups during %d ms", static_cast<unsigned long long>(lookupCount.load()),
+          STRESS_DURATION_MSEC);
+}
+
+QTEST_GUILESS_MAIN(ObjectRegistryTest)
+#include "tst_ObjectRegistry.moc"
@@ -0,0 +1,131 @@
+#include <QtTest>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QFile>
+
+#include "Settings.hpp"
+
+using namespace QtAda;
+
+/*
+ * Настройки выполнения передаются зонду через JSON, поэтому все параметры, которые задает
+ * лаунчер, должны переживать toJson/fromJson без изменений.
+ */
+class RunSettingsTest final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void roundTripsSessionOptions();
+    void acceptsSessionOptionsOnlyInSession();
+    void rejectsUnreadableResetScript();
+    void roundTripsDeferredStart();
+    void acceptsDeferredStartWithoutScript();
+
+private:
+    QTemporaryDir scriptsDir_;
+    QString scriptPath_;
+    QString resetScriptPath_;
+
+    bool writeScript(const QString &path) const noexcept;
+    RunSettings validSettings() const noexcept;
+};
+
+bool RunSettingsTest::writeScript(const QString &path) const noexcept
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Text) && file.write("// script\n") > 0;
+}
+
+RunSettings RunSettingsTest::validSettings() const noexcept
+{
+    RunSettings settings;
+    settings.scriptPath = scriptPath_;
+    return settings;
+}
+
+void RunSettingsTest::initTestCase()
+{
+    QVERIFY(scriptsDir_.isValid());
+    scriptPath_ = scriptsDir_.filePath(QStringLiteral("script.js"));
+    resetScriptPath_ = scriptsDir_.filePath(QStringLiteral("reset.js"));
+    QVERIFY(writeScript(scriptPath_));
+    QVERIFY(writeScript(resetScriptPath_));
+    QVERIFY(validSettings().isValid());
+}
+
+void RunSettingsTest::roundTripsSessionOptions()
+{
+    auto settings = validSettings();
+    settings.session = true;
+    settings.sessionCloseWindows = true;
+    settings.sessionResetScript = resetScriptPath_;
+    settings.sessionLastScript = true;
+    QVERIFY(settings.isValid());
+
+    const auto restored = RunSettings::fromJson(settings.toJson());
+    QCOMPARE(restored.scriptPath, settings.scriptPath);
+    QCOMPARE(restored.session, true);
+    QCOMPARE(restored.sessionCloseWindows, true);
+    QCOMPARE(restored.sessionResetScript, resetScriptPath_);
+    QCOMPARE(restored.sessionLastScript, true);
+
+    // Настройки для GUI не содержат параметров, которые задаются только лаунчером
+    const auto guiRestored = RunSettings::fromJson(settings.toJson(true), true);
+    QCOMPARE(guiRestored.session, false);
+    QVERIFY(guiRestored.sessionResetScript.isEmpty());
+}
+
+void RunSettingsTest::acceptsSessionOptionsOnlyInSession()
+{
+    auto settings = validSettings();
+    settings.sessionCloseWindows = true;
+    QVERIFY(!settings.isValid());
+
+    settings.sessionCloseWindows = false;
+    settings.sessionResetScript = resetScriptPath_;
+    QVERIFY(!settings.isValid());
+
+    settings.session = true;
+    settings.sessionCloseWindows = true;
+    QVERIFY(settings.isValid());
+}
+
+void RunSettingsTest::rejectsUnreadableResetScript()
+{
+    auto settings = validSettings();
+    settings.session = true;
+    settings.sessionResetScript = scriptsDir_.filePath(QStringLiteral("missing.js"));
+
+    const auto errors = settings.findErrors();
+    QVERIFY(errors.has_value());
+    QCOMPARE(errors->size(), size_t(1));
+    QVERIFY(errors->front().contains(settings.sessionResetScript));
+
+    settings.sessionResetScript = scriptsDir_.path();
+    QVERIFY(!settings.isValid());
+}
+
+void RunSettingsTest::roundTripsDeferredStart()
+{
+    auto settings = validSettings();
+    settings.deferredStart = true;
+    QVERIFY(settings.isValid());
+    QCOMPARE(RunSettings::fromJson(settings.toJson()).deferredStart, true);
+    QCOMPARE(RunSettings::fromJson(settings.toJson(true), true).deferredStart, false);
+}
+
+void RunSettingsTest::acceptsDeferredStartWithoutScript()
+{
+    // Приложение из --warm-pool запускается до того, как известен скрипт
+    RunSettings settings;
+    QVERIFY(!settings.isValid());
+    settings.deferredStart = true;
+    QVERIFY(settings.isValid());
+
+    settings.session = true;
+    QVERIFY(!settings.isValid());
+}
+
+QTEST_GUILESS_MAIN(RunSettingsTest)
+#include "tst_RunSettings.moc"
@@ -0,0 +1,107 @@
+#include <QtTest>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QFile>
+#include <memory>
+#include <vector>
+
+#include "ScriptWriter.hpp"
+
+using namespace QtAda;
+using namespace QtAda::inprocess;
+
+static constexpr char OBJECT_PATH[] = "n=MainWindow_0/n=okButton_0";
+
+/*
+ * Скрипт записывается во временный файл рядом с итоговым и переносится на его место при
+ * завершении записи, поэтому результат проверяется по содержимому итогового файла.
+ */
+class ScriptWriterTest final : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void recordsSingleVerification();
+    void recordsSeveralVerificationsAtOnce();
+    void bindsObjectOfVerifyAll();
+
+private:
+    using Verifications = std::vector<std::pair<QString, QString>>;
+
+    std::unique_ptr<QTemporaryDir> scriptsDir_;
+
+    RecordSettings recordSettings() const noexcept;
+    QString recordedScript(const RecordSettings &settings,
+                           const Verifications &verifications) const noexcept;
+};
+
+void ScriptWriterTest::init()
+{
+    scriptsDir_ = std::make_unique<QTemporaryDir>();
+    QVERIFY(scriptsDir_->isValid());
+}
+
+RecordSettings ScriptWriterTest::recordSettings() const noexcept
+{
+    RecordSettings settings;
+    settings.scriptPath = scriptsDir_->filePath(QStringLiteral("script.js"));
+    return settings;
+}
+
+QString ScriptWriterTest::recordedScript(const RecordSettings &settings,
+                                        const Verifications &verifications) const noexcept
+{
+    {
+        ScriptWriter writer(settings);
+        writer.handleNewMetaPropertyVerification(OBJECT_PATH, verifications);
+        writer.finishScript(false);
+    }
+    QFile script(settings.scriptPath);
+    if (!script.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QString();
+    }
+    return QString::fromUtf8(script.readAll());
+}
+
+void ScriptWriterTest::recordsSingleVerification()
+{
+    const auto script = recordedScript(recordSettings(), { { "text", "OK" } });
+    QCOMPARE(script, QStringLiteral("function test() {\n"
+                                    "    QtAda.verify('%1', 'text', 'OK');\n"
+                                    "}\n"
+                                    "test();\n")
+                         .arg(OBJECT_PATH));
+}
+
+void ScriptWriterTest::recordsSeveralVerificationsAtOnce()
+{
+    const auto script
+        = recordedScript(recordSettings(), { { "text", "OK" }, { "enabled", "true" } });
+    QCOMPARE(script, QStringLiteral("function test() {\n"
+                                    "    QtAda.verifyAll('%1', {\n"
+                                    "        text: 'OK',\n"
+                                    "        enabled: 'true',\n"
+                                    "    });\n"
+                                    "}\n"
+                                    "test();\n")
+                         .arg(OBJECT_PATH));
+}
+
+void ScriptWriterTest::bindsObjectOfVerifyAll()
+{
+    auto settings = recordSettings();
+    settings.objectBindingMinimumCount = 1;
+    const auto script = recordedScript(settings, { { "text", "OK" }, { "enabled", "true" } });
+    QCOMPARE(script, QStringLiteral("function test() {\n"
+                                    "    const okButton = QtAda.find('%1');\n"
+                                    "    okButton.verifyAll({\n"
+                                    "        text: 'OK',\n"
+                                    "        enabled: 'true',\n"
+                                    "    });\n"
+                                    "}\n"
+                                    "test();\n")
+                         .arg(OBJECT_PATH));
+}
+
+QTEST_GUILESS_MAIN(ScriptWriterTest)
+#include "tst_ScriptWriter.moc"